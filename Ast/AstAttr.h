@@ -46,8 +46,10 @@ public:
     {}
 
     NAMED_LOC_PARAM(Key, key)
+    NAMED_TOKEN_PARAM(Key, key)
 
     SourceLoc keyLoc_;
+    Token keyTk_ { TK_INVALID };
 };
 
 class UAISO_API LinkageAttrAst final : public AttrAst
@@ -60,8 +62,10 @@ public:
     {}
 
     NAMED_LOC_PARAM(Key, key)
+    NAMED_TOKEN_PARAM(Key, key)
 
     SourceLoc keyLoc_;
+    Token keyTk_ { TK_INVALID };
 };
 
 
@@ -80,8 +84,10 @@ public:
     {}
 
     NAMED_LOC_PARAM(Key, key)
+    NAMED_TOKEN_PARAM(Key, key)
 
     SourceLoc keyLoc_;
+    Token keyTk_ { TK_INVALID };
 };
 
 /*!
@@ -97,8 +103,10 @@ public:
     {}
 
     NAMED_LOC_PARAM(Key, key)
+    NAMED_TOKEN_PARAM(Key, key)
 
     SourceLoc keyLoc_;
+    Token keyTk_ { TK_INVALID };
 };
 
 class UAISO_API AutoAttrAst : public AttrAst
@@ -111,8 +119,10 @@ public:
     {}
 
     NAMED_LOC_PARAM(Key, key)
+    NAMED_TOKEN_PARAM(Key, key)
 
     SourceLoc keyLoc_;
+    Token keyTk_ { TK_INVALID };
 };
 
 /*!
@@ -128,8 +138,10 @@ public:
     {}
 
     NAMED_LOC_PARAM(Key, key)
+    NAMED_TOKEN_PARAM(Key, key)
 
     SourceLoc keyLoc_;
+    Token keyTk_ { TK_INVALID };
 };
 
 class UAISO_API ParamDirAttrAst final : public AttrAst
@@ -142,8 +154,10 @@ public:
     {}
 
     NAMED_LOC_PARAM(Key, key)
+    NAMED_TOKEN_PARAM(Key, key)
 
     SourceLoc keyLoc_;
+    Token keyTk_ { TK_INVALID };
 };
 
 class UAISO_API EvalStrategyAttrAst final : public AttrAst
@@ -156,8 +170,10 @@ public:
     {}
 
     NAMED_LOC_PARAM(Key, key)
+    NAMED_TOKEN_PARAM(Key, key)
 
     SourceLoc keyLoc_;
+    Token keyTk_ { TK_INVALID };
 };
 
 /*!
@@ -30,6 +30,8 @@
 #include "Common/Assert.h"
 #include "Common/Config.h"
 #include "Parsing/SourceLoc.h"
+#include "Parsing/Token.h"
+#include "Semantic/SymbolFwd.h"
 #include <cstdint>
 #include <memory>
 #include <type_traits>
@@ -161,6 +163,33 @@ STMT_AST_MIXIN(MAKE_STMT_CASE)
         return checkKind(Kind::FirstStmtMarker__, Kind::LastStmtMarker__);
     }
 
+    /*!
+     * \brief setSpan
+     * \param first
+     * \param last
+     *
+     * Cache the locations of the node's first and last tokens, which are
+     * owned by the node itself or by one of its descendants.
+     *
+     * \sa AstLocator::cacheSpans
+     */
+    void setSpan(const SourceLoc* first, const SourceLoc* last)
+    {
+        firstLoc_ = first;
+        lastLoc_ = last;
+    }
+
+    /*!
+     * \brief hasSpan
+     * \return
+     *
+     * Return whether the node's span is cached.
+     */
+    bool hasSpan() const { return firstLoc_ != nullptr; }
+
+    const SourceLoc& spanFirstLoc() const { return *firstLoc_; }
+    const SourceLoc& spanLastLoc() const { return *lastLoc_; }
+
 protected:
     // Bits are assigned by specific AST nodes.
     struct BitFields
@@ -181,6 +210,23 @@ private:
         return bit_.kind > static_cast<KindType>(firstMarker)
                 && bit_.kind < static_cast<KindType>(lastMarker);
     }
+
+    const SourceLoc* firstLoc_ { nullptr };
+    const SourceLoc* lastLoc_ { nullptr };
+};
+
+/*!
+ * \brief The NameResolution enum
+ *
+ * Outcome of resolving a name use against the environment it appears in.
+ */
+enum class NameResolution : char
+{
+    Pending,     //! Not resolved (yet)
+    AsValue,     //! Resolved to a value declaration
+    AsType,      //! Resolved to a type declaration
+    AsNamespace, //! Resolved to a namespace (not annotated)
+    Unresolved   //! No declaration in scope
 };
 
 /*
@@ -217,6 +263,14 @@ AstT* newAst()
         return ast; \
     }
 
+#define CREATE_WITH_LOC_AND_TOKEN(LOC_MEMBER) \
+    static std::unique_ptr<Self> create(const SourceLoc& loc, Token tk) \
+    { \
+        auto ast = create(loc); \
+        ast->set##LOC_MEMBER##Tk(tk); \
+        return ast; \
+    }
+
 #define CREATE_WITH_AST(AST_MEMBER, AST_KIND) \
     static std::unique_ptr<Self> create(std::unique_ptr<AST_KIND##Ast> p) \
     { \
@@ -319,6 +373,32 @@ AstT* newAst()
     } \
     const SourceLoc& MEMBER##Loc() const { return MEMBER##Loc_; }
 
+/*
+ * The token at a location, for nodes whose meaning depends on it (keywords,
+ * literals), so that it needn't be looked up in the TokenMap.
+ */
+#define NAMED_TOKEN_PARAM(NAME, MEMBER) \
+    Self* set##NAME##Tk(Token param) \
+    { \
+        MEMBER##Tk_ = param; \
+        return this; \
+    } \
+    Token MEMBER##Tk() const { return MEMBER##Tk_; }
+
+/*
+ * The declaration a name use resolves to, annotated after binding so that
+ * it needn't be searched in the environment again.
+ */
+#define RESOLVED_DECL_PARAM \
+    Self* setDecl(NameResolution resolution, const Decl* decl) \
+    { \
+        resolution_ = resolution; \
+        decl_ = decl; \
+        return this; \
+    } \
+    NameResolution resolution() const { return resolution_; } \
+    const Decl* decl() const { return decl_; }
+
 #define NAMED_LOC_PARAM__BASE__(NAME) \
     virtual Self* set##NAME(const SourceLoc&) { return nullptr; } \
 
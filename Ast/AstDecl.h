@@ -36,6 +36,29 @@ class UAISO_API DeclAst : public Ast
 {
 public:
     using Ast::Ast;
+
+    /*!
+     * \brief setHash
+     * \param hash
+     * \param nameHash
+     *
+     * Set the structural hash of the declaration's subtree and the hash of
+     * its name's spelling (zero for an unnamed declaration).
+     *
+     * \sa AstHasher
+     */
+    void setHash(size_t hash, size_t nameHash)
+    {
+        hash_ = hash;
+        nameHash_ = nameHash;
+    }
+
+    size_t hash() const { return hash_; }
+    size_t nameHash() const { return nameHash_; }
+
+private:
+    size_t hash_ { 0 };
+    size_t nameHash_ { 0 };
 };
 
 class UAISO_API ErrorDeclAst final : public DeclAst
@@ -30,27 +30,17 @@
 
 using namespace uaiso;
 
-namespace {
-
-std::size_t level__ = 0;
-
-std::ostream* output__ = nullptr;
-
-std::ostream& level(std::ostream& os)
+std::string AstDumper::level() const
 {
-    std::string s(level__, ' ');
-    os << s;
-    return os;
+    return std::string(level_, ' ');
 }
 
-} // anonymous
-
 template <class AstT> AstDumper::VisitResult
 AstDumper::traverse(VisitResult (Base::*function)(AstT*), AstT* ast)
 {
-    ++level__;
+    ++level_;
     VisitResult result = ((this)->*(function))(ast);
-    --level__;
+    --level_;
     return result;
 }
 
@@ -86,7 +76,7 @@ void AstDumper::dumpProgram(ProgramAst* ast)
 
 void AstDumper::dumpProgram(ProgramAst* ast, std::ostream& os)
 {
-    output__ = &os;
+    output_ = &os;
 
     traverse(&Base::traverseDecl, ast->module_.get());
     traverse(&Base::traverseDecl, ast->package_.get());
@@ -95,904 +85,904 @@ void AstDumper::dumpProgram(ProgramAst* ast, std::ostream& os)
     std::for_each(ast->stmts_->begin(), ast->stmts_->end(),
                   [this] (StmtAst* stmt) { traverse(&Base::traverseStmt, stmt); });
 
-    *output__ << std::endl;
+    *output_ << std::endl;
 }
 
 AstDumper::VisitResult AstDumper::visitSimpleName(SimpleNameAst* ast)
 {
-    *output__ << level << "SimpleNameAst" << std::endl;
+    *output_ << level() << "SimpleNameAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitCompletionName(CompletionNameAst* ast)
 {
-    *output__ << level << "CompletionNameAst" << std::endl;
+    *output_ << level() << "CompletionNameAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitTemplateInstName(TemplateInstNameAst* ast)
 {
-    *output__ << level << "TemplateInstNameAst" << std::endl;
+    *output_ << level() << "TemplateInstNameAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitGenName(GenNameAst* ast)
 {
-    *output__ << level << "GenNameAst" << std::endl;
+    *output_ << level() << "GenNameAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitNestedName(NestedNameAst* ast)
 {
-    *output__ << level << "NestedNameAst" << std::endl;
+    *output_ << level() << "NestedNameAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitRecordSpec(RecordSpecAst* ast)
 {
-    *output__ << level << "RecordSpecAst" << std::endl;
+    *output_ << level() << "RecordSpecAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitArraySpec(ArraySpecAst* ast)
 {
-    *output__ << level << "ArraySpecAst" << std::endl;
+    *output_ << level() << "ArraySpecAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitBuiltinSpec(BuiltinSpecAst* ast)
 {
-    *output__ << level << "BuiltinSpecAst" << std::endl;
+    *output_ << level() << "BuiltinSpecAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitChanSpec(ChanSpecAst* ast)
 {
-    *output__ << level << "ChanSpecAst" << std::endl;
+    *output_ << level() << "ChanSpecAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitDecoratedSpec(DecoratedSpecAst* ast)
 {
-    *output__ << level << "DecoratedSpecAst" << std::endl;
+    *output_ << level() << "DecoratedSpecAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitOpaqueSpec(OpaqueSpecAst* ast)
 {
-    *output__ << level << "OpaqueSpecAst" << std::endl;
+    *output_ << level() << "OpaqueSpecAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitFuncSpec(FuncSpecAst* ast)
 {
-    *output__ << level << "FuncSpecAst" << std::endl;
+    *output_ << level() << "FuncSpecAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitNamedSpec(NamedSpecAst* ast)
 {
-    *output__ << level << "NamedSpecAst" << std::endl;
+    *output_ << level() << "NamedSpecAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitPtrSpec(PtrSpecAst* ast)
 {
-    *output__ << level << "PtrSpecAst" << std::endl;
+    *output_ << level() << "PtrSpecAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitTypeofSpec(TypeofSpecAst* ast)
 {
-    *output__ << level << "TypeofSpecAst" << std::endl;
+    *output_ << level() << "TypeofSpecAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitVoidSpec(VoidSpecAst* ast)
 {
-    *output__ << level << "VoidSpecAst" << std::endl;
+    *output_ << level() << "VoidSpecAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitAccessAttr(VisibilityAttrAst* ast)
 {
-    *output__ << level << "VisibilityAttrAst" << std::endl;
+    *output_ << level() << "VisibilityAttrAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitAnnotAttr(AnnotAttrAst* ast)
 {
-    *output__ << level << "AnnotAttrAst" << std::endl;
+    *output_ << level() << "AnnotAttrAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitCodegenAttr(CodegenAttrAst* ast)
 {
-    *output__ << level << "CodegenAttrAst" << std::endl;
+    *output_ << level() << "CodegenAttrAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitStorageClassAttr(StorageClassAttrAst* ast)
 {
-    *output__ << level << "StorageClassAttrAst" << std::endl;
+    *output_ << level() << "StorageClassAttrAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitTypeQualAttr(TypeQualAttrAst* ast)
 {
-    *output__ << level << "TypeQualAttrAst" << std::endl;
+    *output_ << level() << "TypeQualAttrAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitAliasDecl(AliasDeclAst* ast)
 {
-    *output__ << level << "AliasDeclAst" << std::endl;
+    *output_ << level() << "AliasDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitBaseDecl(BaseDeclAst* ast)
 {
-    *output__ << level << "BaseDeclAst" << std::endl;
+    *output_ << level() << "BaseDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitBlockDecl(BlockDeclAst* ast)
 {
-    *output__ << level << "BlockDeclAst" << std::endl;
+    *output_ << level() << "BlockDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitSelectiveDecl(SelectiveDeclAst* ast)
 {
-    *output__ << level << "SelectiveDeclAst" << std::endl;
+    *output_ << level() << "SelectiveDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitConstraintDecl(ConstraintDeclAst* ast)
 {
-    *output__ << level << "ConstraintDeclAst" << std::endl;
+    *output_ << level() << "ConstraintDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitVersionDecl(VersionDeclAst* ast)
 {
-    *output__ << level << "VersionDeclAst" << std::endl;
+    *output_ << level() << "VersionDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitEnumDecl(EnumDeclAst* ast)
 {
-    *output__ << level << "EnumDeclAst" << std::endl;
+    *output_ << level() << "EnumDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitErrorDecl(ErrorDeclAst* ast)
 {
-    *output__ << level << "ErrorDeclAst" << std::endl;
+    *output_ << level() << "ErrorDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitFuncDecl(FuncDeclAst* ast)
 {
-    *output__ << level << "FuncDeclAst" << std::endl;
+    *output_ << level() << "FuncDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitForwardDecl(ForwardDeclAst* ast)
 {
-    *output__ << level << "ForwardDeclAst" << std::endl;
+    *output_ << level() << "ForwardDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitVarDecl(VarDeclAst* ast)
 {
-    *output__ << level << "VarDeclAst" << std::endl;
+    *output_ << level() << "VarDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitImportDecl(ImportDeclAst* ast)
 {
-    *output__ << level << "ImportDeclAst" << std::endl;
+    *output_ << level() << "ImportDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitInvariantDecl(InvariantDeclAst* ast)
 {
-    *output__ << level << "InvariantDeclAst" << std::endl;
+    *output_ << level() << "InvariantDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitParamDecl(ParamDeclAst* ast)
 {
-    *output__ << level << "ParamDeclAst" << std::endl;
+    *output_ << level() << "ParamDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitParamClauseDecl(ParamClauseDeclAst* ast)
 {
-    *output__ << level << "ParamClauseDeclAst" << std::endl;
+    *output_ << level() << "ParamClauseDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitSectionDecl(SectionDeclAst* ast)
 {
-    *output__ << level << "SectionDeclAst";
+    *output_ << level() << "SectionDeclAst";
     if (ast->variety() == SectionVariety::Vars)
-        *output__ << "[Var]";
+        *output_ << "[Var]";
     else if (ast->variety() == SectionVariety::Types)
-        *output__ << "[Type]";
-    *output__ << std::endl;
+        *output_ << "[Type]";
+    *output_ << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitStaticAssertDecl(StaticAssertDeclAst* ast)
 {
-    *output__ << level << "StaticAssertDeclAst" << std::endl;
+    *output_ << level() << "StaticAssertDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitTemplateDecl(TemplateDeclAst* ast)
 {
-    *output__ << level << "TemplateDeclAst" << std::endl;
+    *output_ << level() << "TemplateDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitTemplateParamDecl(TemplateParamDeclAst* ast)
 {
-    *output__ << level << "TemplateParamDeclAst" << std::endl;
+    *output_ << level() << "TemplateParamDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitTemplateParamClauseDecl(TemplateParamClauseDeclAst* ast)
 {
-    *output__ << level << "TemplateParamClauseDeclAst" << std::endl;
+    *output_ << level() << "TemplateParamClauseDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitRecordDecl(RecordDeclAst* ast)
 {
-    *output__ << level << "RecordDeclAst" << std::endl;
+    *output_ << level() << "RecordDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitUnitTestDecl(UnitTestDeclAst* ast)
 {
-    *output__ << level << "UnitTestDeclAst" << std::endl;
+    *output_ << level() << "UnitTestDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitVarGroupDecl(VarGroupDeclAst* ast)
 {
-    *output__ << level << "VarGroupDeclAst" << std::endl;
+    *output_ << level() << "VarGroupDeclAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitAddExpr(AddExprAst* ast)
 {
-    *output__ << level << "AddExprAst" << std::endl;
+    *output_ << level() << "AddExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitAddrOfExpr(AddrOfExprAst* ast)
 {
-    *output__ << level << "AddrOfExprAst" << std::endl;
+    *output_ << level() << "AddrOfExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitRecordLitExpr(RecordLitExprAst* ast)
 {
-    *output__ << level << "RecordLitExprAst" << std::endl;
+    *output_ << level() << "RecordLitExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitRecordInitExpr(RecordInitExprAst* ast)
 {
-    *output__ << level << "RecordInitExprAst" << std::endl;
+    *output_ << level() << "RecordInitExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitArrayInitExpr(ArrayInitExprAst* ast)
 {
-    *output__ << level << "ArrayInitExprAst" << std::endl;
+    *output_ << level() << "ArrayInitExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitArrayLengthExpr(ArrayLengthExprAst* ast)
 {
-    *output__ << level << "ArrayLengthExprAst" << std::endl;
+    *output_ << level() << "ArrayLengthExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitArraySliceExpr(ArraySliceExprAst* ast)
 {
-    *output__ << level << "ArraySliceExprAst" << std::endl;
+    *output_ << level() << "ArraySliceExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitArrayIndexExpr(ArrayIndexExprAst* ast)
 {
-    *output__ << level << "ArrayIndexExprAst" << std::endl;
+    *output_ << level() << "ArrayIndexExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitAssertExpr(AssertExprAst* ast)
 {
-    *output__ << level << "AssertExprAst" << std::endl;
+    *output_ << level() << "AssertExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitAssignExpr(AssignExprAst* ast)
 {
-    *output__ << level << "AssignExprAst" << std::endl;
+    *output_ << level() << "AssignExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitBinExpr(BinExprAst* ast)
 {
-    *output__ << level << "BinExprAst" << std::endl;
+    *output_ << level() << "BinExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitBitAndExpr(BitAndExprAst* ast)
 {
-    *output__ << level << "BitAndExprAst" << std::endl;
+    *output_ << level() << "BitAndExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitBitCompExpr(BitCompExprAst* ast)
 {
-    *output__ << level << "BitCompExprAst" << std::endl;
+    *output_ << level() << "BitCompExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitBitOrExpr(BitOrExprAst* ast)
 {
-    *output__ << level << "BitOrExprAst" << std::endl;
+    *output_ << level() << "BitOrExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitBitXorExpr(BitXorExprAst* ast)
 {
-    *output__ << level << "BitXorExprAst" << std::endl;
+    *output_ << level() << "BitXorExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitBoolLitExpr(BoolLitExprAst* ast)
 {
-    *output__ << level << "BoolLitExprAst" << std::endl;
+    *output_ << level() << "BoolLitExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitCallExpr(CallExprAst* ast)
 {
-    *output__ << level << "CallExprAst" << std::endl;
+    *output_ << level() << "CallExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitCastExpr(CastExprAst* ast)
 {
-    *output__ << level << "CastExprAst" << std::endl;
+    *output_ << level() << "CastExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitCharLitExpr(CharLitExprAst* ast)
 {
-    *output__ << level << "CharLitExprAst" << std::endl;
+    *output_ << level() << "CharLitExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitCommaExpr(CommaExprAst* ast)
 {
-    *output__ << level << "CommaExprAst" << std::endl;
+    *output_ << level() << "CommaExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitConcatExpr(ConcatExprAst* ast)
 {
-    *output__ << level << "ConcatExprAst" << std::endl;
+    *output_ << level() << "ConcatExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitTerExpr(TerExprAst* ast)
 {
-    *output__ << level << "TerExprAst" << std::endl;
+    *output_ << level() << "TerExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitDelExpr(DelExprAst* ast)
 {
-    *output__ << level << "DelExprAst" << std::endl;
+    *output_ << level() << "DelExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitDesignateExpr(DesignateExprAst* ast)
 {
-    *output__ << level << "DesignateExprAst" << std::endl;
+    *output_ << level() << "DesignateExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitDivExpr(DivExprAst* ast)
 {
-    *output__ << level << "DivExprAst" << std::endl;
+    *output_ << level() << "DivExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitEqExpr(EqExprAst* ast)
 {
-    *output__ << level << "EqExprAst" << std::endl;
+    *output_ << level() << "EqExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitLambdaExpr(LambdaExprAst* ast)
 {
-    *output__ << level << "LambdaExprAst" << std::endl;
+    *output_ << level() << "LambdaExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitIdentExpr(IdentExprAst* ast)
 {
-    *output__ << level << "IdentExprAst" << std::endl;
+    *output_ << level() << "IdentExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitInExpr(InExprAst* ast)
 {
-    *output__ << level << "InExprAst" << std::endl;
+    *output_ << level() << "InExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitIncDecExpr(IncDecExprAst* ast)
 {
-    *output__ << level << "IncDecExprAst" << std::endl;
+    *output_ << level() << "IncDecExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitIsExpr(IsExprAst* ast)
 {
-    *output__ << level << "IsExprAst" << std::endl;
+    *output_ << level() << "IsExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitLogicAndExpr(LogicAndExprAst* ast)
 {
-    *output__ << level << "LogicAndExprAst" << std::endl;
+    *output_ << level() << "LogicAndExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitLogicNotExpr(LogicNotExprAst* ast)
 {
-    *output__ << level << "LogicNotExprAst" << std::endl;
+    *output_ << level() << "LogicNotExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitLogicOrExpr(LogicOrExprAst* ast)
 {
-    *output__ << level << "LogicOrExprAst" << std::endl;
+    *output_ << level() << "LogicOrExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitMakeExpr(MakeExprAst* ast)
 {
-    *output__ << level << "MakeExprAst" << std::endl;
+    *output_ << level() << "MakeExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitMemberAccessExpr(MemberAccessExprAst* ast)
 {
-    *output__ << level << "MemberAccessExprAst" << std::endl;
+    *output_ << level() << "MemberAccessExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitMinusExpr(MinusExprAst* ast)
 {
-    *output__ << level << "MinusExprAst" << std::endl;
+    *output_ << level() << "MinusExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitModExpr(ModExprAst* ast)
 {
-    *output__ << level << "ModExprAst" << std::endl;
+    *output_ << level() << "ModExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitMulExpr(MulExprAst* ast)
 {
-    *output__ << level << "MulExprAst" << std::endl;
+    *output_ << level() << "MulExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitNestedNewExpr(NestedNewExprAst* ast)
 {
-    *output__ << level << "NestedNewExprAst" << std::endl;
+    *output_ << level() << "NestedNewExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitNewExpr(NewExprAst* ast)
 {
-    *output__ << level << "NewExprAst" << std::endl;
+    *output_ << level() << "NewExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitNumLitExpr(NumLitExprAst* ast)
 {
-    *output__ << level << "NumLitExprAst" << std::endl;
+    *output_ << level() << "NumLitExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitPlusExpr(PlusExprAst* ast)
 {
-    *output__ << level << "PlusExprAst" << std::endl;
+    *output_ << level() << "PlusExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitPriExpr(PriExprAst* ast)
 {
-    *output__ << level << "PriExprAst" << std::endl;
+    *output_ << level() << "PriExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitPowerExpr(PowerExprAst* ast)
 {
-    *output__ << level << "PowerExprAst" << std::endl;
+    *output_ << level() << "PowerExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitPtrDerefExpr(PtrDerefExprAst* ast)
 {
-    *output__ << level << "PtrDerefExprAst" << std::endl;
+    *output_ << level() << "PtrDerefExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitNullLitExpr(NullLitExprAst* ast)
 {
-    *output__ << level << "NullLitExprAst" << std::endl;
+    *output_ << level() << "NullLitExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitChanExpr(ChanExprAst* ast)
 {
-    *output__ << level << "ChanExprAst" << std::endl;
+    *output_ << level() << "ChanExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitRelExpr(RelExprAst* ast)
 {
-    *output__ << level << "RelExprAst" << std::endl;
+    *output_ << level() << "RelExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitShiftExpr(ShiftExprAst* ast)
 {
-    *output__ << level << "ShiftExprAst" << std::endl;
+    *output_ << level() << "ShiftExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitStrLitExpr(StrLitExprAst* ast)
 {
-    *output__ << level << "StrLitExprAst" << std::endl;
+    *output_ << level() << "StrLitExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitSubExpr(SubExprAst* ast)
 {
-    *output__ << level << "SubExprAst" << std::endl;
+    *output_ << level() << "SubExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitSuperExpr(SuperExprAst* ast)
 {
-    *output__ << level << "SuperExprAst" << std::endl;
+    *output_ << level() << "SuperExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitThisExpr(ThisExprAst* ast)
 {
-    *output__ << level << "ThisExprAst" << std::endl;
+    *output_ << level() << "ThisExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitTypeAssertExpr(TypeAssertExprAst* ast)
 {
-    *output__ << level << "TypeAssertExprAst" << std::endl;
+    *output_ << level() << "TypeAssertExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitTypeidExpr(TypeidExprAst* ast)
 {
-    *output__ << level << "TypeidExprAst" << std::endl;
+    *output_ << level() << "TypeidExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitUnaryExpr(UnaryExprAst* ast)
 {
-    *output__ << level << "UnaryExprAst" << std::endl;
+    *output_ << level() << "UnaryExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitMixinExpr(MixinExprAst* ast)
 {
-    *output__ << level << "MixinExprAst" << std::endl;
+    *output_ << level() << "MixinExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitWrappedExpr(WrappedExprAst* ast)
 {
-    *output__ << level << "WrappedExprAst" << std::endl;
+    *output_ << level() << "WrappedExprAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitBlockStmt(BlockStmtAst* ast)
 {
-    *output__ << level << "BlockStmtAst" << std::endl;
+    *output_ << level() << "BlockStmtAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitBodyStmt(BodyStmtAst* ast)
 {
-    *output__ << level << "BodyStmtAst" << std::endl;
+    *output_ << level() << "BodyStmtAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitContractStmt(ContractStmtAst* ast)
 {
-    *output__ << level << "ContractStmtAst" << std::endl;
+    *output_ << level() << "ContractStmtAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitDeclStmt(DeclStmtAst* ast)
 {
-    *output__ << level << "DeclStmtAst" << std::endl;
+    *output_ << level() << "DeclStmtAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitExprStmt(ExprStmtAst* ast)
 {
-    *output__ << level << "ExprStmtAst" << std::endl;
+    *output_ << level() << "ExprStmtAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitInStmt(InStmtAst* ast)
 {
-    *output__ << level << "InStmtAst" << std::endl;
+    *output_ << level() << "InStmtAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitOutStmt(OutStmtAst* ast)
 {
-    *output__ << level << "OutStmtAst" << std::endl;
+    *output_ << level() << "OutStmtAst" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitEmptyStmt(EmptyStmtAst* ast)
 {
-    *output__ << level << "EmptyStmtAst" << std::endl;
+    *output_ << level() << "EmptyStmtAst" << std::endl;
     return Continue;
 }
 AstDumper::VisitResult AstDumper::visitInferredSpec(InferredSpecAst* ast)
 {
-    *output__ << level << "InferredSpec" << std::endl;
+    *output_ << level() << "InferredSpec" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitDeclAttr(DeclAttrAst* ast)
 {
-    *output__ << level << "DeclAttr" << std::endl;
+    *output_ << level() << "DeclAttr" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitAutoAttr(AutoAttrAst* ast)
 {
-    *output__ << level << "AutoAttr" << std::endl;
+    *output_ << level() << "AutoAttr" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitEvalStrategyAttr(EvalStrategyAttrAst* ast)
 {
-    *output__ << level << "EvalStrategyAttr" << std::endl;
+    *output_ << level() << "EvalStrategyAttr" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitLinkageAttr(LinkageAttrAst* ast)
 {
-    *output__ << level << "LinkageAttr" << std::endl;
+    *output_ << level() << "LinkageAttr" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitParamDirAttr(ParamDirAttrAst* ast)
 {
-    *output__ << level << "ParamDirAttr" << std::endl;
+    *output_ << level() << "ParamDirAttr" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitVisibilityAttr(VisibilityAttrAst* ast)
 {
-    *output__ << level << "VisibilityAttr" << std::endl;
+    *output_ << level() << "VisibilityAttr" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitEnumMemberDecl(EnumMemberDeclAst* ast)
 {
-    *output__ << level << "EnumMemberDecl" << std::endl;
+    *output_ << level() << "EnumMemberDecl" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitModuleDecl(ModuleDeclAst* ast)
 {
-    *output__ << level << "ModuleDecl" << std::endl;
+    *output_ << level() << "ModuleDecl" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitPackageDecl(PackageDeclAst* ast)
 {
-    *output__ << level << "PackageDecl" << std::endl;
+    *output_ << level() << "PackageDecl" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitParamGroupDecl(ParamGroupDeclAst* ast)
 {
-    *output__ << level << "ParamGroupDecl" << std::endl;
+    *output_ << level() << "ParamGroupDecl" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitTypeQueryExpr(TypeQueryExprAst* ast)
 {
-    *output__ << level << "TypeQueryExpr" << std::endl;
+    *output_ << level() << "TypeQueryExpr" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitSubrangeExpr(SubrangeExprAst* ast)
 {
-    *output__ << level << "SubrangeExpr" << std::endl;
+    *output_ << level() << "SubrangeExpr" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitUnpackExpr(UnpackExprAst* ast)
 {
-    *output__ << level << "UnpackExpr" << std::endl;
+    *output_ << level() << "UnpackExpr" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitAsyncStmt(AsyncStmtAst* ast)
 {
-    *output__ << level << "AsyncStmt" << std::endl;
+    *output_ << level() << "AsyncStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitBreakStmt(BreakStmtAst* ast)
 {
-    *output__ << level << "BreakStmt" << std::endl;
+    *output_ << level() << "BreakStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitCaseClauseStmt(CaseClauseStmtAst* ast)
 {
-    *output__ << level << "CaseClauseStmt" << std::endl;
+    *output_ << level() << "CaseClauseStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitCatchClauseStmt(CatchClauseStmtAst* ast)
 {
-    *output__ << level << "CatchClauseStmt" << std::endl;
+    *output_ << level() << "CatchClauseStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitSelectiveStmt(SelectiveStmtAst* ast)
 {
-    *output__ << level << "SelectiveStmt" << std::endl;
+    *output_ << level() << "SelectiveStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitContinueStmt(ContinueStmtAst* ast)
 {
-    *output__ << level << "ContinueStmt" << std::endl;
+    *output_ << level() << "ContinueStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitDefaultClauseStmt(DefaultClauseStmtAst* ast)
 {
-    *output__ << level << "DefaultClauseStmt" << std::endl;
+    *output_ << level() << "DefaultClauseStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitDeferredStmt(DeferredStmtAst* ast)
 {
-    *output__ << level << "DeferredStmt" << std::endl;
+    *output_ << level() << "DeferredStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitDoWhileStmt(DoWhileStmtAst* ast)
 {
-    *output__ << level << "DoWhileStmt" << std::endl;
+    *output_ << level() << "DoWhileStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitErrorStmt(ErrorStmtAst* ast)
 {
-    *output__ << level << "ErrorStmt" << std::endl;
+    *output_ << level() << "ErrorStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitFallthroughStmt(FallthroughStmtAst* ast)
 {
-    *output__ << level << "FallthroughStmt" << std::endl;
+    *output_ << level() << "FallthroughStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitFinallyClauseStmt(FinallyClauseStmtAst* ast)
 {
-    *output__ << level << "FinallyClauseStmt" << std::endl;
+    *output_ << level() << "FinallyClauseStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitForStmt(ForStmtAst* ast)
 {
-    *output__ << level << "ForStmt" << std::endl;
+    *output_ << level() << "ForStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitForeachStmt(ForeachStmtAst* ast)
 {
-    *output__ << level << "ForeachStmt" << std::endl;
+    *output_ << level() << "ForeachStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitGotoStmt(GotoStmtAst* ast)
 {
-    *output__ << level << "GotoStmt" << std::endl;
+    *output_ << level() << "GotoStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitIfStmt(IfStmtAst* ast)
 {
-    *output__ << level << "IfStmt" << std::endl;
+    *output_ << level() << "IfStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitLabeledStmt(LabeledStmtAst* ast)
 {
-    *output__ << level << "LabeledStmt" << std::endl;
+    *output_ << level() << "LabeledStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitReturnStmt(ReturnStmtAst* ast)
 {
-    *output__ << level << "ReturnStmt" << std::endl;
+    *output_ << level() << "ReturnStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitSyncedStmt(SyncedStmtAst* ast)
 {
-    *output__ << level << "SyncedStmt" << std::endl;
+    *output_ << level() << "SyncedStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitSwitchStmt(SwitchStmtAst* ast)
 {
-    *output__ << level << "SwitchStmt" << std::endl;
+    *output_ << level() << "SwitchStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitThrowStmt(ThrowStmtAst* ast)
 {
-    *output__ << level << "ThrowStmt" << std::endl;
+    *output_ << level() << "ThrowStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitTryStmt(TryStmtAst* ast)
 {
-    *output__ << level << "TryStmt" << std::endl;
+    *output_ << level() << "TryStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitWhileStmt(WhileStmtAst* ast)
 {
-    *output__ << level << "WhileStmt" << std::endl;
+    *output_ << level() << "WhileStmt" << std::endl;
     return Continue;
 }
 
 AstDumper::VisitResult AstDumper::visitWithStmt(WithStmtAst* ast)
 {
-    *output__ << level << "WithStmt" << std::endl;
+    *output_ << level() << "WithStmt" << std::endl;
     return Continue;
 }
 
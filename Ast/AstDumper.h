@@ -213,6 +213,11 @@ private:
     VisitResult visitTryStmt(TryStmtAst* ast);
     VisitResult visitWhileStmt(WhileStmtAst* ast);
     VisitResult visitWithStmt(WithStmtAst* ast);
+
+    std::string level() const;
+
+    std::size_t level_ { 0 };
+    std::ostream* output_ { nullptr };
 };
 
 } // namespace uaiso
@@ -22,9 +22,52 @@
 /*--------------------------*/
 
 #include "Ast/Ast.h"
+#include <type_traits>
+#include <vector>
 
 using namespace uaiso;
 
+namespace {
+
+bool isBinExpr(const ExprAst* ast)
+{
+    if (!ast)
+        return false;
+
+    switch (ast->kind()) {
+#define MAKE_CASE(AST_NODE, UNUSED) \
+    case Ast::Kind::AST_NODE##Expr: \
+        return std::is_base_of<BinExprAst, AST_NODE##ExprAst>::value;
+    EXPR_AST_MIXIN(MAKE_CASE)
+#undef MAKE_CASE
+    default:
+        return false;
+    }
+}
+
+} // anonymous
+
+BinExprAst::~BinExprAst()
+{
+    // Chains of binary expressions (a + b + c ...) may be very long, so
+    // they're not destroyed recursively.
+    if (!isBinExpr(expr1_.get()) && !isBinExpr(expr2_.get()))
+        return;
+
+    std::vector<std::unique_ptr<ExprAst>> pending;
+    pending.push_back(std::move(expr1_));
+    pending.push_back(std::move(expr2_));
+    while (!pending.empty()) {
+        std::unique_ptr<ExprAst> expr = std::move(pending.back());
+        pending.pop_back();
+        if (isBinExpr(expr.get())) {
+            BinExprAst* binExpr = static_cast<BinExprAst*>(expr.get());
+            pending.push_back(std::move(binExpr->expr1_));
+            pending.push_back(std::move(binExpr->expr2_));
+        }
+    }
+}
+
 IdentExprAst* IdentExprAst::setName(NameAstList *names)
 {
     name_.reset(newAst<NestedNameAst>()->setNamesSR(names));
@@ -51,14 +51,17 @@ class UAISO_API CharLitExprAst final : public PriExprAst
 public:
     AST_CLASS(CharLit, Expr)
     CREATE_WITH_LOC(Lit)
+    CREATE_WITH_LOC_AND_TOKEN(Lit)
 
     CharLitExprAst()
         : PriExprAst(Kind::CharLitExpr)
     {}
 
     NAMED_LOC_PARAM(Lit, lit)
+    NAMED_TOKEN_PARAM(Lit, lit)
 
     SourceLoc litLoc_;
+    Token litTk_ { TK_INVALID };
 };
 
 class UAISO_API StrLitExprAst final : public PriExprAst
@@ -66,14 +69,17 @@ class UAISO_API StrLitExprAst final : public PriExprAst
 public:
     AST_CLASS(StrLit, Expr)
     CREATE_WITH_LOC(Lit)
+    CREATE_WITH_LOC_AND_TOKEN(Lit)
 
     StrLitExprAst()
         : PriExprAst(Kind::StrLitExpr)
     {}
 
     NAMED_LOC_PARAM(Lit, lit)
+    NAMED_TOKEN_PARAM(Lit, lit)
 
     SourceLoc litLoc_;
+    Token litTk_ { TK_INVALID };
 };
 
 class UAISO_API NumLitExprAst final : public PriExprAst
@@ -81,6 +87,7 @@ class UAISO_API NumLitExprAst final : public PriExprAst
 public:
     AST_CLASS(NumLit, Expr)
     CREATE_WITH_LOC(Lit)
+    CREATE_WITH_LOC_AND_TOKEN(Lit)
     VARIETY_AST(NumLitVariety)
 
     static std::unique_ptr<Self> create(const SourceLoc& loc, NumLitVariety v)
@@ -90,6 +97,13 @@ public:
         return ast;
     }
 
+    static std::unique_ptr<Self> create(const SourceLoc& loc, Token tk, NumLitVariety v)
+    {
+        auto ast = create(loc, tk);
+        ast->setVariety(v);
+        return ast;
+    }
+
     NumLitExprAst()
         : PriExprAst(Kind::NumLitExpr)
     {
@@ -97,8 +111,10 @@ public:
     }
 
     NAMED_LOC_PARAM(Lit, lit)
+    NAMED_TOKEN_PARAM(Lit, lit)
 
     SourceLoc litLoc_;
+    Token litTk_ { TK_INVALID };
 };
 
 class UAISO_API BoolLitExprAst final : public PriExprAst
@@ -106,14 +122,17 @@ class UAISO_API BoolLitExprAst final : public PriExprAst
 public:
     AST_CLASS(BoolLit, Expr)
     CREATE_WITH_LOC(Lit)
+    CREATE_WITH_LOC_AND_TOKEN(Lit)
 
     BoolLitExprAst()
         : PriExprAst(Kind::BoolLitExpr)
     {}
 
     NAMED_LOC_PARAM(Lit, lit)
+    NAMED_TOKEN_PARAM(Lit, lit)
 
     SourceLoc litLoc_;
+    Token litTk_ { TK_INVALID };
 };
 
 class UAISO_API NullLitExprAst final : public PriExprAst
@@ -121,14 +140,17 @@ class UAISO_API NullLitExprAst final : public PriExprAst
 public:
     AST_CLASS(NullLit, Expr)
     CREATE_WITH_LOC(Lit)
+    CREATE_WITH_LOC_AND_TOKEN(Lit)
 
     NullLitExprAst()
         : PriExprAst(Kind::NullLitExpr)
     {}
 
     NAMED_LOC_PARAM(Lit, lit)
+    NAMED_TOKEN_PARAM(Lit, lit)
 
     SourceLoc litLoc_;
+    Token litTk_ { TK_INVALID };
 };
 
 class UAISO_API LambdaExprAst final : public PriExprAst
@@ -231,7 +253,11 @@ public:
 
     NAMED_AST_PARAM(Name, name, NameAst)
 
+    RESOLVED_DECL_PARAM
+
     std::unique_ptr<NameAst> name_;
+    NameResolution resolution_ { NameResolution::Pending };
+    const Decl* decl_ { nullptr };
 };
 
 /*!
@@ -380,6 +406,7 @@ class UAISO_API BinExprAst : public ExprAst
 public:
     AST_CLASS(Bin, Expr)
     using ExprAst::ExprAst;
+    ~BinExprAst() override;
 
     NAMED_AST_PARAM(Expr1, expr1, ExprAst)
     NAMED_LOC_PARAM(Opr, opr)
@@ -0,0 +1,434 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Ast/AstHasher.h"
+#include "Ast/Ast.h"
+#include "Ast/AstVisitor.h"
+#include "Common/Assert.h"
+#include "Parsing/Lexeme.h"
+#include "Parsing/LexemeMap.h"
+#include <functional>
+#include <map>
+#include <tuple>
+
+using namespace uaiso;
+
+namespace {
+
+/*!
+ * \brief The HashVisitor class
+ *
+ * Hash a subtree in preorder. Nested declarations and the members of
+ * records are hashed on their own, and only their hashes are mixed in.
+ */
+class HashVisitor final : public AstVisitor<HashVisitor>
+{
+public:
+    using Base = AstVisitor<HashVisitor>;
+
+    HashVisitor(const AstHasher* hasher,
+                const LexemeMap* lexs,
+                const std::string& fileName,
+                Ast* root,
+                bool withLocs)
+        : hasher_(hasher)
+        , lexs_(lexs)
+        , fileName_(fileName)
+        , root_(root)
+        , withLocs_(withLocs)
+    {}
+
+    size_t hash(Ast* ast)
+    {
+        if (ast->isName())
+            traverseName(static_cast<NameAst*>(ast));
+        else if (ast->isExpr())
+            traverseExpr(static_cast<ExprAst*>(ast));
+        else if (ast->isDecl())
+            traverseDecl(static_cast<DeclAst*>(ast));
+        else if (ast->isStmt())
+            traverseStmt(static_cast<StmtAst*>(ast));
+        else if (ast->isSpec())
+            traverseSpec(static_cast<SpecAst*>(ast));
+        else if (ast->isAttr())
+            traverseAttr(static_cast<AttrAst*>(ast));
+
+        // Zero stands for a hash that's not computed.
+        return hash_ ? hash_ : 1;
+    }
+
+    void enterList() { mix(listMarker); }
+    void leaveList() { mix(~listMarker); }
+
+    VisitResult visitName(NameAst* ast) { return mixKind(ast); }
+    VisitResult visitSpec(SpecAst* ast) { return mixKind(ast); }
+    VisitResult visitAttr(AttrAst* ast) { return mixKind(ast); }
+    VisitResult visitExpr(ExprAst* ast) { return mixKind(ast); }
+    VisitResult visitStmt(StmtAst* ast) { return mixKind(ast); }
+
+    VisitResult visitDecl(DeclAst* ast)
+    {
+        if (ast == root_)
+            return mixKind(ast);
+        mix(hasher_->hashDecl(ast));
+        return Skip;
+    }
+
+    VisitResult traverseRecordSpec(RecordSpecAst* ast)
+    {
+        if (recursivelyVisitRecordSpec(ast) != Continue)
+            return Continue;
+        traverseDecl(ast->templ_.get());
+        if (ast->bases_)
+            traverseList<DeclAst>(ast->bases_.get(), &HashVisitor::traverseDecl);
+
+        enterList();
+        if (ast->decls_) {
+            for (auto decl : *ast->decls_)
+                mix(hasher_->hashDecl(decl));
+        }
+        if (ast->proto_) {
+            if (ast->proto_->kind() == Ast::Kind::BlockStmt) {
+                auto block = BlockStmt_Cast(ast->proto_.get());
+                if (block->stmts_) {
+                    for (auto stmt : *block->stmts_)
+                        mix(hasher_->hashStmt(stmt));
+                }
+            } else {
+                mix(hasher_->hashStmt(ast->proto_.get()));
+            }
+        }
+        leaveList();
+        return Continue;
+    }
+
+    VisitResult visitSimpleName(SimpleNameAst* ast)
+    {
+        return mixLexeme<Ident>(ast->nameLoc_);
+    }
+
+    VisitResult visitNumLitExpr(NumLitExprAst* ast)
+    {
+        mix(ast->litTk_);
+        return mixLexeme<NumLit>(ast->litLoc_);
+    }
+
+    VisitResult visitStrLitExpr(StrLitExprAst* ast)
+    {
+        mix(ast->litTk_);
+        return mixLexeme<StrLit>(ast->litLoc_);
+    }
+
+    VisitResult visitCharLitExpr(CharLitExprAst* ast) { return mixToken(ast->litTk_, ast->litLoc_); }
+    VisitResult visitBoolLitExpr(BoolLitExprAst* ast) { return mixToken(ast->litTk_, ast->litLoc_); }
+    VisitResult visitNullLitExpr(NullLitExprAst* ast) { return mixToken(ast->litTk_, ast->litLoc_); }
+    VisitResult visitBuiltinSpec(BuiltinSpecAst* ast) { return mixToken(ast->keyTk_, ast->keyLoc_); }
+    VisitResult visitStorageClassAttr(StorageClassAttrAst* ast) { return mixToken(ast->keyTk_, ast->keyLoc_); }
+    VisitResult visitLinkageAttr(LinkageAttrAst* ast) { return mixToken(ast->keyTk_, ast->keyLoc_); }
+    VisitResult visitVisibilityAttr(VisibilityAttrAst* ast) { return mixToken(ast->keyTk_, ast->keyLoc_); }
+    VisitResult visitDeclAttr(DeclAttrAst* ast) { return mixToken(ast->keyTk_, ast->keyLoc_); }
+    VisitResult visitAutoAttr(AutoAttrAst* ast) { return mixToken(ast->keyTk_, ast->keyLoc_); }
+    VisitResult visitTypeQualAttr(TypeQualAttrAst* ast) { return mixToken(ast->keyTk_, ast->keyLoc_); }
+    VisitResult visitParamDirAttr(ParamDirAttrAst* ast) { return mixToken(ast->keyTk_, ast->keyLoc_); }
+    VisitResult visitEvalStrategyAttr(EvalStrategyAttrAst* ast) { return mixToken(ast->keyTk_, ast->keyLoc_); }
+
+private:
+    static const size_t listMarker = 0x5bd1e995;
+
+    void mix(size_t value)
+    {
+        hash_ ^= value + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
+    }
+
+    VisitResult mixKind(Ast* ast)
+    {
+        mix(static_cast<size_t>(ast->kind()));
+        return Continue;
+    }
+
+    /*!
+     * Locations are relative to the first one in the subtree, so that a
+     * subtree hashes the same wherever it is.
+     */
+    void mixLoc(const SourceLoc& loc)
+    {
+        if (!withLocs_)
+            return;
+        if (!hasBase_) {
+            base_ = loc.lineCol();
+            hasBase_ = true;
+        }
+        mix(loc.line_ - base_.line_);
+        mix(loc.line_ == base_.line_ ? loc.col_ - base_.col_ : loc.col_);
+    }
+
+    VisitResult mixToken(Token tk, const SourceLoc& loc)
+    {
+        mix(tk);
+        mixLoc(loc);
+        return Continue;
+    }
+
+    template <class LexemeT>
+    VisitResult mixLexeme(const SourceLoc& loc)
+    {
+        if (lexs_) {
+            auto lexeme = lexs_->findAt<LexemeT>(fileName_, loc.lineCol());
+            if (lexeme)
+                mix(std::hash<std::string>()(lexeme->str()));
+        }
+        mixLoc(loc);
+        return Continue;
+    }
+
+    const AstHasher* hasher_;
+    const LexemeMap* lexs_;
+    const std::string& fileName_;
+    Ast* root_;
+    bool withLocs_;
+    bool hasBase_ { false };
+    LineCol base_;
+    size_t hash_ { 0 };
+};
+
+/*!
+ * \brief declName
+ *
+ * Return what names the declaration, if anything.
+ */
+Ast* declName(DeclAst* ast)
+{
+    switch (ast->kind()) {
+    case Ast::Kind::AliasDecl:
+        return AliasDecl_Cast(ast)->name_.get();
+    case Ast::Kind::ChainedFuncDecl:
+    case Ast::Kind::FuncDecl:
+        return FuncDecl_Cast(ast)->name_.get();
+    case Ast::Kind::EnumDecl:
+        return EnumDecl_Cast(ast)->name_.get();
+    case Ast::Kind::EnumMemberDecl:
+        return EnumMemberDecl_Cast(ast)->name_.get();
+    case Ast::Kind::ForwardDecl:
+        return ForwardDecl_Cast(ast)->name_.get();
+    case Ast::Kind::ImportDecl:
+        if (ImportDecl_Cast(ast)->localName_)
+            return ImportDecl_Cast(ast)->localName_.get();
+        return ImportDecl_Cast(ast)->target_.get();
+    case Ast::Kind::ModuleDecl:
+        return ModuleDecl_Cast(ast)->name_.get();
+    case Ast::Kind::PackageDecl:
+        return PackageDecl_Cast(ast)->name_.get();
+    case Ast::Kind::RecordDecl:
+        return RecordDecl_Cast(ast)->name_.get();
+    case Ast::Kind::VarDecl:
+        return VarDecl_Cast(ast)->name_.get();
+    case Ast::Kind::VarGroupDecl:
+        if (VarGroupDecl_Cast(ast)->decls_)
+            return declName(VarGroupDecl_Cast(ast)->decls_->front());
+        return nullptr;
+    default:
+        return nullptr;
+    }
+}
+
+} // anonymous
+
+AstHasher::AstHasher(const LexemeMap* lexs, const std::string& fullFileName)
+    : lexs_(lexs)
+    , fileName_(fullFileName)
+{}
+
+void AstHasher::hashProgram(ProgramAst* progAst) const
+{
+    UAISO_ASSERT(progAst, return);
+
+    if (progAst->module_)
+        hashDecl(progAst->module_.get());
+    if (progAst->package_)
+        hashDecl(progAst->package_.get());
+    if (progAst->decls_) {
+        for (auto decl : *progAst->decls_)
+            hashDecl(decl);
+    }
+    if (progAst->stmts_) {
+        for (auto stmt : *progAst->stmts_)
+            hashStmt(stmt);
+    }
+}
+
+size_t AstHasher::hashDecl(DeclAst* ast) const
+{
+    UAISO_ASSERT(ast, return 0);
+
+    if (ast->hash())
+        return ast->hash();
+
+    HashVisitor vis(this, lexs_, fileName_, ast, true);
+    size_t hash = vis.hash(ast);
+    size_t nameHash = 0;
+    if (Ast* name = declName(ast))
+        nameHash = HashVisitor(this, lexs_, fileName_, name, false).hash(name);
+    ast->setHash(hash, nameHash);
+    return hash;
+}
+
+size_t AstHasher::hashStmt(StmtAst* ast) const
+{
+    UAISO_ASSERT(ast, return 0);
+
+    if (ast->hash())
+        return ast->hash();
+
+    HashVisitor vis(this, lexs_, fileName_, ast, true);
+    ast->setHash(vis.hash(ast));
+    return ast->hash();
+}
+
+namespace {
+
+using Items = std::vector<Ast*>;
+
+Ast* unwrapped(Ast* ast)
+{
+    if (ast->kind() == Ast::Kind::DeclStmt && DeclStmt_Cast(ast)->decl_)
+        return DeclStmt_Cast(ast)->decl_.get();
+    return ast;
+}
+
+size_t hashOf(Ast* ast)
+{
+    if (ast->isDecl())
+        return Decl_Cast(ast)->hash();
+    if (ast->isStmt())
+        return Stmt_Cast(ast)->hash();
+    return 0;
+}
+
+Items programItems(ProgramAst* progAst)
+{
+    Items items;
+    if (progAst->module_)
+        items.push_back(progAst->module_.get());
+    if (progAst->package_)
+        items.push_back(progAst->package_.get());
+    if (progAst->decls_) {
+        for (auto decl : *progAst->decls_)
+            items.push_back(decl);
+    }
+    if (progAst->stmts_) {
+        for (auto stmt : *progAst->stmts_)
+            items.push_back(stmt);
+    }
+    return items;
+}
+
+Items recordMembers(Ast* ast)
+{
+    Items items;
+    if (ast->kind() != Ast::Kind::RecordDecl)
+        return items;
+    SpecAst* spec = RecordDecl_Cast(ast)->spec_.get();
+    if (!spec || spec->kind() != Ast::Kind::RecordSpec)
+        return items;
+
+    RecordSpecAst* recSpec = RecordSpec_Cast(spec);
+    if (recSpec->decls_) {
+        for (auto decl : *recSpec->decls_)
+            items.push_back(decl);
+    }
+    if (recSpec->proto_) {
+        if (recSpec->proto_->kind() == Ast::Kind::BlockStmt) {
+            auto block = BlockStmt_Cast(recSpec->proto_.get());
+            if (block->stmts_) {
+                for (auto stmt : *block->stmts_)
+                    items.push_back(stmt);
+            }
+        } else {
+            items.push_back(recSpec->proto_.get());
+        }
+    }
+    return items;
+}
+
+void diffItems(const Items& oldItems, const Items& newItems, int depth,
+               std::vector<AstChange>& changes)
+{
+    // A named declaration is identified by its kind and name, anything
+    // else by its kind and hash.
+    using Key = std::tuple<Ast::Kind, bool, size_t>;
+    auto keyOf = [](Ast* item) {
+        Ast* ast = unwrapped(item);
+        if (ast->isDecl() && Decl_Cast(ast)->nameHash())
+            return Key(ast->kind(), true, Decl_Cast(ast)->nameHash());
+        return Key(ast->kind(), false, hashOf(item));
+    };
+
+    std::map<Key, std::vector<size_t>> pending;
+    for (size_t i = oldItems.size(); i > 0; --i)
+        pending[keyOf(oldItems[i - 1])].push_back(i - 1);
+
+    std::vector<bool> matched(oldItems.size(), false);
+    for (auto newItem : newItems) {
+        auto it = pending.find(keyOf(newItem));
+        if (it == pending.end() || it->second.empty()) {
+            changes.push_back({ AstChange::Kind::Added, nullptr,
+                                unwrapped(newItem), depth });
+            continue;
+        }
+
+        // Repeated keys (e.g. redefinitions) are matched in order.
+        size_t idx = it->second.back();
+        it->second.pop_back();
+        matched[idx] = true;
+        Ast* oldItem = oldItems[idx];
+        if (hashOf(oldItem) == hashOf(newItem))
+            continue;
+
+        Ast* oldAst = unwrapped(oldItem);
+        Ast* newAst = unwrapped(newItem);
+        changes.push_back({ AstChange::Kind::Modified, oldAst, newAst, depth });
+        diffItems(recordMembers(oldAst), recordMembers(newAst), depth + 1, changes);
+    }
+
+    for (size_t i = 0; i < oldItems.size(); ++i) {
+        if (!matched[i]) {
+            changes.push_back({ AstChange::Kind::Removed,
+                                unwrapped(oldItems[i]), nullptr, depth });
+        }
+    }
+}
+
+} // anonymous
+
+std::vector<AstChange> uaiso::diffPrograms(ProgramAst* oldAst,
+                                           ProgramAst* newAst)
+{
+    std::vector<AstChange> changes;
+
+    UAISO_ASSERT(oldAst, return changes);
+    UAISO_ASSERT(newAst, return changes);
+
+    diffItems(programItems(oldAst), programItems(newAst), 0, changes);
+
+    return changes;
+}
@@ -0,0 +1,137 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#ifndef UAISO_ASTHASHER_H__
+#define UAISO_ASTHASHER_H__
+
+#include "Ast/AstFwd.h"
+#include "Common/Config.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace uaiso {
+
+class LexemeMap;
+
+/*!
+ * \brief The AstHasher class
+ *
+ * Compute structural (Merkle) hashes of declarations: the hash of a
+ * declaration's subtree combines the kinds of its nodes, their tokens, the
+ * spelling of names and literals, and where they are relative to the start
+ * of the declaration. A nested declaration contributes with its own hash,
+ * so each subtree is hashed once. Statements of a program or of a record's
+ * body are hashed as well, since they may declare names too (e.g. Python's
+ * assignments).
+ *
+ * A declaration that is moved around, but otherwise untouched, keeps its
+ * hash. Two hashes are comparable when the spellings of both programs come
+ * from lexemes, or when none of them do.
+ */
+class UAISO_API AstHasher final
+{
+public:
+    /*!
+     * \brief AstHasher
+     * \param lexs - The lexemes of the file, it might be null.
+     * \param fullFileName
+     */
+    AstHasher(const LexemeMap* lexs, const std::string& fullFileName);
+
+    /*!
+     * \brief hashProgram
+     * \param progAst
+     *
+     * Hash the declarations of the program, and the statements of the
+     * program and of its records' bodies. Front ends do this right after
+     * parsing.
+     */
+    void hashProgram(ProgramAst* progAst) const;
+
+    /*!
+     * \brief hashDecl
+     * \param ast
+     * \return
+     *
+     * Return the hash of the declaration, computing it (along with the
+     * hashes of nested declarations) if it's not set yet.
+     */
+    size_t hashDecl(DeclAst* ast) const;
+
+    /*!
+     * \brief hashStmt
+     * \param ast
+     * \return
+     *
+     * Return the hash of the statement, computing it if it's not set yet.
+     */
+    size_t hashStmt(StmtAst* ast) const;
+
+private:
+    const LexemeMap* lexs_;
+    std::string fileName_;
+};
+
+/*!
+ * \brief The AstChange struct
+ *
+ * A change between two parses of a program.
+ */
+struct UAISO_API AstChange
+{
+    enum class Kind : char
+    {
+        Added,
+        Removed,
+        Modified
+    };
+
+    Kind kind_;
+    Ast* oldAst_;   //!< The declaration or statement before, null if added.
+    Ast* newAst_;   //!< The declaration or statement after, null if removed.
+    int depth_;     //!< Number of enclosing declarations.
+};
+
+    //--- Utility ---//
+
+/*!
+ * \brief diffPrograms
+ * \param oldAst
+ * \param newAst
+ * \return
+ *
+ * Compare two hashed programs and return which of their top-level and
+ * record member declarations (or statements) were added, removed, or
+ * modified. Declarations are matched by kind and name, in order, unnamed
+ * ones and statements only match an identical counterpart. A modified
+ * record is followed by the changes of its members.
+ *
+ * \sa AstHasher
+ */
+UAISO_API std::vector<AstChange> diffPrograms(ProgramAst* oldAst,
+                                              ProgramAst* newAst);
+
+} // namespace uaiso
+
+#endif
@@ -24,11 +24,41 @@
 #include "Ast/AstLocator.h"
 #include "Ast/Ast.h"
 #include "Ast/AstDefs.h"
+#include "Ast/AstVisitor.h"
 #include "Common/Assert.h"
 #include "Parsing/SourceLoc.h"
+#include <vector>
 
 using namespace uaiso;
 
+namespace {
+
+/*!
+ * \brief The SpanCollector class
+ *
+ * Collect the nodes of a program in preorder.
+ */
+class SpanCollector final : public AstVisitor<SpanCollector>
+{
+public:
+    VisitResult visitName(NameAst* ast) { return collect(ast); }
+    VisitResult visitSpec(SpecAst* ast) { return collect(ast); }
+    VisitResult visitAttr(AttrAst* ast) { return collect(ast); }
+    VisitResult visitDecl(DeclAst* ast) { return collect(ast); }
+    VisitResult visitExpr(ExprAst* ast) { return collect(ast); }
+    VisitResult visitStmt(StmtAst* ast) { return collect(ast); }
+
+    VisitResult collect(Ast* ast)
+    {
+        asts_.push_back(ast);
+        return Continue;
+    }
+
+    std::vector<Ast*> asts_;
+};
+
+} // anonymous
+
 AstLocator::~AstLocator()
 {}
 
@@ -36,6 +66,8 @@ const SourceLoc& AstLocator::loc(Ast* ast) const \
 {
     if (!ast)
         return kEmptyLoc;
+    if (ast->hasSpan())
+        return ast->spanFirstLoc();
 
 #define MAKE_CASE(AST_NODE, AST_KIND) \
     case Ast::Kind::AST_NODE##AST_KIND: \
@@ -60,6 +92,8 @@ const SourceLoc& AstLocator::lastLoc(Ast* ast) const \
 {
     if (!ast)
         return kEmptyLoc;
+    if (ast->hasSpan())
+        return ast->spanLastLoc();
 
 #define MAKE_CASE(AST_NODE, AST_KIND) \
     case Ast::Kind::AST_NODE##AST_KIND: \
@@ -80,6 +114,32 @@ const SourceLoc& AstLocator::lastLoc(Ast* ast) const \
 #undef MAKE_CASE
 }
 
+void AstLocator::cacheSpans(ProgramAst* progAst) const
+{
+    UAISO_ASSERT(progAst, return);
+
+    SpanCollector collector;
+    collector.traverseDecl(progAst->module());
+    collector.traverseDecl(progAst->package());
+    if (progAst->decls()) {
+        for (auto decl : *progAst->decls())
+            collector.traverseDecl(decl);
+    }
+    if (progAst->stmts()) {
+        for (auto stmt : *progAst->stmts())
+            collector.traverseStmt(stmt);
+    }
+
+    // In reverse preorder, a node comes after its descendants, whose spans
+    // are then looked up rather than computed again.
+    for (auto it = collector.asts_.rbegin(); it != collector.asts_.rend(); ++it) {
+        Ast* ast = *it;
+        ast->setSpan(nullptr, nullptr); // Recompute a stale span.
+        const SourceLoc& first = loc(ast);
+        ast->setSpan(&first, &lastLoc(ast));
+    }
+}
+
 const SourceLoc& AstLocator::loc(SimpleNameAst* ast) const
 {
     return ast->nameLoc_;
@@ -1592,6 +1652,8 @@ const SourceLoc& AstLocator::loc(PrintExprAst* ast) const
 
 const SourceLoc& AstLocator::lastLoc(PrintExprAst* ast) const
 {
+    if (!ast->exprs_)
+        return ast->keyLoc_;
     return lastLoc(ast->exprs_->back());
 }
 
@@ -1602,6 +1664,8 @@ const SourceLoc& AstLocator::loc(YieldExprAst* ast) const
 
 const SourceLoc& AstLocator::lastLoc(YieldExprAst* ast) const
 {
+    if (!ast->exprs_)
+        return ast->keyLoc_;
     return lastLoc(ast->exprs_->back());
 }
 
@@ -1615,7 +1679,7 @@ const SourceLoc& AstLocator::lastLoc(ListCompreExprAst* ast) const
     if (ast->gens_) {
         if (ast->gens_->back()->filters_)
             return lastLoc(ast->gens_->back()->filters_->back());
-        return lastLoc(ast->gens_->back());
+        return lastLoc(ast->gens_->back()->range_.get());
     }
     return lastLoc(ast->expr_.get());
 }
@@ -1841,6 +1905,8 @@ const SourceLoc& AstLocator::loc(CaseClauseStmtAst* ast) const
 
 const SourceLoc& AstLocator::lastLoc(CaseClauseStmtAst* ast) const
 {
+    if (!ast->stmts_)
+        return ast->delimLoc_;
     return lastLoc(ast->stmts_->back());
 }
 
@@ -1851,6 +1917,8 @@ const SourceLoc& AstLocator::loc(DefaultClauseStmtAst* ast) const
 
 const SourceLoc& AstLocator::lastLoc(DefaultClauseStmtAst* ast) const
 {
+    if (!ast->stmts_)
+        return ast->delimLoc_;
     return lastLoc(ast->stmts_->back());
 }
 
@@ -37,9 +37,37 @@ class UAISO_API AstLocator
 public:
     virtual ~AstLocator();
 
+    /*!
+     * \brief loc
+     * \return
+     *
+     * Return the location of the node's first token. If the node's span is
+     * cached, that's a constant time lookup.
+     */
     const SourceLoc& loc(Ast*) const;
+
+    /*!
+     * \brief lastLoc
+     * \return
+     *
+     * Return the location of the node's last token. If the node's span is
+     * cached, that's a constant time lookup.
+     */
     const SourceLoc& lastLoc(Ast*) const;
 
+    /*!
+     * \brief cacheSpans
+     * \param progAst
+     *
+     * Cache the span of every node in the program, children before their
+     * parents, so that each one is computed once. Front ends do this right
+     * after parsing.
+     *
+     * \note A node whose tokens are changed afterwards must have its span
+     * (and the ones of its ancestors) cached again.
+     */
+    void cacheSpans(ProgramAst* progAst) const;
+
 #define DECLARE_FUNCS(AST_NODE, AST_KIND) \
     virtual const SourceLoc& loc(AST_NODE##AST_KIND##Ast*) const; \
     virtual const SourceLoc& lastLoc(AST_NODE##AST_KIND##Ast*) const;
@@ -70,7 +98,8 @@ STMT_AST_MIXIN(DECLARE_STMT_FUNCS)
 template <class AstT>
 SourceLoc fullLoc(AstT* ast, const AstLocator* locator)
 {
-    return joinedLoc(locator->loc(ast), locator->lastLoc(ast));
+    return joinedLoc(locator->loc(static_cast<Ast*>(ast)),
+                     locator->lastLoc(static_cast<Ast*>(ast)));
 }
 
 template <class AstT>
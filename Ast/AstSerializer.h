@@ -192,6 +192,8 @@ private:
     VisitResult traverseInStmt(InStmtAst* ast);
     VisitResult traverseOutStmt(OutStmtAst* ast);
     VisitResult traverseEmptyStmt(EmptyStmtAst* ast);
+
+    std::ostream* output_ { nullptr };
 };
 
 /*!
@@ -94,8 +94,10 @@ public:
     {}
 
     NAMED_LOC_PARAM(Key, key)
+    NAMED_TOKEN_PARAM(Key, key)
 
     SourceLoc keyLoc_;
+    Token keyTk_ { TK_INVALID };
 };
 
 /*!
@@ -113,7 +115,11 @@ public:
 
     NAMED_AST_PARAM(Name, name, NameAst)
 
+    RESOLVED_DECL_PARAM
+
     std::unique_ptr<NameAst> name_;
+    NameResolution resolution_ { NameResolution::Pending };
+    const Decl* decl_ { nullptr };
 };
 
 /*!
@@ -35,6 +35,22 @@ class UAISO_API StmtAst : public Ast
 {
 public:
     using Ast::Ast;
+
+    /*!
+     * \brief setHash
+     * \param hash
+     *
+     * Set the structural hash of the statement's subtree. Only statements
+     * of a program or of a record's body are hashed.
+     *
+     * \sa AstHasher
+     */
+    void setHash(size_t hash) { hash_ = hash; }
+
+    size_t hash() const { return hash_; }
+
+private:
+    size_t hash_ { 0 };
 };
 
 class UAISO_API EmptyStmtAst final : public StmtAst
@@ -28,6 +28,8 @@
 #include "Ast/AstDefs.h"
 #include "Common/Assert.h"
 #include <iostream>
+#include <type_traits>
+#include <vector>
 
 namespace uaiso {
 
@@ -138,8 +140,137 @@ STMT_AST_MIXIN(STMT_NODES)
 protected:
     template <class AstT, class AstListT>
     VisitResult traverseList(AstListT* list, VisitResult (DerivedT::*traverse)(AstT*));
+
+    /*
+     * Binary expression chains (e.g., a long concatenation) and else-if
+     * chains may nest deep enough to exhaust the call stack. If the actual
+     * visitor keeps the default traversal of such nodes, they're followed
+     * with an explicit stack instead. The visits happen in the same order
+     * and with the same results as in a recursive traversal.
+     */
+    template <class AstT> bool traversesIteratively(AstT*) { return false; }
+    bool traversesIteratively(ExprAst* ast);
+    bool traversesIteratively(StmtAst* ast);
+
+    template <class AstT> VisitResult traverseIteratively(AstT*) { return Continue; }
+    VisitResult traverseIteratively(ExprAst* ast);
+    VisitResult traverseIteratively(StmtAst* ast);
+
+    VisitResult visitExprOnly(ExprAst* ast);
 };
 
+#define USES_DEFAULT_TRAVERSAL(AST_NODE, AST_KIND) \
+    std::is_same<decltype(&DerivedT::traverse##AST_NODE##AST_KIND), \
+                 VisitResult (Self::*)(AST_NODE##AST_KIND##Ast*)>::value
+
+template <class DerivedT>
+bool AstVisitor<DerivedT>::traversesIteratively(ExprAst* ast)
+{
+    if (!USES_DEFAULT_TRAVERSAL(, Expr))
+        return false;
+
+    switch (ast->kind()) {
+#define MAKE_CASE(AST_NODE, UNUSED) \
+    case Ast::Kind::AST_NODE##Expr: \
+        return std::is_base_of<BinExprAst, AST_NODE##ExprAst>::value \
+                && USES_DEFAULT_TRAVERSAL(AST_NODE, Expr);
+    EXPR_AST_MIXIN(MAKE_CASE)
+#undef MAKE_CASE
+    default:
+        return false;
+    }
+}
+
+template <class DerivedT>
+bool AstVisitor<DerivedT>::traversesIteratively(StmtAst* ast)
+{
+    return ast->kind() == Ast::Kind::IfStmt
+            && USES_DEFAULT_TRAVERSAL(, Stmt)
+            && USES_DEFAULT_TRAVERSAL(If, Stmt);
+}
+
+#undef USES_DEFAULT_TRAVERSAL
+
+template <class DerivedT> typename AstVisitor<DerivedT>::VisitResult
+AstVisitor<DerivedT>::visitExprOnly(ExprAst* ast)
+{
+    switch (ast->kind()) {
+#define MAKE_CASE(AST_NODE, UNUSED) \
+    case Ast::Kind::AST_NODE##Expr: \
+        return actualVisitor().recursivelyVisit##AST_NODE##Expr(static_cast<AST_NODE##ExprAst*>(ast));
+    EXPR_AST_MIXIN(MAKE_CASE)
+#undef MAKE_CASE
+    default:
+        UAISO_ASSERT(false, return Abort);
+        return Abort;
+    }
+}
+
+template <class DerivedT> typename AstVisitor<DerivedT>::VisitResult
+AstVisitor<DerivedT>::traverseIteratively(ExprAst* ast)
+{
+    // Binary expressions nest on their left operand. Descend through them
+    // first, keeping the ones whose right operand is still due.
+    std::vector<BinExprAst*> pending;
+    VisitResult result;
+    while (true) {
+        if (!ast || !traversesIteratively(ast)) {
+            result = actualVisitor().traverseExpr(ast);
+            break;
+        }
+        result = visitExprOnly(ast);
+        if (result == Abort)
+            return Abort;
+        if (result == Skip) {
+            result = Continue; // Operands are skipped, not the parent's.
+            break;
+        }
+        pending.push_back(static_cast<BinExprAst*>(ast));
+        ast = pending.back()->expr1_.get();
+    }
+
+    // A result other than Continue from the left operand prevents the
+    // traversal of the right one, but only an Abort goes further up.
+    while (!pending.empty()) {
+        if (result == Abort)
+            return Abort;
+        if (result == Continue)
+            result = actualVisitor().traverseExpr(pending.back()->expr2_.get());
+        if (result == Abort)
+            return Abort;
+        result = Continue;
+        pending.pop_back();
+    }
+
+    return result == Abort ? Abort : Continue;
+}
+
+template <class DerivedT> typename AstVisitor<DerivedT>::VisitResult
+AstVisitor<DerivedT>::traverseIteratively(StmtAst* ast)
+{
+    // An else-if arm is the last thing traversed in its parent, so the
+    // chain is followed in a loop.
+    while (ast && traversesIteratively(ast)) {
+        IfStmtAst* ifStmt = static_cast<IfStmtAst*>(ast);
+        VisitResult result = actualVisitor().recursivelyVisitIfStmt(ifStmt);
+        if (result == Continue)
+            result = actualVisitor().traverseStmt(ifStmt->preamble_.get());
+        if (result == Continue)
+            result = actualVisitor().traverseExpr(ifStmt->expr_.get());
+        if (result == Continue)
+            result = actualVisitor().traverseStmt(ifStmt->then_.get());
+        if (result == Abort)
+            return Abort;
+        if (result == Skip)
+            return Continue;
+        ast = ifStmt->notThen_.get();
+    }
+
+    if (ast && actualVisitor().traverseStmt(ast) == Abort)
+        return Abort;
+    return Continue;
+}
+
 template <class DerivedT> template <class AstT, class AstListT>
 typename AstVisitor<DerivedT>::VisitResult
 AstVisitor<DerivedT>::traverseList(AstListT* list,
@@ -164,6 +295,8 @@ AstVisitor<DerivedT>::traverseList(AstListT* list,
     { \
         if (!ast) \
             return Continue; \
+        if (traversesIteratively(ast)) \
+            return traverseIteratively(ast); \
         VisitResult result; \
         switch (ast->kind()) { \
         CASE_MAKER \
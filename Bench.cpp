@@ -0,0 +1,132 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+// Benchmark driver: the pipeline is run over the given files and the
+// allocations of each phase, per file, are written as JSON.
+
+#include "Ast/Ast.h"
+#include "Common/AllocStats.h"
+#include "Parsing/Factory.h"
+#include "Parsing/LexemeMap.h"
+#include "Parsing/TokenMap.h"
+#include "Parsing/Unit.h"
+#include "Semantic/Manager.h"
+#include "Semantic/Snapshot.h"
+#include "Semantic/TypeChecker.h"
+#include "StringUtils/string.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace uaiso;
+
+namespace {
+
+struct PerLang
+{
+    std::unique_ptr<Factory> factory_;
+    TokenMap tokens_;
+    LexemeMap lexs_;
+    Snapshot snapshot_;
+    Manager manager_;
+};
+
+bool langOf(const std::string& fileName, LangId& langId)
+{
+    if (str::ends_with(fileName, ".d"))
+        langId = LangId::D;
+    else if (str::ends_with(fileName, ".go"))
+        langId = LangId::Go;
+    else if (str::ends_with(fileName, ".py"))
+        langId = LangId::Py;
+    else
+        return false;
+    return true;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4 || strcmp(argv[1], "-a")) {
+        std::cerr << "usage: " << argv[0]
+                  << " -a <allocs.json> <file>..." << std::endl;
+        return 2;
+    }
+    const std::string allocsFileName = argv[2];
+
+    std::map<LangId, std::unique_ptr<PerLang>> langs;
+    AllocStats stats;
+    stats.attach();
+    int failed = 0;
+    for (int i = 3; i < argc; ++i) {
+        const std::string fileName = argv[i];
+        LangId langId;
+        if (!langOf(fileName, langId)) {
+            std::cerr << "unrecognized file suffix: " << fileName << std::endl;
+            ++failed;
+            continue;
+        }
+
+        std::unique_ptr<PerLang>& lang = langs[langId];
+        if (!lang) {
+            lang.reset(new PerLang);
+            lang->factory_ = FactoryCreator::create(langId);
+            lang->manager_.config(lang->factory_.get(), &lang->tokens_,
+                                  &lang->lexs_, lang->snapshot_);
+        }
+
+        FILE* file = fopen(fileName.c_str(), "r");
+        if (!file) {
+            std::cerr << "cannot open file: " << fileName << std::endl;
+            ++failed;
+            continue;
+        }
+        std::unique_ptr<Unit> unit = lang->manager_.process(file, fileName);
+        if (!unit->ast()) {
+            std::cerr << "cannot parse file: " << fileName << std::endl;
+            ++failed;
+            continue;
+        }
+
+        TypeChecker checker(lang->factory_.get());
+        checker.setLexemes(&lang->lexs_);
+        checker.setTokens(&lang->tokens_);
+        checker.setSnapshot(lang->snapshot_);
+        checker.check(Program_Cast(unit->ast()));
+    }
+    stats.detach();
+
+    std::ofstream ofs(allocsFileName);
+    if (!ofs.is_open()) {
+        std::cerr << "cannot write " << allocsFileName << std::endl;
+        return 1;
+    }
+    stats.writeJson(ofs);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+// Counting allocator: an executable that links this file has its global
+// operator new/delete replaced, reporting to AllocStats. It's not part of
+// the library on purpose, replacing the allocator is the program's call.
+
+#include "Common/AllocStats.h"
+#include <cstdlib>
+#include <new>
+
+using namespace uaiso;
+
+namespace {
+
+struct alignas(alignof(std::max_align_t)) Header
+{
+    size_t size_;
+    uint64_t tag_;
+};
+
+void* allocate(size_t size)
+{
+    void* mem = std::malloc(sizeof(Header) + size);
+    if (!mem)
+        return nullptr;
+
+    Header* header = static_cast<Header*>(mem);
+    header->size_ = size;
+    header->tag_ = AllocStats::noteAlloc(size);
+    return header + 1;
+}
+
+void deallocate(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    Header* header = static_cast<Header*>(ptr) - 1;
+    AllocStats::noteFree(header->tag_, header->size_);
+    std::free(header);
+}
+
+} // anonymous
+
+void* operator new(size_t size)
+{
+    if (!size)
+        size = 1;
+    while (true) {
+        if (void* ptr = allocate(size))
+            return ptr;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    deallocate(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    deallocate(ptr);
+}
@@ -0,0 +1,251 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Common/AllocStats.h"
+#include "Common/Assert.h"
+#include <atomic>
+#include <map>
+#include <utility>
+
+using namespace uaiso;
+
+namespace {
+
+thread_local AllocStats* current_ = nullptr;
+thread_local AllocStats::Phase* phase_ = nullptr;
+
+// Guard against allocations made by the accounting itself.
+thread_local bool inHook_ = false;
+
+std::atomic<uint32_t> lastSerial_ { 0 };
+
+void writeJsonStr(std::ostream& os, const std::string& s)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    os << '"';
+    for (auto c : s) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            os << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+void writeJsonCounters(std::ostream& os, const AllocStats::Counters& counters)
+{
+    os << "\"allocs\": " << counters.allocs_
+       << ", \"bytes\": " << counters.bytes_
+       << ", \"peakLiveBytes\": " << counters.peakLiveBytes_;
+}
+
+} // anonymous
+
+struct uaiso::AllocStats::AllocStatsImpl
+{
+    struct Bucket
+    {
+        Entry entry_;
+        size_t liveBytes_ { 0 };
+    };
+
+    uint32_t bucket(const char* phase, const std::string& fullFileName)
+    {
+        auto key = std::make_pair(std::string(phase), fullFileName);
+        auto it = index_.find(key);
+        if (it != index_.end())
+            return it->second;
+
+        uint32_t idx = buckets_.size();
+        buckets_.emplace_back();
+        buckets_.back().entry_.phase_ = key.first;
+        buckets_.back().entry_.fullFileName_ = key.second;
+        index_.insert(std::make_pair(std::move(key), idx));
+        return idx;
+    }
+
+    void renew()
+    {
+        buckets_.clear();
+        index_.clear();
+        total_ = Counters();
+        liveBytes_ = 0;
+        serial_ = ++lastSerial_;
+        bucket("", "");
+    }
+
+    std::vector<Bucket> buckets_;
+    std::map<std::pair<std::string, std::string>, uint32_t> index_;
+    Counters total_;
+    size_t liveBytes_ { 0 };
+    uint32_t serial_ { 0 };
+    AllocStats* prev_ { nullptr };
+    bool attached_ { false };
+};
+
+AllocStats::AllocStats()
+    : P(new AllocStatsImpl)
+{
+    P->renew();
+}
+
+AllocStats::~AllocStats()
+{
+    if (P->attached_)
+        detach();
+}
+
+bool AllocStats::isAttached()
+{
+    return current_ != nullptr;
+}
+
+void AllocStats::attach()
+{
+    UAISO_ASSERT(!P->attached_, return);
+
+    P->prev_ = current_;
+    P->attached_ = true;
+    current_ = this;
+}
+
+void AllocStats::detach()
+{
+    UAISO_ASSERT(P->attached_, return);
+    UAISO_ASSERT(current_ == this, return);
+
+    current_ = P->prev_;
+    P->prev_ = nullptr;
+    P->attached_ = false;
+}
+
+void AllocStats::reset()
+{
+    // A new serial disowns allocations accounted so far.
+    inHook_ = true;
+    P->renew();
+    inHook_ = false;
+}
+
+std::vector<AllocStats::Entry> AllocStats::entries() const
+{
+    std::vector<Entry> all;
+    for (const auto& bucket : P->buckets_) {
+        if (bucket.entry_.counters_.allocs_)
+            all.push_back(bucket.entry_);
+    }
+    return all;
+}
+
+AllocStats::Counters AllocStats::total() const
+{
+    return P->total_;
+}
+
+void AllocStats::writeJson(std::ostream& os) const
+{
+    os << "{\n  \"total\": { ";
+    writeJsonCounters(os, P->total_);
+    os << " },\n  \"phases\": [";
+    const char* sep = "\n";
+    for (const auto& entry : entries()) {
+        os << sep << "    { \"phase\": ";
+        writeJsonStr(os, entry.phase_);
+        os << ", \"file\": ";
+        writeJsonStr(os, entry.fullFileName_);
+        os << ", ";
+        writeJsonCounters(os, entry.counters_);
+        os << " }";
+        sep = ",\n";
+    }
+    os << "\n  ]\n}\n";
+}
+
+uint64_t AllocStats::noteAlloc(size_t size)
+{
+    if (!current_ || inHook_)
+        return 0;
+
+    inHook_ = true;
+    AllocStatsImpl* impl = current_->P.get();
+    uint32_t idx = 0;
+    if (phase_) {
+        if (phase_->serial_ != impl->serial_) {
+            phase_->bucket_ = impl->bucket(phase_->name_, phase_->fullFileName_);
+            phase_->serial_ = impl->serial_;
+        }
+        idx = phase_->bucket_;
+    }
+    inHook_ = false;
+
+    auto& bucket = impl->buckets_[idx];
+    ++bucket.entry_.counters_.allocs_;
+    bucket.entry_.counters_.bytes_ += size;
+    bucket.liveBytes_ += size;
+    if (bucket.liveBytes_ > bucket.entry_.counters_.peakLiveBytes_)
+        bucket.entry_.counters_.peakLiveBytes_ = bucket.liveBytes_;
+
+    ++impl->total_.allocs_;
+    impl->total_.bytes_ += size;
+    impl->liveBytes_ += size;
+    if (impl->liveBytes_ > impl->total_.peakLiveBytes_)
+        impl->total_.peakLiveBytes_ = impl->liveBytes_;
+
+    return (static_cast<uint64_t>(impl->serial_) << 32) | idx;
+}
+
+void AllocStats::noteFree(uint64_t tag, size_t size)
+{
+    if (!tag || !current_)
+        return;
+
+    AllocStatsImpl* impl = current_->P.get();
+    if (static_cast<uint32_t>(tag >> 32) != impl->serial_)
+        return;
+
+    auto& bucket = impl->buckets_[static_cast<uint32_t>(tag)];
+    bucket.liveBytes_ -= size;
+    impl->liveBytes_ -= size;
+}
+
+AllocStats::Phase::Phase(const char* name, const std::string& fullFileName)
+    : name_(name)
+    , prev_(phase_)
+{
+    if (current_) {
+        // Not accounted for, the copy is the accounting's own.
+        inHook_ = true;
+        fullFileName_ = fullFileName;
+        inHook_ = false;
+    }
+    phase_ = this;
+}
+
+AllocStats::Phase::~Phase()
+{
+    phase_ = prev_;
+}
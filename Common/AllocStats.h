@@ -0,0 +1,185 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#ifndef UAISO_ALLOCSTATS_H__
+#define UAISO_ALLOCSTATS_H__
+
+#include "Common/Config.h"
+#include "Common/Pimpl.h"
+#include "Common/Test.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace uaiso {
+
+/*!
+ * \brief The AllocStats class
+ *
+ * Count heap allocations per pipeline phase (parse, bind, check, etc.) and
+ * per file. Counting happens while the stats are attached to the current
+ * thread, and only for allocations performed by that thread.
+ *
+ * Allocations are reported by a counting allocator: an executable opts in
+ * by linking Common/AllocHook.cpp, which replaces the global operator new
+ * and delete. Without it, attaching stats is harmless but nothing is
+ * counted.
+ */
+class UAISO_API AllocStats final
+{
+public:
+    AllocStats();
+    ~AllocStats();
+
+    /*!
+     * \brief The Phase class
+     *
+     * Tag allocations performed by the current thread, while in scope, with
+     * the given phase and file names. Phases nest, the innermost one wins.
+     *
+     * \note The phase name must be a literal (it's referenced). The file
+     * name is copied, but only if stats are attached to the thread.
+     */
+    class UAISO_API Phase final
+    {
+    public:
+        Phase(const char* name, const std::string& fullFileName);
+        ~Phase();
+
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+    private:
+        friend class AllocStats;
+
+        const char* name_;
+        std::string fullFileName_;
+        Phase* prev_;
+        uint32_t serial_ { 0 };
+        uint32_t bucket_ { 0 };
+    };
+
+    /*!
+     * \brief The Counters struct
+     */
+    struct Counters
+    {
+        size_t allocs_ { 0 };
+        size_t bytes_ { 0 };
+        size_t peakLiveBytes_ { 0 };
+    };
+
+    /*!
+     * \brief The Entry struct
+     *
+     * Counters of a phase for a file. Allocations made outside any phase
+     * are accounted under empty names.
+     */
+    struct Entry
+    {
+        std::string phase_;
+        std::string fullFileName_;
+        Counters counters_;
+    };
+
+    /*!
+     * \brief isAttached
+     * \return
+     *
+     * Return whether stats are attached to the current thread, so that
+     * callers can skip preparing a phase's file name otherwise.
+     */
+    static bool isAttached();
+
+    /*!
+     * \brief attach
+     *
+     * Start counting allocations in the current thread.
+     */
+    void attach();
+
+    /*!
+     * \brief detach
+     *
+     * Stop counting, restoring the previously attached stats (if any).
+     */
+    void detach();
+
+    void reset();
+
+    /*!
+     * \brief entries
+     * \return
+     *
+     * Return the counters per phase and file, in order of first allocation.
+     */
+    std::vector<Entry> entries() const;
+
+    /*!
+     * \brief total
+     * \return
+     *
+     * Return the counters over all phases. The peak is the one of the
+     * overall live bytes, not the sum of peaks.
+     */
+    Counters total() const;
+
+    /*!
+     * \brief writeJson
+     * \param os
+     */
+    void writeJson(std::ostream& os) const;
+
+    /*!
+     * \brief noteAlloc
+     * \param size
+     * \return
+     *
+     * Account for an allocation of the given size and return a tag that
+     * must be handed to noteFree when it's released. Meant for the counting
+     * allocator only.
+     */
+    static uint64_t noteAlloc(size_t size);
+
+    /*!
+     * \brief noteFree
+     * \param tag
+     * \param size
+     *
+     * Account for the release of an allocation.
+     *
+     * \note Releases by other threads, or after the stats were detached,
+     * are not seen; the live bytes are then overestimated.
+     */
+    static void noteFree(uint64_t tag, size_t size);
+
+private:
+    DECL_PIMPL(AllocStats)
+    DECL_CLASS_TEST(AllocStats)
+};
+
+} // namespace uaiso
+
+#endif
@@ -0,0 +1,161 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016-2015 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Common/AllocStats.h"
+#include <memory>
+#include <sstream>
+
+using namespace uaiso;
+
+class AllocStats::AllocStatsTest final : public Test
+{
+public:
+    TEST_RUN(AllocStatsTest
+             , &AllocStatsTest::testCase1
+             , &AllocStatsTest::testCase2
+             , &AllocStatsTest::testCase3
+             )
+
+    /*!
+     * Skip, unless the allocator reports to the stats (it doesn't when
+     * Common/AllocHook.cpp isn't linked, as in sanitizer builds).
+     */
+    void requireHook()
+    {
+        AllocStats stats;
+        stats.attach();
+        probe_.reset(new char[1]);
+        stats.detach();
+        probe_.reset();
+        if (!stats.total().allocs_)
+            UAISO_SKIP_TEST;
+    }
+
+    const Entry* find(const AllocStats& stats,
+                      const char* phase,
+                      const std::string& fileName)
+    {
+        entries_ = stats.entries();
+        for (const auto& entry : entries_) {
+            if (entry.phase_ == phase && entry.fullFileName_ == fileName)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    void testCase1()
+    {
+        requireHook();
+
+        std::string fileName = "/tmp/a.py";
+        AllocStats stats;
+        stats.attach();
+        {
+            Phase phase("parse", fileName);
+            std::unique_ptr<char[]> data(new char[1000]);
+        }
+        stats.detach();
+
+        const Entry* entry = find(stats, "parse", fileName);
+        UAISO_EXPECT_TRUE(entry);
+        UAISO_EXPECT_INT_EQ(1, entry->counters_.allocs_);
+        UAISO_EXPECT_INT_EQ(1000, entry->counters_.bytes_);
+        UAISO_EXPECT_INT_EQ(1000, entry->counters_.peakLiveBytes_);
+        UAISO_EXPECT_TRUE(stats.total().allocs_ >= 1);
+        UAISO_EXPECT_TRUE(stats.total().bytes_ >= 1000);
+
+        // Nothing is counted once detached.
+        std::unique_ptr<char[]> data(new char[1000]);
+        UAISO_EXPECT_INT_EQ(1, find(stats, "parse", fileName)->counters_.allocs_);
+    }
+
+    void testCase2()
+    {
+        requireHook();
+
+        // Inner phases win; the peak accounts for releases.
+        std::string fileName = "/tmp/a.py";
+        AllocStats stats;
+        stats.attach();
+        {
+            Phase outer("bind", fileName);
+            std::unique_ptr<char[]> data(new char[100]);
+            {
+                Phase inner("parse", fileName);
+                data.reset(new char[300]);
+                data.reset();
+                data.reset(new char[200]);
+            }
+            data.reset();
+        }
+        stats.detach();
+
+        const Entry* bind = find(stats, "bind", fileName);
+        UAISO_EXPECT_TRUE(bind);
+        UAISO_EXPECT_INT_EQ(1, bind->counters_.allocs_);
+        UAISO_EXPECT_INT_EQ(100, bind->counters_.peakLiveBytes_);
+        const Entry* parse = find(stats, "parse", fileName);
+        UAISO_EXPECT_TRUE(parse);
+        UAISO_EXPECT_INT_EQ(2, parse->counters_.allocs_);
+        UAISO_EXPECT_INT_EQ(500, parse->counters_.bytes_);
+        UAISO_EXPECT_INT_EQ(300, parse->counters_.peakLiveBytes_);
+    }
+
+    void testCase3()
+    {
+        requireHook();
+
+        std::string fileName = "/tmp/\"a\".py";
+        AllocStats stats;
+        stats.attach();
+        {
+            Phase phase("check", fileName);
+            std::unique_ptr<int> data(new int);
+        }
+        stats.detach();
+
+        std::ostringstream oss;
+        stats.writeJson(oss);
+        UAISO_EXPECT_TRUE(oss.str().find("\"phase\": \"check\", "
+                                         "\"file\": \"/tmp/\\\"a\\\".py\", "
+                                         "\"allocs\": 1, ") != std::string::npos);
+
+        // Counters are discarded, releases of earlier allocations as well.
+        std::unique_ptr<int> data;
+        stats.attach();
+        {
+            Phase phase("check", fileName);
+            data.reset(new int);
+            stats.reset();
+            data.reset();
+        }
+        stats.detach();
+        UAISO_EXPECT_FALSE(find(stats, "check", fileName));
+        UAISO_EXPECT_INT_EQ(0, stats.total().allocs_);
+    }
+
+    std::vector<Entry> entries_;
+    std::unique_ptr<char[]> probe_;
+};
+
+MAKE_CLASS_TEST(AllocStats)
@@ -0,0 +1,342 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Common/LatencyStats.h"
+#include "Common/Assert.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+using namespace uaiso;
+
+namespace {
+
+// Names of the keys, by id. Keys may be static in other files, so the
+// names are constructed on first use.
+std::mutex keysMutex_;
+
+std::vector<const char*>& keyNames()
+{
+    static std::vector<const char*> names;
+    return names;
+}
+
+std::vector<const char*> copyKeyNames()
+{
+    std::lock_guard<std::mutex> lock(keysMutex_);
+    return keyNames();
+}
+
+// Threads are spread among the shards of the stats.
+const size_t ShardCount = 16;
+std::atomic<size_t> nextShard_ { 0 };
+
+// Values below 2^PrecisionBits have a bucket of their own, others share a
+// bucket with those of the same leading PrecisionBits bits.
+const int PrecisionBits = 5;
+const uint64_t SubBuckets = uint64_t(1) << PrecisionBits;
+
+size_t bucketOf(uint64_t value)
+{
+    if (value < SubBuckets)
+        return value;
+
+    int msb = 63;
+    while (!(value >> msb))
+        --msb;
+    int shift = msb - PrecisionBits;
+    return (shift + 1) * SubBuckets + ((value >> shift) - SubBuckets);
+}
+
+uint64_t highestOf(size_t bucket)
+{
+    if (bucket < SubBuckets)
+        return bucket;
+
+    int shift = int(bucket / SubBuckets) - 1;
+    uint64_t mantissa = bucket % SubBuckets + SubBuckets;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void writeJsonHistogram(std::ostream& os, const LatencyStats::Histogram& histo)
+{
+    os << "\"count\": " << histo.count_
+       << ", \"minNs\": " << histo.min_
+       << ", \"maxNs\": " << histo.max_
+       << ", \"meanNs\": " << histo.mean()
+       << ", \"p50Ns\": " << histo.percentile(50)
+       << ", \"p90Ns\": " << histo.percentile(90)
+       << ", \"p99Ns\": " << histo.percentile(99)
+       << ", \"p999Ns\": " << histo.percentile(99.9);
+}
+
+} // anonymous
+
+struct uaiso::LatencyStats::Data
+{
+    struct Shard
+    {
+        std::mutex mutex_;
+        std::vector<Histogram> histos_; // By key id.
+        std::vector<uint64_t> counters_; // By key id.
+    };
+    Shard shards_[ShardCount];
+
+    Shard& shard()
+    {
+        thread_local size_t index = nextShard_++ % ShardCount;
+        return shards_[index];
+    }
+
+    void record(size_t id, uint64_t nanos)
+    {
+        Shard& shard = this->shard();
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        if (shard.histos_.size() <= id)
+            shard.histos_.resize(id + 1);
+        auto& histo = shard.histos_[id];
+        size_t bucket = bucketOf(nanos);
+        if (histo.buckets_.size() <= bucket)
+            histo.buckets_.resize(bucket + 1);
+        ++histo.buckets_[bucket];
+        if (!histo.count_ || nanos < histo.min_)
+            histo.min_ = nanos;
+        if (nanos > histo.max_)
+            histo.max_ = nanos;
+        histo.sum_ += nanos;
+        ++histo.count_;
+    }
+
+    void count(size_t id, uint64_t n)
+    {
+        Shard& shard = this->shard();
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        if (shard.counters_.size() <= id)
+            shard.counters_.resize(id + 1);
+        shard.counters_[id] += n;
+    }
+};
+
+struct uaiso::LatencyStats::LatencyStatsImpl
+{
+    // The attached data, accessed through std::atomic_load and
+    // std::atomic_store, so that timers in flight keep it alive. Its sample
+    // rate is checked first, and is zero while nothing is attached.
+    static std::shared_ptr<Data> current_;
+    static std::atomic<unsigned> currentRate_;
+
+    std::shared_ptr<Data> data_ { std::make_shared<Data>() };
+    unsigned rate_ { 1 };
+    std::shared_ptr<Data> prev_;
+    unsigned prevRate_ { 0 };
+    bool attached_ { false };
+};
+
+std::shared_ptr<LatencyStats::Data> LatencyStats::LatencyStatsImpl::current_;
+std::atomic<unsigned> LatencyStats::LatencyStatsImpl::currentRate_ { 0 };
+
+LatencyStats::Key::Key(const char* name)
+    : name_(name)
+{
+    std::lock_guard<std::mutex> lock(keysMutex_);
+    id_ = keyNames().size();
+    keyNames().push_back(name);
+}
+
+LatencyStats::LatencyStats()
+    : P(new LatencyStatsImpl)
+{}
+
+LatencyStats::~LatencyStats()
+{
+    if (P->attached_)
+        detach();
+}
+
+void LatencyStats::attach()
+{
+    UAISO_ASSERT(!P->attached_, return);
+
+    P->prev_ = std::atomic_exchange(&LatencyStatsImpl::current_, P->data_);
+    P->prevRate_ = LatencyStatsImpl::currentRate_.exchange(P->rate_);
+    P->attached_ = true;
+}
+
+void LatencyStats::detach()
+{
+    UAISO_ASSERT(P->attached_, return);
+    UAISO_ASSERT(std::atomic_load(&LatencyStatsImpl::current_) == P->data_,
+                 return);
+
+    LatencyStatsImpl::currentRate_ = P->prevRate_;
+    std::atomic_store(&LatencyStatsImpl::current_, std::move(P->prev_));
+    P->prevRate_ = 0;
+    P->attached_ = false;
+}
+
+void LatencyStats::reset()
+{
+    for (auto& shard : P->data_->shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        shard.histos_.clear();
+        shard.counters_.clear();
+    }
+}
+
+void LatencyStats::setSampleRate(unsigned rate)
+{
+    P->rate_ = std::max(rate, 1u);
+    if (P->attached_)
+        LatencyStatsImpl::currentRate_ = P->rate_;
+}
+
+void LatencyStats::record(const Key& key, uint64_t nanos)
+{
+    P->data_->record(key.id_, nanos);
+}
+
+void LatencyStats::count(const Key& key, uint64_t n)
+{
+    if (!LatencyStatsImpl::currentRate_.load(std::memory_order_relaxed))
+        return;
+
+    auto data = std::atomic_load(&LatencyStatsImpl::current_);
+    if (data)
+        data->count(key.id_, n);
+}
+
+std::vector<LatencyStats::Entry> LatencyStats::entries() const
+{
+    // Keys of the same name (from different places) are merged as well.
+    auto names = copyKeyNames();
+    std::map<std::string, Histogram> histos;
+    for (auto& shard : P->data_->shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        for (size_t id = 0; id < shard.histos_.size(); ++id) {
+            const Histogram& histo = shard.histos_[id];
+            if (!histo.count_)
+                continue;
+            Histogram& all = histos[names[id]];
+            if (all.buckets_.size() < histo.buckets_.size())
+                all.buckets_.resize(histo.buckets_.size());
+            for (size_t bucket = 0; bucket < histo.buckets_.size(); ++bucket)
+                all.buckets_[bucket] += histo.buckets_[bucket];
+            if (!all.count_ || histo.min_ < all.min_)
+                all.min_ = histo.min_;
+            all.max_ = std::max(all.max_, histo.max_);
+            all.sum_ += histo.sum_;
+            all.count_ += histo.count_;
+        }
+    }
+
+    std::vector<Entry> all;
+    for (auto& histo : histos)
+        all.push_back(Entry{ histo.first, std::move(histo.second) });
+    return all;
+}
+
+std::vector<LatencyStats::Counter> LatencyStats::counters() const
+{
+    auto names = copyKeyNames();
+    std::map<std::string, uint64_t> counters;
+    for (auto& shard : P->data_->shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        for (size_t id = 0; id < shard.counters_.size(); ++id) {
+            if (shard.counters_[id])
+                counters[names[id]] += shard.counters_[id];
+        }
+    }
+
+    std::vector<Counter> all;
+    for (const auto& counter : counters)
+        all.push_back(Counter{ counter.first, counter.second });
+    return all;
+}
+
+void LatencyStats::writeJson(std::ostream& os) const
+{
+    os << "{\n  \"latencies\": [";
+    const char* sep = "\n";
+    for (const auto& entry : entries()) {
+        os << sep << "    { \"operation\": \"" << entry.name_ << "\", ";
+        writeJsonHistogram(os, entry.histogram_);
+        os << " }";
+        sep = ",\n";
+    }
+    os << "\n  ],\n  \"counters\": {";
+    sep = "\n";
+    for (const auto& counter : counters()) {
+        os << sep << "    \"" << counter.name_ << "\": " << counter.value_;
+        sep = ",\n";
+    }
+    os << "\n  }\n}\n";
+}
+
+uint64_t LatencyStats::Histogram::percentile(double p) const
+{
+    if (!count_)
+        return 0;
+
+    uint64_t rank = uint64_t(std::ceil(count_ * std::min(p, 100.0) / 100.0));
+    rank = std::max(rank, uint64_t(1));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < buckets_.size(); ++bucket) {
+        seen += buckets_[bucket];
+        if (seen >= rank)
+            return std::min(std::max(highestOf(bucket), min_), max_);
+    }
+    return max_;
+}
+
+uint64_t LatencyStats::Histogram::mean() const
+{
+    return count_ ? sum_ / count_ : 0;
+}
+
+LatencyStats::Timer::Timer(const Key& key)
+    : key_(key)
+{
+    unsigned rate = LatencyStatsImpl::currentRate_.load(std::memory_order_relaxed);
+    if (!rate)
+        return;
+
+    thread_local unsigned ticks = 0;
+    if (rate > 1 && ++ticks % rate)
+        return;
+
+    data_ = std::atomic_load(&LatencyStatsImpl::current_);
+    if (data_)
+        start_ = std::chrono::steady_clock::now();
+}
+
+LatencyStats::Timer::~Timer()
+{
+    if (!data_)
+        return;
+
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    data_->record(key_.id_, std::chrono::duration_cast<
+                  std::chrono::nanoseconds>(elapsed).count());
+}
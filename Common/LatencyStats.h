@@ -0,0 +1,232 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#ifndef UAISO_LATENCYSTATS_H__
+#define UAISO_LATENCYSTATS_H__
+
+#include "Common/Config.h"
+#include "Common/Pimpl.h"
+#include "Common/Test.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace uaiso {
+
+/*!
+ * \brief The LatencyStats class
+ *
+ * Keep latency histograms of engine operations (process, bind, check,
+ * etc.), along with event counters (such as cache hits and misses).
+ *
+ * Unlike AllocStats, latency stats are process-wide: once attached, they
+ * account for operations of every thread. When no stats are attached,
+ * timers don't even read the clock.
+ *
+ * Histograms have logarithmic buckets, each one split in 32 linear
+ * sub-buckets, so recorded values are kept within about 3% of precision.
+ *
+ * Operations and counters are named by static keys. Records go to one of
+ * several shards, picked per thread, so threads seldom contend.
+ */
+class UAISO_API LatencyStats final
+{
+public:
+    LatencyStats();
+    ~LatencyStats();
+
+    /*!
+     * \brief The Key class
+     *
+     * The name of an operation or counter. Keys are meant to be static (a
+     * key is registered once for the whole process):
+     *
+     * \code
+     * static const LatencyStats::Key key("bind");
+     * LatencyStats::Timer timer(key);
+     * \endcode
+     *
+     * \note The name is referenced, not copied.
+     */
+    class UAISO_API Key final
+    {
+    public:
+        explicit Key(const char* name);
+
+        const char* name() const { return name_; }
+
+    private:
+        friend class LatencyStats;
+
+        const char* name_;
+        size_t id_;
+    };
+
+private:
+    struct Data;
+
+public:
+    /*!
+     * \brief The Timer class
+     *
+     * Record, under the given operation key, the time spent while in scope.
+     * Attached stats are kept alive by timers in flight.
+     */
+    class UAISO_API Timer final
+    {
+    public:
+        Timer(const Key& key);
+        ~Timer();
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        const Key& key_;
+        std::shared_ptr<Data> data_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /*!
+     * \brief The Histogram struct
+     *
+     * Latencies of an operation, in nanoseconds.
+     */
+    struct Histogram
+    {
+        uint64_t count_ { 0 };
+        uint64_t min_ { 0 };
+        uint64_t max_ { 0 };
+        uint64_t sum_ { 0 };
+        std::vector<uint64_t> buckets_;
+
+        /*!
+         * \brief percentile
+         * \param p - A value between 0 and 100.
+         * \return
+         *
+         * Return the latency below which the given percentage of the
+         * recorded ones falls.
+         */
+        uint64_t percentile(double p) const;
+
+        uint64_t mean() const;
+    };
+
+    /*!
+     * \brief The Entry struct
+     */
+    struct Entry
+    {
+        std::string name_;
+        Histogram histogram_;
+    };
+
+    /*!
+     * \brief The Counter struct
+     */
+    struct Counter
+    {
+        std::string name_;
+        uint64_t value_;
+    };
+
+    /*!
+     * \brief attach
+     *
+     * Start accounting for operations of all threads.
+     */
+    void attach();
+
+    /*!
+     * \brief detach
+     *
+     * Stop accounting, restoring the previously attached stats (if any).
+     *
+     * \note Operations in flight may still be recorded.
+     */
+    void detach();
+
+    void reset();
+
+    /*!
+     * \brief setSampleRate
+     * \param rate
+     *
+     * While attached, time only one of every \a rate operations of a
+     * thread (every one, by default). Counters aren't sampled.
+     */
+    void setSampleRate(unsigned rate);
+
+    /*!
+     * \brief record
+     * \param key
+     * \param nanos
+     *
+     * Record a latency of the given operation.
+     */
+    void record(const Key& key, uint64_t nanos);
+
+    /*!
+     * \brief count
+     * \param key
+     * \param n
+     *
+     * Add to the given counter of the attached stats, if any.
+     */
+    static void count(const Key& key, uint64_t n = 1);
+
+    /*!
+     * \brief entries
+     * \return
+     *
+     * Return the histograms per operation, in order of name.
+     */
+    std::vector<Entry> entries() const;
+
+    /*!
+     * \brief counters
+     * \return
+     *
+     * Return the counters, in order of name.
+     */
+    std::vector<Counter> counters() const;
+
+    /*!
+     * \brief writeJson
+     * \param os
+     */
+    void writeJson(std::ostream& os) const;
+
+private:
+    DECL_PIMPL(LatencyStats)
+    DECL_CLASS_TEST(LatencyStats)
+};
+
+} // namespace uaiso
+
+#endif
@@ -0,0 +1,193 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Common/LatencyStats.h"
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace uaiso;
+
+class LatencyStats::LatencyStatsTest final : public Test
+{
+public:
+    TEST_RUN(LatencyStatsTest
+             , &LatencyStatsTest::testCase1
+             , &LatencyStatsTest::testCase2
+             , &LatencyStatsTest::testCase3
+             , &LatencyStatsTest::testCase4
+             , &LatencyStatsTest::testCase5
+             , &LatencyStatsTest::testCase6
+             )
+
+    LatencyStatsTest()
+        : op_("op")
+        , hits_("hits")
+    {}
+
+    bool isClose(uint64_t expected, uint64_t actual)
+    {
+        return std::llabs(int64_t(expected) - int64_t(actual)) <= int64_t(expected / 32);
+    }
+
+    void testCase1()
+    {
+        // Percentiles are kept within the histogram's precision.
+        LatencyStats stats;
+        for (uint64_t i = 1; i <= 1000; ++i)
+            stats.record(op_, i * 1000);
+
+        auto entries = stats.entries();
+        UAISO_EXPECT_INT_EQ(1, entries.size());
+        UAISO_EXPECT_STR_EQ("op", entries[0].name_);
+        const Histogram& histo = entries[0].histogram_;
+        UAISO_EXPECT_INT_EQ(1000, histo.count_);
+        UAISO_EXPECT_INT_EQ(1000, histo.min_);
+        UAISO_EXPECT_INT_EQ(1000000, histo.max_);
+        UAISO_EXPECT_INT_EQ(500500, histo.mean());
+        UAISO_EXPECT_TRUE(isClose(500000, histo.percentile(50)));
+        UAISO_EXPECT_TRUE(isClose(990000, histo.percentile(99)));
+        UAISO_EXPECT_INT_EQ(1000000, histo.percentile(100));
+        UAISO_EXPECT_TRUE(isClose(1000, histo.percentile(0)));
+    }
+
+    void testCase2()
+    {
+        // Small latencies are exact.
+        LatencyStats stats;
+        stats.record(op_, 3);
+        stats.record(op_, 3);
+        stats.record(op_, 7);
+        auto histo = stats.entries()[0].histogram_;
+        UAISO_EXPECT_INT_EQ(3, histo.percentile(50));
+        UAISO_EXPECT_INT_EQ(7, histo.percentile(90));
+
+        stats.reset();
+        UAISO_EXPECT_TRUE(stats.entries().empty());
+    }
+
+    void testCase3()
+    {
+        // Timers and counters account only while stats are attached.
+        LatencyStats stats;
+        {
+            Timer timer(op_);
+            LatencyStats::count(hits_);
+        }
+        UAISO_EXPECT_TRUE(stats.entries().empty());
+        UAISO_EXPECT_TRUE(stats.counters().empty());
+
+        stats.attach();
+        {
+            Timer timer(op_);
+            LatencyStats::count(hits_);
+            LatencyStats::count(hits_, 2);
+        }
+        stats.detach();
+        {
+            Timer timer(op_);
+            LatencyStats::count(hits_);
+        }
+
+        auto entries = stats.entries();
+        UAISO_EXPECT_INT_EQ(1, entries.size());
+        UAISO_EXPECT_INT_EQ(1, entries[0].histogram_.count_);
+        auto counters = stats.counters();
+        UAISO_EXPECT_INT_EQ(1, counters.size());
+        UAISO_EXPECT_STR_EQ("hits", counters[0].name_);
+        UAISO_EXPECT_INT_EQ(3, counters[0].value_);
+
+        std::ostringstream oss;
+        stats.writeJson(oss);
+        UAISO_EXPECT_TRUE(oss.str().find("\"operation\": \"op\", \"count\": 1")
+                          != std::string::npos);
+        UAISO_EXPECT_TRUE(oss.str().find("\"hits\": 3") != std::string::npos);
+    }
+
+    void testCase4()
+    {
+        // Only one of every few timers is recorded, counters are exact.
+        LatencyStats stats;
+        stats.setSampleRate(4);
+        stats.attach();
+        for (int i = 0; i < 100; ++i) {
+            Timer timer(op_);
+            LatencyStats::count(hits_);
+        }
+        stats.detach();
+
+        UAISO_EXPECT_INT_EQ(25, stats.entries()[0].histogram_.count_);
+        UAISO_EXPECT_INT_EQ(100, stats.counters()[0].value_);
+    }
+
+    void testCase5()
+    {
+        // Timers in flight keep the stats they record to alive.
+        std::unique_ptr<LatencyStats> stats(new LatencyStats);
+        stats->attach();
+        std::unique_ptr<Timer> timer(new Timer(op_));
+        stats.reset();
+        timer.reset();
+
+        LatencyStats other;
+        other.attach();
+        {
+            Timer timer(op_);
+        }
+        other.detach();
+        UAISO_EXPECT_INT_EQ(1, other.entries()[0].histogram_.count_);
+    }
+
+    void testCase6()
+    {
+        // Records of every thread are merged, with keys of the same name.
+        LatencyStats stats;
+        stats.attach();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back([this] {
+                Key sameHits("hits");
+                for (int j = 0; j < 1000; ++j) {
+                    Timer timer(op_);
+                    LatencyStats::count(j % 2 ? hits_ : sameHits);
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        stats.detach();
+
+        auto entries = stats.entries();
+        UAISO_EXPECT_INT_EQ(1, entries.size());
+        UAISO_EXPECT_INT_EQ(4000, entries[0].histogram_.count_);
+        auto counters = stats.counters();
+        UAISO_EXPECT_INT_EQ(1, counters.size());
+        UAISO_EXPECT_INT_EQ(4000, counters[0].value_);
+    }
+
+    const Key op_;
+    const Key hits_;
+};
+
+MAKE_CLASS_TEST(LatencyStats)
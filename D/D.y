@@ -45,6 +45,10 @@
 #undef D_YYDEBUG
 #endif
 #define D_YYDEBUG 1
+
+/* GLR traces may be counted, see GlrStats. */
+#include "Parsing/GlrStats.h"
+#define YYFPRINTF uaiso::GlrStats::trace
 }
 
 %code requires {
@@ -112,6 +116,12 @@ typedef struct D_YYLTYPE
 
 using namespace uaiso;
 
+/* Instead of the parser's global debug flag, which every thread would
+   share, traces are enabled per thread (defined along with yyerror). */
+#undef yydebug
+#define yydebug D_yytrace()
+int D_yytrace();
+
 void D_yyerror(YYLTYPE* yylloc,
                yyscan_t scanner,
                uaiso::ParsingContext* context,
@@ -1389,107 +1399,107 @@ BuiltinType:
     BOOL
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_BOOL);
     }
 |   BYTE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_BYTE);
     }
 |   UBYTE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_UBYTE);
     }
 |   INT16
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_INT16);
     }
 |   UINT16
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_UINT16);
     }
 |   INT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_INT);
     }
 |   UINT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_UINT);
     }
 |   INT64
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_INT64);
     }
 |   UINT64
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_UINT64);
     }
 |   CHAR
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_CHAR);
     }
 |   CHAR_UTF16
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_CHAR_UTF16);
     }
 |   CHAR_UTF32
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_CHAR_UTF32);
     }
 |   FLOAT32
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_FLOAT32);
     }
 |   FLOAT64
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_FLOAT64);
     }
 |   REAL
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_REAL);
     }
 |   IMAG_FLOAT32
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_IMAG_FLOAT32);
     }
 |   IMAG_FLOAT64
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_IMAG_FLOAT64);
     }
 |   IMAG_REAL
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_IMAG_REAL);
     }
 |   COMPLEX_FLOAT32
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_COMPLEX_FLOAT32);
     }
 |   COMPLEX_FLOAT64
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_COMPLEX_FLOAT64);
     }
 |   COMPLEX_REAL
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_COMPLEX_REAL);
     }
 |   VOID
     {
@@ -2295,12 +2305,12 @@ FuncQual:
     NOTHROW
     {
         DECL_1_LOC(@1);
-        $$ = newAst<DeclAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<DeclAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_NOTHROW);
     }
 |   PURE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<DeclAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<DeclAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_PURE);
     }
 |   Annot
 ;
@@ -2318,7 +2328,7 @@ Init:
     VOID
     {
         DECL_1_LOC(@1);
-        $$ = newAst<NullLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<NullLitExprAst>()->setLitLoc(locA)->setLitTk(TK_VOID);
     }
 |   NonNullLit
 ;
@@ -2432,42 +2442,42 @@ Attr:
 |   ABSTRACT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<DeclAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<DeclAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_ABSTRACT);
     }
 |   FINAL
     {
         DECL_1_LOC(@1);
-        $$ = newAst<DeclAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<DeclAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_FINAL);
     }
 |   OVERRIDE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<DeclAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<DeclAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_OVERRIDE);
     }
 |   AUTO
     {
         DECL_1_LOC(@1);
-        $$ = newAst<AutoAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<AutoAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_AUTO);
     }
 |   __GSHARED
     {
         DECL_1_LOC(@1);
-        $$ = newAst<TypeQualAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<TypeQualAttrAst>()->setKeyLoc(locA)->setKeyTk(TK___GSHARED);
     }
 |   IN
     {
         DECL_1_LOC(@1);
-        $$ = newAst<ParamDirAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<ParamDirAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_IN);
     }
 |   OUT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<ParamDirAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<ParamDirAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_OUT);
     }
 |   LAZY
     {
         DECL_1_LOC(@1);
-        $$ = newAst<EvalStrategyAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<EvalStrategyAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_LAZY);
     }
 ;
 
@@ -2476,27 +2486,27 @@ StorageClass:
     DEPRECATED
     {
         DECL_1_LOC(@1);
-        $$ = newAst<DeclAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<DeclAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_DEPRECATED);
     }
 |   STATIC
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StorageClassAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<StorageClassAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_STATIC);
     }
 |   EXTERN
     {
         DECL_1_LOC(@1);
-        $$ = newAst<LinkageAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<LinkageAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_EXTERN);
     }
 |   REF
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StorageClassAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<StorageClassAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_REF);
     }
 |   SCOPE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StorageClassAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<StorageClassAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_SCOPE);
     }
     /* TODO: Handle SYNCHRONIZED for this situation. */
 ;
@@ -2505,27 +2515,27 @@ AccessSpec:
     PRIVATE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<VisibilityAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<VisibilityAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_PRIVATE);
     }
 |   PACKAGE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<VisibilityAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<VisibilityAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_PACKAGE);
     }
 |   PROTECTED
     {
         DECL_1_LOC(@1);
-        $$ = newAst<VisibilityAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<VisibilityAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_PROTECTED);
     }
 |   PUBLIC
     {
         DECL_1_LOC(@1);
-        $$ = newAst<VisibilityAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<VisibilityAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_PUBLIC);
     }
 |   EXPORT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<VisibilityAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<VisibilityAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_EXPORT);
     }
 ;
 
@@ -2594,24 +2604,24 @@ TypeQual:
     CONST
     {
         DECL_1_LOC(@1);
-        $$ = newAst<TypeQualAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<TypeQualAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_CONST);
     }
 |   IMMUTABLE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<TypeQualAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<TypeQualAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_IMMUTABLE);
     }
 |   INOUT
     {
         /* From D docs: "The inout forms a wildcard that stands in for
            any of mutable, const, immutable, inout, or inout const". */
         DECL_1_LOC(@1);
-        $$ = newAst<TypeQualAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<TypeQualAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_INOUT);
     }
 |   SHARED
     {
         DECL_1_LOC(@1);
-        $$ = newAst<TypeQualAttrAst>()->setKeyLoc(locA);
+        $$ = newAst<TypeQualAttrAst>()->setKeyLoc(locA)->setKeyTk(TK_SHARED);
     }
 ;
 
@@ -3888,7 +3898,7 @@ CharLit:
     CHAR_LIT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<CharLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<CharLitExprAst>()->setLitLoc(locA)->setLitTk(TK_CHAR_LIT);
     }
 ;
 
@@ -3896,7 +3906,7 @@ StringLit:
     STR_LIT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StrLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<StrLitExprAst>()->setLitLoc(locA)->setLitTk(TK_STR_LIT);
     }
 ;
 
@@ -3904,12 +3914,12 @@ NumLit:
     INT_LIT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<NumLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<NumLitExprAst>()->setLitLoc(locA)->setLitTk(TK_INT_LIT);
     }
 |   FLOAT_LIT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<NumLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<NumLitExprAst>()->setLitLoc(locA)->setLitTk(TK_FLOAT_LIT);
     }
 ;
 
@@ -3917,12 +3927,12 @@ BoolLit:
     TRUE_VALUE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BoolLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<BoolLitExprAst>()->setLitLoc(locA)->setLitTk(TK_TRUE_VALUE);
     }
 |   FALSE_VALUE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BoolLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<BoolLitExprAst>()->setLitLoc(locA)->setLitTk(TK_FALSE_VALUE);
     }
 ;
 
@@ -3930,7 +3940,7 @@ PointerLit:
     NULL_VALUE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<NullLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<NullLitExprAst>()->setLitLoc(locA)->setLitTk(TK_NULL_VALUE);
     }
 ;
 
@@ -3986,52 +3996,52 @@ SpecialKeyword:
     __FILE__MACRO
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StrLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<StrLitExprAst>()->setLitLoc(locA)->setLitTk(TK___FILE__MACRO);
     }
 |   __MODULE__MACRO
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StrLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<StrLitExprAst>()->setLitLoc(locA)->setLitTk(TK___MODULE__MACRO);
     }
 |   __LINE__MACRO
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StrLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<StrLitExprAst>()->setLitLoc(locA)->setLitTk(TK___LINE__MACRO);
     }
 |   __FUNCTION__MACRO
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StrLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<StrLitExprAst>()->setLitLoc(locA)->setLitTk(TK___FUNCTION__MACRO);
     }
 |   __PRETTY_FUNCTION__MACRO
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StrLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<StrLitExprAst>()->setLitLoc(locA)->setLitTk(TK___PRETTY_FUNCTION__MACRO);
     }
 |   __TIME__MACRO
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StrLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<StrLitExprAst>()->setLitLoc(locA)->setLitTk(TK___TIME__MACRO);
     }
 |   __DATE__MACRO
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StrLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<StrLitExprAst>()->setLitLoc(locA)->setLitTk(TK___DATE__MACRO);
     }
 |   __TIMESTAMP__MACRO
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StrLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<StrLitExprAst>()->setLitLoc(locA)->setLitTk(TK___TIMESTAMP__MACRO);
     }
 |   __VERSION__MACRO
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StrLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<StrLitExprAst>()->setLitLoc(locA)->setLitTk(TK___VERSION__MACRO);
     }
 |   __VENDOR__MACRO
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StrLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<StrLitExprAst>()->setLitLoc(locA)->setLitTk(TK___VENDOR__MACRO);
     }
 ;
 
@@ -32,6 +32,21 @@ class DParsingContext : public ParsingContext
 {
 public:
     using ParsingContext::ParsingContext;
+
+    /*!
+     * Lexer state that spans rules, which is kept here since the scanner
+     * is reentrant: how deep the current nested comment is and the state
+     * to return to once an escape sequence is over.
+     */
+    int enterNestedComment() { return ++nestedCommentLevel_; }
+    int leaveNestedComment() { return --nestedCommentLevel_; }
+
+    void setEscapeReturnState(int state) { escapeReturnState_ = state; }
+    int escapeReturnState() const { return escapeReturnState_; }
+
+private:
+    int nestedCommentLevel_ { 0 };
+    int escapeReturnState_ { 0 }; // The scanner's INITIAL state.
 };
 
 } // namespace uaiso
@@ -27,15 +27,20 @@
 #define D_YYDEBUG 1
 
 #include "D/DUnit.h"
+#include "D/DAstLocator.h"
 #include "D/DParser.h"
 #include "D/DLexer.h"
 #include "D/DParsingContext.h"
 #include "Ast/Ast.h"
+#include "Ast/AstHasher.h"
+#include "Common/AllocStats.h"
 #include "Common/Error__.h"
 #include "Common/Trace__.h"
 #include "Common/Util__.h"
+#include "Parsing/GlrStats.h"
 #include "Parsing/Lexeme.h"
 #include "Parsing/LexemeMap.h"
+#include "Parsing/ScannerCache__.h"
 #include "Parsing/Token.h"
 #include "Parsing/TokenMap.h"
 #include "Parsing/Unit__.h"
@@ -45,8 +50,21 @@
 // See Flex bug (1) in 3rdPartyBugs.txt
 void D_yyset_column(int column, yyscan_t yyscanner);
 
+// Defined in the user code section of D.l
+void D_yyreset_state(yyscan_t yyscanner);
+
 using namespace uaiso;
 
+namespace {
+
+thread_local ScannerCache<DParsingContext,
+                          D_yylex_init_extra,
+                          D_yyset_extra,
+                          D_yyreset_state,
+                          D_yylex_destroy> scannerCache;
+
+} // anonymous
+
 void D_yyerror(D_YYLTYPE* yylocp,
                yyscan_t scanner,
                ParsingContext* context,
@@ -63,38 +81,51 @@ void D_yyerror(D_YYLTYPE* yylocp,
                                    yylocp->filename));
 }
 
+int D_yytrace()
+{
+    // Traces are only produced to be counted.
+    return GlrStats::isAnyAttached();
+}
+
 void DUnit::parseCore(TokenMap* tokens,
                       LexemeMap* lexs,
                       DParsingContext* context)
 {
+    AllocStats::Phase phase("parse", P->fullFileName_);
+
     P->ast_.reset(nullptr);
     context->collectLexemes(lexs);
     context->collectTokens(tokens);
-    context->collectReports(P->reports_.get());
+    context->collectReports(P->sink());
     context->setFileName(P->fullFileName_.c_str()); // Filename for Flex actions.
 
-    yyscan_t scanner = 0;
-    if (D_yylex_init_extra(context, &scanner)) {
+    yyscan_t scanner = scannerCache.acquire(context);
+    if (!scanner) {
         Error::log("Failed to initializer scanner.\n");
         return;
     }
 
+    // The buffer is always explicit, so nothing is left behind in a
+    // scanner that's reused. A new buffer also starts at line 1, column 0.
     YY_BUFFER_STATE buffState = nullptr;
     if (P->bit_.readFromFile_) {
-        D_yyset_in(P->file_, scanner);
+        buffState = D_yy_create_buffer(P->file_, YY_BUF_SIZE, scanner);
+        D_yy_switch_to_buffer(buffState, scanner);
     } else {
         buffState = D_yy_scan_bytes(P->source_->c_str(), P->source_->size(), scanner);
         D_yyset_lineno(0, scanner); // See Flex bug (2) in 3rdPartyBugs.txt
         D_yyset_column(0, scanner);
     }
 
-    //D_yydebug = 1;
     int success = !D_yyparse(scanner, context);
-    if (success)
+    if (success) {
         P->ast_.reset(context->releaseAst());
+        DAstLocator().cacheSpans(Program_Cast(P->ast_.get()));
+        AstHasher(lexs, P->fullFileName_).hashProgram(Program_Cast(P->ast_.get()));
+    }
 
     D_yy_delete_buffer(buffState, scanner);
-    D_yylex_destroy(scanner);
+    scannerCache.release(scanner);
 }
 
 void DUnit::parse(TokenMap* tokens, LexemeMap* lexs)
@@ -22,6 +22,9 @@
 /*--------------------------*/
 
 #include "D/DUnit.h"
+#include "Ast/AstLocator.h"
+#include "Parsing/Diagnostic.h"
+#include "Parsing/GlrStats.h"
 #include "Parsing/UnitTest.h"
 
 using namespace uaiso;
@@ -47,6 +50,8 @@ public:
              , &DUnitTest::testCase15
              , &DUnitTest::testCase16
              , &DUnitTest::testCase17
+             , &DUnitTest::testCase18
+             , &DUnitTest::testCase19
              )
 
     const std::string baseCode() const
@@ -268,6 +273,72 @@ public:
 
         runCore(FactoryCreator::create(LangId::D), code);
     }
+
+    void testCase18()
+    {
+        std::string code = baseCode() + R"raw(
+            void main()
+            {
+                auto p = Point(1, 2, 3);
+                writeln(p.id);
+            }
+        )raw";
+
+        GlrStats stats;
+        stats.attach();
+        runCore(FactoryCreator::create(LangId::D), code);
+        size_t splits = stats.splits();
+        size_t merges = stats.merges();
+        runCore(FactoryCreator::create(LangId::D), code);
+        stats.detach();
+
+        // Same input, same nondeterminism.
+        UAISO_EXPECT_INT_EQ(2 * splits, stats.splits());
+        UAISO_EXPECT_INT_EQ(2 * merges, stats.merges());
+        size_t deferred = 0;
+        for (const auto& rule : stats.deferredReductions())
+            deferred += rule.second;
+        UAISO_EXPECT_TRUE(!splits || deferred);
+
+        // Nothing is counted once detached.
+        runCore(FactoryCreator::create(LangId::D), code);
+        UAISO_EXPECT_INT_EQ(2 * splits, stats.splits());
+    }
+
+    void testCase19()
+    {
+        // A parse that stops within a nested comment leaves the thread's
+        // scanner in that state. When the scanner is reused, the next parse
+        // must not notice.
+        std::string code = baseCode() + R"raw(
+            void main()
+            {
+                writeln("done\n");
+            }
+        )raw";
+        std::string unfinished = baseCode() + R"raw(
+            /+ outer /+ inner "\
+        )raw";
+
+        auto fresh = runCore(FactoryCreator::create(LangId::D), code);
+        runCore(FactoryCreator::create(LangId::D), unfinished);
+        auto reused = runCore(FactoryCreator::create(LangId::D), code);
+
+        std::ostringstream freshOut;
+        AstSerializer().serializeProgram(Program_Cast(fresh->ast()), freshOut);
+        std::ostringstream reusedOut;
+        AstSerializer().serializeProgram(Program_Cast(reused->ast()), reusedOut);
+        UAISO_EXPECT_STR_EQ(freshOut.str(), reusedOut.str());
+
+        std::unique_ptr<DiagnosticReports> freshReports(fresh->releaseReports());
+        std::unique_ptr<DiagnosticReports> reusedReports(reused->releaseReports());
+        UAISO_EXPECT_INT_EQ(0, freshReports->size());
+        UAISO_EXPECT_INT_EQ(0, reusedReports->size());
+
+        auto locator = FactoryCreator::create(LangId::D)->makeAstLocator();
+        UAISO_EXPECT_INT_EQ(locator->lastLoc(fresh->ast()).lastLine_,
+                            locator->lastLoc(reused->ast()).lastLine_);
+    }
 };
 
 MAKE_CLASS_TEST(DUnit)
@@ -47,6 +47,10 @@
 #undef GO_YYDEBUG
 #endif
 #define GO_YYDEBUG 1
+
+/* GLR traces may be counted, see GlrStats. */
+#include "Parsing/GlrStats.h"
+#define YYFPRINTF uaiso::GlrStats::trace
 }
 
 %code requires {
@@ -113,6 +117,12 @@ typedef struct GO_YYLTYPE
 
 using namespace uaiso;
 
+/* Instead of the parser's global debug flag, which every thread would
+   share, traces are enabled per thread (defined along with yyerror). */
+#undef yydebug
+#define yydebug GO_yytrace()
+int GO_yytrace();
+
 void GO_yyerror(const YYLTYPE* yylloc,
                 yyscan_t scanner,
                 uaiso::ParsingContext* context,
@@ -1358,87 +1368,87 @@ BuiltinType:
     BOOL
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_BOOL);
     }
 |   INT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_INT);
     }
 |   INT8
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_INT8);
     }
 |   INT16
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_INT16);
     }
 |   INT32
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_INT32);
     }
 |   INT64
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_INT64);
     }
 |   UINT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_UINT);
     }
 |   UINT8
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_UINT8);
     }
 |   UINT16
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_UINT16);
     }
 |   UINT32
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_UINT32);
     }
 |   UINT64
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_UINT64);
     }
 |   FLOAT32
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_FLOAT32);
     }
 |   FLOAT64
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_FLOAT64);
     }
 |   COMPLEX_FLOAT64
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_COMPLEX_FLOAT64);
     }
 |   COMPLEX_REAL
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_COMPLEX_REAL);
     }
 |   BYTE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_BYTE);
     }
 |   RUNE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA);
+        $$ = newAst<BuiltinSpecAst>()->setKeyLoc(locA)->setKeyTk(TK_RUNE);
     }
 ;
 
@@ -2560,7 +2570,7 @@ CharLit:
     CHAR_LIT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<CharLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<CharLitExprAst>()->setLitLoc(locA)->setLitTk(TK_CHAR_LIT);
     }
 ;
 
@@ -2568,7 +2578,7 @@ StringLit:
     STR_LIT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<StrLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<StrLitExprAst>()->setLitLoc(locA)->setLitTk(TK_STR_LIT);
     }
 ;
 
@@ -2576,12 +2586,12 @@ NumLit:
     INT_LIT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<NumLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<NumLitExprAst>()->setLitLoc(locA)->setLitTk(TK_INT_LIT);
     }
 |   FLOAT_LIT
     {
         DECL_1_LOC(@1);
-        $$ = newAst<NumLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<NumLitExprAst>()->setLitLoc(locA)->setLitTk(TK_FLOAT_LIT);
     }
 ;
 
@@ -2589,12 +2599,12 @@ BoolLit:
     TRUE_VALUE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BoolLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<BoolLitExprAst>()->setLitLoc(locA)->setLitTk(TK_TRUE_VALUE);
     }
 |   FALSE_VALUE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<BoolLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<BoolLitExprAst>()->setLitLoc(locA)->setLitTk(TK_FALSE_VALUE);
     }
 ;
 
@@ -2602,7 +2612,7 @@ NullLit:
     NULL_VALUE
     {
         DECL_1_LOC(@1);
-        $$ = newAst<NullLitExprAst>()->setLitLoc(locA);
+        $$ = newAst<NullLitExprAst>()->setLitLoc(locA)->setLitTk(TK_NULL_VALUE);
     }
 ;
 
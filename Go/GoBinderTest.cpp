@@ -22,7 +22,9 @@
 /*--------------------------*/
 
 #include "Semantic/BinderTest.h"
+#include "Go/GoTypeSystem.h"
 #include "Semantic/Program.h"
+#include "Semantic/Snapshot.h"
 #include "Semantic/Symbol.h"
 #include "Semantic/Type.h"
 #include "Parsing/Factory.h"
@@ -203,3 +205,110 @@ void Binder::BinderTest::GoTestCase1()
     parallelForEnv.detachOuterEnv();
     UAISO_EXPECT_FALSE(parallelForEnv.isEmpty()); // Param is part of env.
 }
+
+void Binder::BinderTest::GoTestCase2()
+{
+    std::string code = R"raw(
+        package shapes
+
+        type Any interface {}
+
+        type Named interface {
+                Name() string
+        }
+
+        type Shape interface {
+                Named
+                Area(scale float64) float64
+        }
+
+        type Square struct {
+                side float64
+        }
+
+        func (s Square) Area(scale float64) float64 { return s.side * s.side * scale }
+        func (s *Square) Name() string { return "square" }
+
+        type Tagged struct {
+                Square
+                tag string
+        }
+
+        type Circle struct {
+                radius float64
+        }
+
+        func (c Circle) Area() float64 { return 3 * c.radius * c.radius }
+        func (c Circle) Name() string { return "circle" }
+    )raw";
+
+    std::unique_ptr<Program> program(core(FactoryCreator::create(LangId::Go),
+                                          code,
+                                          "/from/go/source/shapes/code.go"));
+    UAISO_EXPECT_TRUE(program);
+
+    const Ident* area = lexs_.findAnyOfIdent("Area");
+    UAISO_EXPECT_TRUE(area);
+
+    // Another file of the package declares a method of Circle.
+    std::string otherCode = R"raw(
+        package shapes
+
+        type Perimetered interface {
+                Perimeter() float64
+        }
+
+        func (c Circle) Perimeter() float64 { return 6 * c.radius }
+    )raw";
+
+    std::unique_ptr<Program> other(core(FactoryCreator::create(LangId::Go),
+                                        otherCode,
+                                        "/from/go/source/shapes/other.go"));
+    UAISO_EXPECT_TRUE(other);
+
+    Snapshot snapshot;
+    snapshot.insertOrReplace("/from/go/source/shapes/code.go", std::move(program));
+    snapshot.insertOrReplace("/from/go/source/shapes/other.go", std::move(other));
+    Environment env =
+            snapshot.packageEnv(snapshot.find("/from/go/source/shapes/code.go")->packageName());
+    auto named = [&env, this](const char* name) -> std::unique_ptr<Type> {
+        const Ident* ident = lexs_.findAnyOfIdent(name);
+        UAISO_EXPECT_TRUE(env.searchTypeDecl(ident));
+        return std::unique_ptr<Type>(new ElaborateType(ident));
+    };
+    auto ptr = [](std::unique_ptr<Type> ty) -> std::unique_ptr<Type> {
+        return std::unique_ptr<Type>(new PtrType(std::move(ty)));
+    };
+
+    // Methods carry their receiver and parameter types.
+    int methods = 0;
+    for (auto valSym : env.listValueDecls()) {
+        if (valSym->name() != area)
+            continue;
+        const Func* func = ConstFunc_Cast(valSym);
+        UAISO_EXPECT_TRUE(func->recvType());
+        ++methods;
+    }
+    UAISO_EXPECT_INT_EQ(2, methods);
+
+    GoTypeSystem typeSystem;
+    UAISO_EXPECT_TRUE(typeSystem.implements(named("Square").get(), named("Any").get(), env, snapshot));
+    UAISO_EXPECT_FALSE(typeSystem.implements(named("Square").get(), named("Named").get(), env, snapshot));
+    UAISO_EXPECT_TRUE(typeSystem.implements(ptr(named("Square")).get(), named("Named").get(), env, snapshot));
+    UAISO_EXPECT_FALSE(typeSystem.implements(named("Square").get(), named("Shape").get(), env, snapshot));
+    UAISO_EXPECT_TRUE(typeSystem.implements(ptr(named("Square")).get(), named("Shape").get(), env, snapshot));
+    UAISO_EXPECT_FALSE(typeSystem.implements(named("Tagged").get(), named("Shape").get(), env, snapshot));
+    UAISO_EXPECT_TRUE(typeSystem.implements(ptr(named("Tagged")).get(), named("Shape").get(), env, snapshot));
+    UAISO_EXPECT_TRUE(typeSystem.implements(named("Circle").get(), named("Named").get(), env, snapshot));
+    // Area has a different signature.
+    UAISO_EXPECT_FALSE(typeSystem.implements(named("Circle").get(), named("Shape").get(), env, snapshot));
+    UAISO_EXPECT_TRUE(typeSystem.implements(named("Shape").get(), named("Named").get(), env, snapshot));
+    UAISO_EXPECT_TRUE(typeSystem.implements(named("Circle").get(), named("Perimetered").get(), env, snapshot));
+    UAISO_EXPECT_FALSE(typeSystem.implements(named("Square").get(), named("Perimetered").get(), env, snapshot));
+
+    // Memoized results are answered again.
+    UAISO_EXPECT_TRUE(snapshot.conformance(env.searchTypeDecl(lexs_.findAnyOfIdent("Tagged")),
+                                           true,
+                                           env.searchTypeDecl(lexs_.findAnyOfIdent("Shape"))).first);
+    UAISO_EXPECT_TRUE(typeSystem.implements(ptr(named("Tagged")).get(), named("Shape").get(), env, snapshot));
+}
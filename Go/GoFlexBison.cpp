@@ -67,7 +67,7 @@ VarGroupDeclAst* turnExprsIntoVarGroupDecl(ExprAstList* exprs)
 void constifyVarGroupDecl(DeclAst* decl, const SourceLoc& loc)
 {
     auto group = static_cast<VarGroupDeclAst*>(decl);
-    auto qual = (new TypeQualAttrAst)->setKeyLoc(loc);
+    auto qual = (new TypeQualAttrAst)->setKeyLoc(loc)->setKeyTk(TK_CONST);
     auto spec = (new DecoratedSpecAst)->addAttr(qual)->setSpec(group->spec_.release());
     group->spec_.reset(spec);
     group->setAllocScheme(AllocScheme::CompileTime);
@@ -39,3 +39,8 @@ GoLang::ImportMechanism GoLang::importMechanism() const
 {
     return PerPackage;
 }
+
+GoLang::MemberOrder GoLang::memberOrder() const
+{
+    return Promotion;
+}
@@ -36,6 +36,8 @@ public:
     Structure structure() const override;
 
     ImportMechanism importMechanism() const override;
+
+    MemberOrder memberOrder() const override;
 };
 
 } // namespace uaiso
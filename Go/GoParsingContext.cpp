@@ -30,6 +30,7 @@ using namespace uaiso;
 
 GoParsingContext::GoParsingContext()
     : mayAddSemicolon_(false)
+    , escapeReturnState_(0) // The scanner's INITIAL state.
 {}
 
 int GoParsingContext::interceptRawToken(int token)
@@ -38,8 +38,16 @@ public:
 
     virtual int interceptRawToken(int token) override;
 
+    /*!
+     * The state the lexer returns to once an escape sequence is over, kept
+     * here since the scanner is reentrant.
+     */
+    void setEscapeReturnState(int state) { escapeReturnState_ = state; }
+    int escapeReturnState() const { return escapeReturnState_; }
+
 private:
     bool mayAddSemicolon_;
+    int escapeReturnState_;
 };
 
 } // namespace uaiso
@@ -159,3 +159,66 @@ void TypeChecker::TypeCheckerTest::GoTestCase8()
             std::vector<Diagnostic::Code>(),
             std::make_pair("", Type::Kind::Empty));
 }
+
+void TypeChecker::TypeCheckerTest::GoTestCase9()
+{
+    // Fields promoted from two embedded fields at the same depth.
+    std::string code = R"raw(
+        package main
+        type A struct { x int }
+        type B struct { x int }
+        type C struct {
+            A
+            B
+        }
+        func main() {
+            var c C
+            c.A.x
+            c.x
+        }
+    )raw";
+
+    auto expected = { Diagnostic::AmbiguousSelector };
+    runCore(FactoryCreator::create(LangId::Go), code, "/from/go/tour/code.go",
+            expected,
+            std::make_pair("", Type::Kind::Empty));
+}
+
+void TypeChecker::TypeCheckerTest::GoTestCase10()
+{
+    // A long chain of binary expressions, with an error at its very end.
+    std::string code = R"raw(
+        package main
+        func main() {
+            var s string
+            var n int
+            n = 1)raw";
+    for (int i = 0; i < 20000; ++i)
+        code += (i % 2) ? " + 1" : " - 1";
+    code += R"raw( + s
+        }
+    )raw";
+
+    auto expected = { Diagnostic::NumericValueExpected };
+    runCore(FactoryCreator::create(LangId::Go), code, "/from/go/tour/code.go",
+            expected,
+            std::make_pair("", Type::Kind::Empty));
+}
+
+void TypeChecker::TypeCheckerTest::GoTestCase11()
+{
+    // An unresolved name accessed as a namespace isn't diagnosed, its
+    // import may be unresolved; an unresolved name by itself is.
+    std::string code = R"raw(
+        package main
+        func main() {
+            var x = nothing.y
+            var z = other
+        }
+    )raw";
+
+    auto expected = { Diagnostic::UndeclaredIdentifier };
+    runCore(FactoryCreator::create(LangId::Go), code, "/from/go/tour/code.go",
+            expected,
+            std::make_pair("", Type::Kind::Empty));
+}
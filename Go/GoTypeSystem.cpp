@@ -22,6 +22,19 @@
 /*--------------------------*/
 
 #include "Go/GoTypeSystem.h"
+#include "Go/GoLang.h"
+#include "Semantic/Environment.h"
+#include "Semantic/Program.h"
+#include "Semantic/Snapshot.h"
+#include "Semantic/Symbol.h"
+#include "Semantic/SymbolCast.h"
+#include "Semantic/Type.h"
+#include "Semantic/TypeCast.h"
+#include "Common/Assert.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
 
 using namespace uaiso;
 
@@ -29,3 +42,232 @@ bool GoTypeSystem::isStructural() const
 {
     return true;
 }
+
+namespace {
+
+void combineHash(size_t& seed, size_t value)
+{
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+/*!
+ * \brief shapeHash
+ *
+ * Hash the structure of a type as it's spelled in a signature. Named types
+ * are distinguished by name only, they're not resolved.
+ */
+size_t shapeHash(const Type* ty)
+{
+    if (!ty)
+        return 0;
+
+    size_t h = std::hash<int>()(static_cast<int>(ty->kind()));
+    switch (ty->kind()) {
+    case Type::Kind::Elaborate:
+        combineHash(h, std::hash<const void*>()(ConstElaborateType_Cast(ty)->name()));
+        break;
+
+    case Type::Kind::Array:
+    case Type::Kind::Chan:
+    case Type::Kind::Ptr:
+    case Type::Kind::Subrange:
+        combineHash(h, shapeHash(ConstOpaqueType_Cast(ty)->baseType()));
+        break;
+
+    default:
+        break;
+    }
+    return h;
+}
+
+/*!
+ * \brief fingerprint
+ *
+ * A method's fingerprint combines its name with the shape of its signature.
+ */
+size_t fingerprint(const Func* func)
+{
+    size_t h = std::hash<const void*>()(func->name());
+    const auto& params = func->paramsType();
+    combineHash(h, params.size());
+    for (auto param : params)
+        combineHash(h, shapeHash(param));
+    combineHash(h, shapeHash(func->valueType()));
+    return h;
+}
+
+const TypeDecl* namedTypeDecl(const Type* ty, Environment env)
+{
+    if (!ty || ty->kind() != Type::Kind::Elaborate)
+        return nullptr;
+    return env.searchTypeDecl(ConstElaborateType_Cast(ty)->name());
+}
+
+const RecordType* interfaceType(const TypeDecl* tyDecl)
+{
+    if (!tyDecl || !tyDecl->type() || tyDecl->type()->kind() != Type::Kind::Record)
+        return nullptr;
+    auto recTy = ConstRecordType_Cast(tyDecl->type());
+    if (recTy->variety() != RecordVariety::Interface)
+        return nullptr;
+    return recTy;
+}
+
+void collectInterfaceMethods(const RecordType* ifaceTy,
+                             const Snapshot& snapshot,
+                             std::vector<size_t>& fingerprints)
+{
+    static const GoLang lang;
+    for (auto decl : *ifaceTy->members(&lang, snapshot)) {
+        if (decl->kind() == Symbol::Kind::Func)
+            fingerprints.push_back(fingerprint(ConstFunc_Cast(decl)));
+    }
+}
+
+void sortAndUnique(std::vector<size_t>& fingerprints)
+{
+    std::sort(fingerprints.begin(), fingerprints.end());
+    fingerprints.erase(std::unique(fingerprints.begin(), fingerprints.end()),
+                       fingerprints.end());
+}
+
+Environment rootEnv(Environment env)
+{
+    while (!env.isRootEnv())
+        env = env.outerEnv();
+    return env;
+}
+
+/*!
+ * \brief methodEnv
+ *
+ * Methods of a type may be declared in any file of its package. When
+ * the type's defining program is part of the snapshot, the package's
+ * environment is searched. Otherwise only the root of \a env is seen,
+ * which is reported through \a complete so the result isn't memoized.
+ */
+Environment methodEnv(const TypeDecl* tyDecl, Environment env,
+                      const Snapshot& snapshot, bool& complete)
+{
+    auto prog = snapshot.find(tyDecl->sourceLoc().fileName_);
+    if (prog && prog->env().searchTypeDecl(tyDecl->name()) == tyDecl)
+        return snapshot.packageEnv(prog->packageName());
+
+    complete = false;
+    return rootEnv(env);
+}
+
+void collectMethods(const TypeDecl* tyDecl, bool indirect, Environment env,
+                    const Snapshot& snapshot,
+                    std::vector<const TypeDecl*>& visited,
+                    std::vector<size_t>& fingerprints,
+                    bool& complete)
+{
+    if (std::find(visited.begin(), visited.end(), tyDecl) != visited.end())
+        return;
+    visited.push_back(tyDecl);
+
+    if (auto ifaceTy = interfaceType(tyDecl)) {
+        collectInterfaceMethods(ifaceTy, snapshot, fingerprints);
+        return;
+    }
+
+    // Methods are declared at package level. A type T has the methods
+    // whose receiver is T, while *T also has those whose receiver is *T.
+    for (auto valDecl : methodEnv(tyDecl, env, snapshot, complete).listValueDecls()) {
+        if (valDecl->kind() != Symbol::Kind::Func)
+            continue;
+        auto func = ConstFunc_Cast(valDecl);
+        const Type* recvTy = func->recvType();
+        if (!recvTy)
+            continue;
+        if (recvTy->kind() == Type::Kind::Ptr) {
+            if (!indirect)
+                continue;
+            recvTy = ConstOpaqueType_Cast(recvTy)->baseType();
+        }
+        if (recvTy && recvTy->kind() == Type::Kind::Elaborate
+                && ConstElaborateType_Cast(recvTy)->name() == tyDecl->name()) {
+            fingerprints.push_back(fingerprint(func));
+        }
+    }
+
+    // Methods of embedded fields are promoted.
+    if (!tyDecl->type() || tyDecl->type()->kind() != Type::Kind::Record)
+        return;
+    auto recTy = ConstRecordType_Cast(tyDecl->type());
+    for (auto base : recTy->bases()) {
+        if (auto baseDecl = recTy->env().searchTypeDecl(base->name())) {
+            collectMethods(baseDecl, indirect, env, snapshot, visited,
+                           fingerprints, complete);
+        }
+    }
+}
+
+} // anonymous
+
+bool GoTypeSystem::implements(const Type* ty, const Type* iface,
+                              Environment env, Snapshot snapshot) const
+{
+    UAISO_ASSERT(ty && iface, return false);
+
+    const TypeDecl* ifaceDecl = namedTypeDecl(iface, env);
+    const RecordType* ifaceTy = nullptr;
+    if (ifaceDecl)
+        ifaceTy = interfaceType(ifaceDecl);
+    else if (iface->kind() == Type::Kind::Record
+             && ConstRecordType_Cast(iface)->variety() == RecordVariety::Interface)
+        ifaceTy = ConstRecordType_Cast(iface);
+    if (!ifaceTy)
+        return false;
+
+    bool indirect = false;
+    if (ty->kind() == Type::Kind::Ptr) {
+        indirect = true;
+        ty = ConstPtrType_Cast(ty)->baseType();
+    }
+    const TypeDecl* tyDecl = namedTypeDecl(ty, env);
+
+    if (tyDecl && ifaceDecl) {
+        auto known = snapshot.conformance(tyDecl, indirect, ifaceDecl);
+        if (known.first)
+            return known.second;
+    }
+
+    std::vector<size_t> required;
+    collectInterfaceMethods(ifaceTy, snapshot, required);
+    sortAndUnique(required);
+
+    // Every type satisfies the empty interface, but an unnamed type has
+    // no methods to satisfy anything else.
+    if (required.empty())
+        return true;
+    if (!tyDecl)
+        return false;
+
+    // A method set is memoized only when it was collected from the
+    // package environments, which don't depend on the given \a env.
+    bool complete = true;
+    auto provided = snapshot.methodSet(tyDecl, indirect);
+    if (!provided) {
+        std::vector<const TypeDecl*> visited;
+        std::vector<size_t> fingerprints;
+        collectMethods(tyDecl, indirect, env, snapshot, visited, fingerprints,
+                       complete);
+        sortAndUnique(fingerprints);
+        if (complete) {
+            provided = snapshot.memoizeMethodSet(tyDecl, indirect,
+                                                 std::move(fingerprints));
+        } else {
+            provided = std::make_shared<const std::vector<size_t>>(
+                        std::move(fingerprints));
+        }
+    }
+
+    bool conforms = std::includes(provided->begin(), provided->end(),
+                                  required.begin(), required.end());
+    if (ifaceDecl && complete)
+        snapshot.memoizeConformance(tyDecl, indirect, ifaceDecl, conforms);
+
+    return conforms;
+}
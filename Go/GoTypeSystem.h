@@ -32,6 +32,9 @@ class UAISO_API GoTypeSystem final : public TypeSystem
 {
 public:
     bool isStructural() const override;
+
+    bool implements(const Type* ty, const Type* iface,
+                    Environment env, Snapshot snapshot) const override;
 };
 
 } // namespace uaiso
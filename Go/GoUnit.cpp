@@ -27,14 +27,19 @@
 #define GO_YYDEBUG 1
 
 #include "Go/GoUnit.h"
+#include "Go/GoAstLocator.h"
 #include "Go/GoParser.h"
 #include "Go/GoLexer.h"
 #include "Go/GoParsingContext.h"
 #include "Ast/Ast.h"
+#include "Ast/AstHasher.h"
+#include "Common/AllocStats.h"
 #include "Common/Error__.h"
 #include "Common/Trace__.h"
 #include "Common/Util__.h"
 #include "Parsing/Diagnostic.h"
+#include "Parsing/GlrStats.h"
+#include "Parsing/ScannerCache__.h"
 #include "Parsing/Token.h"
 #include "Parsing/Unit__.h"
 
@@ -43,8 +48,21 @@
 // See Flex bug (1) in 3rdPartyBugs.txt
 void GO_yyset_column(int column, yyscan_t yyscanner);
 
+// Defined in the user code section of Go.l
+void GO_yyreset_state(yyscan_t yyscanner);
+
 using namespace uaiso;
 
+namespace {
+
+thread_local ScannerCache<GoParsingContext,
+                          GO_yylex_init_extra,
+                          GO_yyset_extra,
+                          GO_yyreset_state,
+                          GO_yylex_destroy> scannerCache;
+
+} // anonymous
+
 void GO_yyerror(const GO_YYLTYPE* yylocp,
                 yyscan_t,
                 ParsingContext* context,
@@ -59,38 +77,51 @@ void GO_yyerror(const GO_YYLTYPE* yylocp,
                                    yylocp->filename));
 }
 
+int GO_yytrace()
+{
+    // Traces are only produced to be counted.
+    return GlrStats::isAnyAttached();
+}
+
 void GoUnit::parseCore(TokenMap* tokens,
                        LexemeMap* lexs,
                        GoParsingContext* context)
 {
+    AllocStats::Phase phase("parse", P->fullFileName_);
+
     P->ast_.reset(nullptr);
     context->collectLexemes(lexs);
     context->collectTokens(tokens);
-    context->collectReports(P->reports_.get());
+    context->collectReports(P->sink());
     context->setFileName(P->fullFileName_.c_str()); // Filename for Flex actions.
 
-    yyscan_t scanner = 0;
-    if (GO_yylex_init_extra(context, &scanner)) {
+    yyscan_t scanner = scannerCache.acquire(context);
+    if (!scanner) {
         Error::log("Failed to initializer scanner.\n");
         return;
     }
 
+    // The buffer is always explicit, so nothing is left behind in a
+    // scanner that's reused. A new buffer also starts at line 1, column 0.
     YY_BUFFER_STATE buffState = nullptr;
     if (P->bit_.readFromFile_) {
-        GO_yyset_in(P->file_, scanner);
+        buffState = GO_yy_create_buffer(P->file_, YY_BUF_SIZE, scanner);
+        GO_yy_switch_to_buffer(buffState, scanner);
     } else {
         buffState = GO_yy_scan_bytes(P->source_->c_str(), P->source_->size(), scanner);
         GO_yyset_lineno(0, scanner); // See Flex bug (2) in 3rdPartyBugs.txt
         GO_yyset_column(0, scanner);
     }
 
-    //GO_yydebug = 1;
     int success = !GO_yyparse(scanner, context);
-    if (success)
+    if (success) {
         P->ast_.reset(context->releaseAst());
+        GoAstLocator().cacheSpans(Program_Cast(P->ast_.get()));
+        AstHasher(lexs, P->fullFileName_).hashProgram(Program_Cast(P->ast_.get()));
+    }
 
     GO_yy_delete_buffer(buffState, scanner);
-    GO_yylex_destroy(scanner);
+    scannerCache.release(scanner);
 }
 
 void GoUnit::parse(TokenMap* tokens, LexemeMap* lexs)
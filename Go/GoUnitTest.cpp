@@ -22,6 +22,8 @@
 /*--------------------------*/
 
 #include "Go/GoUnit.h"
+#include "Ast/AstLocator.h"
+#include "Parsing/Diagnostic.h"
 #include "Parsing/UnitTest.h"
 
 using namespace uaiso;
@@ -61,6 +63,7 @@ public:
              , &GoUnitTest::testCase29
              , &GoUnitTest::testCase30
              , &GoUnitTest::testCase31
+             , &GoUnitTest::testCase32
              )
 
     const std::string baseCode() const
@@ -438,6 +441,42 @@ public:
 
         runCore(FactoryCreator::create(LangId::Go), code);
     }
+
+    void testCase32()
+    {
+        // A parse that stops within an escape sequence leaves the thread's
+        // scanner in that state. When the scanner is reused, the next parse
+        // must not notice.
+        std::string code = R"raw(
+            package main
+            func main() {
+                s := "done\n"
+            }
+        )raw";
+        std::string unfinished = R"raw(
+            package main
+            var s = "\
+        )raw";
+
+        auto fresh = runCore(FactoryCreator::create(LangId::Go), code);
+        runCore(FactoryCreator::create(LangId::Go), unfinished);
+        auto reused = runCore(FactoryCreator::create(LangId::Go), code);
+
+        std::ostringstream freshOut;
+        AstSerializer().serializeProgram(Program_Cast(fresh->ast()), freshOut);
+        std::ostringstream reusedOut;
+        AstSerializer().serializeProgram(Program_Cast(reused->ast()), reusedOut);
+        UAISO_EXPECT_STR_EQ(freshOut.str(), reusedOut.str());
+
+        std::unique_ptr<DiagnosticReports> freshReports(fresh->releaseReports());
+        std::unique_ptr<DiagnosticReports> reusedReports(reused->releaseReports());
+        UAISO_EXPECT_INT_EQ(0, freshReports->size());
+        UAISO_EXPECT_INT_EQ(0, reusedReports->size());
+
+        auto locator = FactoryCreator::create(LangId::Go)->makeAstLocator();
+        UAISO_EXPECT_INT_EQ(locator->lastLoc(fresh->ast()).lastLine_,
+                            locator->lastLoc(reused->ast()).lastLine_);
+    }
 };
 
 MAKE_CLASS_TEST(GoUnit)
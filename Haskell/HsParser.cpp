@@ -1293,36 +1293,37 @@ Parser::Expr HsParser::parseIntLit()
 {
     UAISO_ASSERT(ahead_ == TK_INT_LIT, return Expr());
     consumeToken();
-    return NumLitExprAst::create(prevLoc_, NumLitVariety::IntFormat);
+    return NumLitExprAst::create(prevLoc_, TK_INT_LIT, NumLitVariety::IntFormat);
 }
 
 Parser::Expr HsParser::parseFloatLit()
 {
     UAISO_ASSERT(ahead_ == TK_FLOAT_LIT, return Expr());
     consumeToken();
-    return NumLitExprAst::create(prevLoc_, NumLitVariety::FloatFormat);
+    return NumLitExprAst::create(prevLoc_, TK_FLOAT_LIT, NumLitVariety::FloatFormat);
 }
 
 Parser::Expr HsParser::parseStrLit()
 {
     UAISO_ASSERT(ahead_ == TK_STR_LIT, return Expr());
     consumeToken();
-    return StrLitExprAst::create(prevLoc_);
+    return StrLitExprAst::create(prevLoc_, TK_STR_LIT);
 }
 
 Parser::Expr HsParser::parseCharLit()
 {
     UAISO_ASSERT(ahead_ == TK_CHAR_LIT, return Expr());
     consumeToken();
-    return CharLitExprAst::create(prevLoc_);
+    return CharLitExprAst::create(prevLoc_, TK_CHAR_LIT);
 }
 
 Parser::Expr HsParser::parseBoolLit()
 {
     UAISO_ASSERT(ahead_ == TK_TRUE_VALUE
                  || ahead_ == TK_FALSE_VALUE, return Expr());
+    auto tk = ahead_;
     consumeToken();
-    return BoolLitExprAst::create(prevLoc_);
+    return BoolLitExprAst::create(prevLoc_, tk);
 }
 
 Parser::Expr HsParser::finishListOrListComOrArithSeq()
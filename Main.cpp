@@ -24,8 +24,10 @@
 #include "Ast/Ast.h"
 #include "Ast/AstVisitor.h"
 #include "Ast/AstDumper.h"
+#include "Common/AllocStats.h"
 #include "Common/Assert.h"
 #include "Common/FileInfo.h"
+#include "Common/LatencyStats.h"
 #include "Common/Test.h"
 #include "D/DIncrementalLexer.h"
 #include "D/DSanitizer.h"
@@ -37,44 +39,63 @@
 #include "Haskell/HsParser.h"
 #include "Parsing/Factory.h"
 #include "Parsing/LexemeMap.h"
+#include "Parsing/Outliner.h"
 #include "Parsing/TokenMap.h"
 #include "Parsing/Unit.h"
 #include "Python/PyLexer.h"
 #include "Python/PyParser.h"
 #include "Semantic/Binder.h"
 #include "Semantic/CompletionProposer.h"
+#include "Semantic/CompletionSession.h"
 #include "Semantic/CompletionTest.h"
 #include "Semantic/Environment.h"
 #include "Semantic/ImportResolver.h"
+#include "Semantic/Manager.h"
 #include "Semantic/Program.h"
 #include "Semantic/Sanitizer.h"
+#include "Semantic/SessionReplayer.h"
 #include "Semantic/Snapshot.h"
 #include "Semantic/Symbol.h"
 #include "Semantic/Type.h"
 #include "Semantic/TypeChecker.h"
 #include "StringUtils/string.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <fstream>
+#include <iostream>
+#include <map>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 using namespace uaiso;
 
 /*!
- * Read searchs paths to feed the tests. The absolute path of the test
- * data should have been configured (by a Python script) in the first build.
+ * Read the absolute path of the test data, which should have been
+ * configured (by a Python script) in the first build.
  */
-std::vector<std::string> readSearchPaths()
+std::string readTestDataPath()
 {
-    using Paths = std::vector<std::string>;
-
     std::ifstream ifs("TestDataAbsPath.txt");
     if (!ifs.is_open())
-        return Paths();
+        return std::string();
 
     std::string path;
-    if (!std::getline(ifs, path))
+    std::getline(ifs, path);
+    return path;
+}
+
+/*!
+ * Read searchs paths to feed the tests.
+ */
+std::vector<std::string> readSearchPaths()
+{
+    using Paths = std::vector<std::string>;
+
+    std::string path = readTestDataPath();
+    if (path.empty())
         return Paths();
 
     Paths paths;
@@ -84,24 +105,81 @@ std::vector<std::string> readSearchPaths()
     return paths;
 }
 
+/*!
+ * Replay recorded editor sessions (by default, the canonical ones of the
+ * test data) a few times each and write the latencies as JSON.
+ */
+int replaySessions(const std::string& latenciesFileName,
+                   std::vector<std::string> sessionFileNames)
+{
+    const int rounds = 5;
+
+    std::string dataPath = readTestDataPath();
+    if (sessionFileNames.empty()) {
+        for (auto name : { "GoInterfaces", "PyFibo", "PyRandom" })
+            sessionFileNames.push_back(dataPath + "/Sessions/" + name + ".session");
+    }
+
+    LatencyStats stats;
+    stats.attach();
+    int failed = 0;
+    for (const auto& fileName : sessionFileNames) {
+        std::ifstream ifs(fileName);
+        SessionReplayer replayer;
+        replayer.setDataDir(dataPath);
+        for (const auto& path : readSearchPaths())
+            replayer.addSearchPath(path);
+        if (!ifs.is_open() || !replayer.load(ifs)) {
+            std::cerr << "cannot load session " << fileName << " (line "
+                      << replayer.errorLine() << ")" << std::endl;
+            ++failed;
+            continue;
+        }
+        for (int i = 0; i < rounds; ++i) {
+            if (!replayer.replay(&stats)) {
+                std::cerr << "cannot replay session " << fileName << std::endl;
+                ++failed;
+                break;
+            }
+        }
+    }
+    stats.detach();
+
+    std::ofstream ofs(latenciesFileName);
+    stats.writeJson(ofs);
+
+    return failed ? 1 : 0;
+}
+
+CALL_CLASS_TEST(AllocStats)
 CALL_CLASS_TEST(Binder)
 CALL_CLASS_TEST(DIncrementalLexer)
 CALL_CLASS_TEST(DUnit)
 CALL_CLASS_TEST(CompletionProposer)
+CALL_CLASS_TEST(CompletionSession)
 CALL_CLASS_TEST(Environment)
 CALL_CLASS_TEST(FileInfo)
 CALL_CLASS_TEST(GoIncrementalLexer)
 CALL_CLASS_TEST(GoUnit)
 CALL_CLASS_TEST(HsLexer)
 CALL_CLASS_TEST(HsParser)
+CALL_CLASS_TEST(LatencyStats)
+CALL_CLASS_TEST(Outliner)
 CALL_CLASS_TEST(PyLexer)
 CALL_CLASS_TEST(PyParser)
+CALL_CLASS_TEST(SessionReplayer)
 CALL_CLASS_TEST(TypeChecker)
 
+namespace uaiso { void test_DiagnosticFilter(); }
+namespace uaiso { void test_Manager(); }
+
 class WorkflowTest : public Test
 {
 public:
-    TEST_RUN(WorkflowTest, &WorkflowTest::testAll)
+    TEST_RUN(WorkflowTest
+             , &WorkflowTest::testAll
+             , &WorkflowTest::testAllConcurrently
+             )
 
     WorkflowTest()
         : debug_(false)
@@ -121,6 +199,68 @@ public:
         }
     }
 
+    /*!
+     * Process the corpus on several threads, which share a manager (per
+     * language) and its maps. Build with SANITIZE_THREAD to check for races.
+     */
+    void testAllConcurrently()
+    {
+        if (singlePass_)
+            return;
+
+        struct PerLang
+        {
+            std::unique_ptr<Factory> factory_;
+            TokenMap tokens_;
+            LexemeMap lexs_;
+            Snapshot snapshot_;
+            Manager manager_;
+        };
+        std::map<LangId, std::unique_ptr<PerLang>> langs;
+        for (auto langId : { LangId::D, LangId::Go, LangId::Py }) {
+            std::unique_ptr<PerLang> lang(new PerLang);
+            lang->factory_ = FactoryCreator::create(langId);
+            lang->manager_.config(lang->factory_.get(), &lang->tokens_,
+                                  &lang->lexs_, lang->snapshot_);
+            langs[langId] = std::move(lang);
+        }
+        auto langOf = [] (const std::string& fileName) {
+            if (str::ends_with(fileName, ".d"))
+                return LangId::D;
+            if (str::ends_with(fileName, ".go"))
+                return LangId::Go;
+            return LangId::Py;
+        };
+
+        std::atomic<size_t> next { 0 };
+        std::atomic<size_t> failed { 0 };
+        auto work = [&] () {
+            for (size_t i = next++; i < testFiles_.size(); i = next++) {
+                const std::string& fileName = testFiles_[i];
+                FILE* file = fopen(fileName.c_str(), "r");
+                if (!file) {
+                    ++failed;
+                    continue;
+                }
+                auto unit = langs[langOf(fileName)]->manager_.process(file, fileName);
+                std::unique_ptr<DiagnosticReports> reports(unit->releaseReports());
+                if (!unit->ast() || reports->size())
+                    ++failed;
+            }
+        };
+
+        unsigned threadCnt = std::min(8u, std::max(2u, std::thread::hardware_concurrency()));
+        std::vector<std::thread> threads;
+        for (unsigned i = 0; i < threadCnt; ++i)
+            threads.emplace_back(work);
+        for (auto& thread : threads)
+            thread.join();
+
+        UAISO_EXPECT_INT_EQ(0, failed);
+        for (const auto& fileName : testFiles_)
+            UAISO_EXPECT_TRUE(langs[langOf(fileName)]->snapshot_.find(fileName));
+    }
+
     void testParse()
     {
         std::cout << fileName_ << std::endl;
@@ -378,29 +518,58 @@ public:
 
 int main(int argc, char* argv[])
 {
+    // Editor sessions are replayed instead of running the tests.
+    if (argc > 2 && !strcmp(argv[1], "-r"))
+        return replaySessions(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+
     WorkflowTest workflowTest;
     if (argc > 1 && !strcmp(argv[1], "-d")) {
         workflowTest.debug_ = true;
         --argc;
         ++argv;
     }
+    // Latencies of the workflow, per operation, are written as JSON.
+    std::unique_ptr<LatencyStats> latencyStats;
+    std::string latenciesFileName;
+    if (argc > 2 && !strcmp(argv[1], "-l")) {
+        latencyStats.reset(new LatencyStats);
+        latenciesFileName = argv[2];
+        argc -= 2;
+        argv += 2;
+    }
     if (argc > 1) {
         workflowTest.singlePass_ = true;
         workflowTest.fileName_ = argv[1];
     }
 
+    if (latencyStats)
+        latencyStats->attach();
+
     workflowTest.run();
 
+    if (latencyStats) {
+        latencyStats->detach();
+        std::ofstream ofs(latenciesFileName);
+        latencyStats->writeJson(ofs);
+    }
+
     if (!workflowTest.singlePass_) {
+        test_AllocStats();
         test_FileInfo();
+        test_LatencyStats();
         test_Environment();
         test_Binder();
         test_TypeChecker();
         test_CompletionProposer();
+        test_Manager();
+        test_CompletionSession();
+        test_SessionReplayer();
         test_DIncrementalLexer();
         test_DUnit();
         test_GoIncrementalLexer();
         test_GoUnit();
+        test_DiagnosticFilter();
+        test_Outliner();
         test_PyLexer();
         test_PyParser();
         test_HsLexer();
@@ -27,6 +27,7 @@
 #include "Parsing/TokenMap.h"
 #include "Common/LineCol.h"
 #include <iostream>
+#include <mutex>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -43,6 +44,10 @@ struct DataIndex
 
     Data data_;
     FileIndex fileIndex_;
+
+    // Maps are shared by parses of different files, which may run
+    // concurrently.
+    mutable std::mutex mutex_;
 };
 
 } // anonymous
@@ -113,10 +118,11 @@ findDataIt(const std::string& spell,
            const DataIndex<std::unique_ptr<Lexeme>>::Data& data)
 {
     // A hack to allow looking it up without actually allocating a new value.
-    static char local[sizeof(ValueT)];
+    // The probe lives on the stack, so lookups may run concurrently.
+    alignas(ValueT) char local[sizeof(ValueT)];
     std::unique_ptr<Lexeme> helper(new (local) ValueT(spell));
     auto it = data.find(helper);
-    helper.release();
+    static_cast<ValueT*>(helper.release())->~ValueT();
 
     return it;
 }
@@ -128,6 +134,8 @@ const ValueT* LexemeMap::insertOrFind(const std::string& spell,
                                       const std::string& fullFileName,
                                       const LineCol& lineCol)
 {
+    std::lock_guard<std::mutex> lock(P->mutex_);
+
     auto &byFile = P->fileIndex_[fullFileName];
     if (!byFile) {
         byFile.reset(new DataIndex<std::unique_ptr<Lexeme>>::LineColIndex);
@@ -153,6 +161,8 @@ template <class ValueT>
 const ValueT* LexemeMap::findAt(const std::string& fullFileName,
                                 const LineCol& lineCol) const
 {
+    std::lock_guard<std::mutex> lock(P->mutex_);
+
     auto byFileIt = P->fileIndex_.find(fullFileName);
     if (byFileIt == P->fileIndex_.end()
             || !byFileIt->second) {
@@ -169,6 +179,8 @@ const ValueT* LexemeMap::findAt(const std::string& fullFileName,
 template <class ValueT>
 const ValueT* LexemeMap::findAnyOf(const std::string& spell) const
 {
+    std::lock_guard<std::mutex> lock(P->mutex_);
+
     auto valIt = findDataIt<ValueT>(spell, P->data_);
     if (valIt == P->data_.end())
         return nullptr;
@@ -181,6 +193,7 @@ LexemeMap::list(const std::string& fullFileName) const
 {
     std::vector<std::tuple<const ValueT*, LineCol>> v;
 
+    std::lock_guard<std::mutex> lock(P->mutex_);
     auto byFileIt = P->fileIndex_.find(fullFileName);
     if (byFileIt == P->fileIndex_.end() || !byFileIt->second)
         return v;
@@ -196,13 +209,17 @@ LexemeMap::list(const std::string& fullFileName) const
 
 void LexemeMap::clear()
 {
-    P->data_.clear();
-    P->fileIndex_.clear();
+    {
+        std::lock_guard<std::mutex> lock(P->mutex_);
+        P->data_.clear();
+        P->fileIndex_.clear();
+    }
     insertPredefined();
 }
 
 void LexemeMap::clear(const std::string& fullFileName)
 {
+    std::lock_guard<std::mutex> lock(P->mutex_);
     auto byFileIt = P->fileIndex_.find(fullFileName);
     if (byFileIt != P->fileIndex_.end())
         byFileIt->second->clear();
@@ -258,6 +275,8 @@ Token TokenMap::insertOrFind(int tk,
                              const std::string& file,
                              const LineCol& lineCol)
 {
+    std::lock_guard<std::mutex> lock(P->mutex_);
+
     auto &byFile = P->fileIndex_[file];
     if (!byFile) {
         byFile.reset(new DataIndex<int>::LineColIndex);
@@ -281,6 +300,8 @@ Token TokenMap::insertOrFind(int tk,
 Token TokenMap::findAt(const std::string& fullFileName,
                        const LineCol& lineCol) const
 {
+    std::lock_guard<std::mutex> lock(P->mutex_);
+
     auto byFileIt = P->fileIndex_.find(fullFileName);
     if (byFileIt == P->fileIndex_.end() || !byFileIt->second)
         return Token::TK_INVALID;
@@ -294,12 +315,14 @@ Token TokenMap::findAt(const std::string& fullFileName,
 
 void TokenMap::clear()
 {
+    std::lock_guard<std::mutex> lock(P->mutex_);
     P->data_.clear();
     P->fileIndex_.clear();
 }
 
 void TokenMap::clear(const std::string& fullFileName)
 {
+    std::lock_guard<std::mutex> lock(P->mutex_);
     auto infoIt = P->fileIndex_.find(fullFileName);
     if (infoIt != P->fileIndex_.end())
         infoIt->second->clear();
@@ -25,6 +25,9 @@
 #include "Ast/Ast.h"
 #include "Ast/AstLocator.h"
 #include "Common/Assert.h"
+#include <set>
+#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 
 using namespace uaiso;
@@ -96,6 +99,7 @@ const Diagnostic::Code Diagnostic::InvalidReferenceToSelf = 51;
 const Diagnostic::Code Diagnostic::UnexpectedName = 52;
 const Diagnostic::Code Diagnostic::UnmatchedStringJoining = 53;
 const Diagnostic::Code Diagnostic::InvalidOperator = 54;
+const Diagnostic::Code Diagnostic::AmbiguousSelector = 55;
 
 namespace uaiso {
 
@@ -219,6 +223,8 @@ public:
                     "unmatched string joining", Severity::Error },
         { Diagnostic::InvalidOperator,
                     "invalid operator", Severity::Error },
+        { Diagnostic::AmbiguousSelector,
+                    "ambiguous selector", Severity::Error },
     };
 };
 
@@ -229,7 +235,7 @@ static const DiagnosticTable kDiagnosticTable;
     //--- Diagnostic ---//
 
 Diagnostic::Diagnostic(Code code,
-                       const std::string& desc,
+                       const char* desc,
                        Severity severity)
     : code_(code)
     , desc_(desc)
@@ -249,33 +255,108 @@ Diagnostic DiagnosticReport::diagnostic() const
     return kDiagnosticTable.find(code_);
 }
 
+Diagnostic::Code DiagnosticReport::code() const
+{
+    return code_;
+}
+
 const SourceLoc& DiagnosticReport::sourceLoc() const
 {
     return loc_;
 }
 
-    //--- DiagnosticReports ---//
+    //--- DiagnosticSink ---//
+
+DiagnosticSink::~DiagnosticSink()
+{}
 
-void DiagnosticReports::add(const DiagnosticReport& report)
+void DiagnosticSink::add(const DiagnosticReport& report)
 {
-    reports_.push_back(report);
+    this->report(report);
 }
 
-void DiagnosticReports::add(const Diagnostic::Code code, const SourceLoc& loc)
+void DiagnosticSink::add(const Diagnostic::Code code, const SourceLoc& loc)
 {
     add(DiagnosticReport(code, loc));
 }
 
-void DiagnosticReports::add(const Diagnostic::Code code,
-                            Ast* ast,
-                            const AstLocator* locator)
+void DiagnosticSink::add(const Diagnostic::Code code,
+                         Ast* ast,
+                         const AstLocator* locator)
 {
     add(DiagnosticReport(code, fullLoc(ast, locator)));
 }
 
-void DiagnosticReports::add(const Diagnostic::Code code,
-                            Ast* ast,
-                            const std::unique_ptr<const AstLocator>& locator)
+void DiagnosticSink::add(const Diagnostic::Code code,
+                         Ast* ast,
+                         const std::unique_ptr<const AstLocator>& locator)
 {
     add(code, ast, locator.get());
 }
+
+    //--- DiagnosticFilter ---//
+
+struct uaiso::DiagnosticFilter::DiagnosticFilterImpl
+{
+    DiagnosticFilterImpl(DiagnosticSink* sink)
+        : sink_(sink)
+    {}
+
+    struct FileState
+    {
+        size_t count_ { 0 };
+        std::set<std::tuple<Diagnostic::Code, int, int>> seen_;
+    };
+
+    DiagnosticSink* sink_;
+    std::unordered_map<std::string, FileState> files_;
+    size_t max_ { 0 };
+    size_t dropped_ { 0 };
+    bool dedup_ { false };
+};
+
+DiagnosticFilter::DiagnosticFilter(DiagnosticSink* sink)
+    : P(new DiagnosticFilterImpl(sink))
+{}
+
+DiagnosticFilter::~DiagnosticFilter()
+{}
+
+void DiagnosticFilter::setDeduplicate(bool dedup)
+{
+    P->dedup_ = dedup;
+}
+
+void DiagnosticFilter::setMaxPerFile(size_t max)
+{
+    P->max_ = max;
+}
+
+size_t DiagnosticFilter::dropped() const
+{
+    return P->dropped_;
+}
+
+void DiagnosticFilter::report(const DiagnosticReport& report)
+{
+    UAISO_ASSERT(P->sink_, return);
+
+    const SourceLoc& loc = report.sourceLoc();
+    auto& file = P->files_[loc.fileName_];
+    if ((P->max_ && file.count_ >= P->max_)
+            || (P->dedup_ && !file.seen_.emplace(report.code(),
+                                                 loc.line_, loc.col_).second)) {
+        ++P->dropped_;
+        return;
+    }
+
+    ++file.count_;
+    P->sink_->report(report);
+}
+
+    //--- DiagnosticReports ---//
+
+void DiagnosticReports::report(const DiagnosticReport& report)
+{
+    reports_.push_back(report);
+}
@@ -26,6 +26,7 @@
 
 #include "Ast/AstFwd.h"
 #include "Common/Config.h"
+#include "Common/Pimpl.h"
 #include "Parsing/Severity.h"
 #include "Parsing/SourceLoc.h"
 #include <iterator>
@@ -49,7 +50,13 @@ public:
 
     Code code() const { return code_; }
 
-    const std::string& desc() const { return desc_; }
+    /*!
+     * \brief desc
+     * \return
+     *
+     * Return the (static) description of the diagnostic.
+     */
+    const char* desc() const { return desc_; }
 
     Severity severity() const { return severity_; }
 
@@ -104,6 +111,7 @@ public:
     static const Code InvalidFloatSuffix;
     static const Code InvalidReferenceToSelf;
     static const Code InvalidOperator;
+    static const Code AmbiguousSelector;
     static const Code UnexpectedName;
     static const Code UnmatchedStringJoining;
 
@@ -111,11 +119,11 @@ private:
     friend class DiagnosticTable;
 
     Diagnostic(Code code,
-               const std::string& desc,
+               const char* desc,
                Severity severity);
 
     Code code_;
-    std::string desc_;
+    const char* desc_;
     Severity severity_;
 };
 
@@ -140,6 +148,8 @@ public:
 
     Diagnostic diagnostic() const;
 
+    Diagnostic::Code code() const;
+
     const SourceLoc& sourceLoc() const;
 
 private:
@@ -147,10 +157,76 @@ private:
     SourceLoc loc_;
 };
 
+/*!
+ * \brief The DiagnosticSink class
+ *
+ * Where diagnostics are reported to, as soon as they're found by a lexer,
+ * parser, binder, or type checker.
+ */
+class UAISO_API DiagnosticSink
+{
+public:
+    virtual ~DiagnosticSink();
+
+    /*!
+     * \brief report
+     * \param report
+     */
+    virtual void report(const DiagnosticReport& report) = 0;
+
+    void add(const DiagnosticReport& report);
+    void add(const Diagnostic::Code code, const SourceLoc& loc);
+    void add(const Diagnostic::Code code, Ast* ast, const AstLocator* locator);
+    void add(const Diagnostic::Code code, Ast* ast, const std::unique_ptr<const AstLocator>&);
+};
+
+/*!
+ * \brief The DiagnosticFilter class
+ *
+ * A sink that forwards diagnostics to another one, optionally dropping
+ * duplicates (same code and location) and those beyond a number per file.
+ */
+class UAISO_API DiagnosticFilter final : public DiagnosticSink
+{
+public:
+    DiagnosticFilter(DiagnosticSink* sink);
+    ~DiagnosticFilter();
+
+    /*!
+     * \brief setDeduplicate
+     * \param dedup
+     */
+    void setDeduplicate(bool dedup);
+
+    /*!
+     * \brief setMaxPerFile
+     * \param max
+     *
+     * Forward at most the given number of diagnostics per file, zero (the
+     * default) meaning no limit.
+     */
+    void setMaxPerFile(size_t max);
+
+    /*!
+     * \brief dropped
+     * \return
+     *
+     * Return how many diagnostics were not forwarded.
+     */
+    size_t dropped() const;
+
+    void report(const DiagnosticReport& report) override;
+
+private:
+    DECL_PIMPL(DiagnosticFilter)
+};
+
 /*!
  * \brief The DiagnosticReports class
+ *
+ * A sink that buffers diagnostics.
  */
-class UAISO_API DiagnosticReports final
+class UAISO_API DiagnosticReports final : public DiagnosticSink
 {
 private:
     using Cont = std::vector<DiagnosticReport>;
@@ -166,10 +242,7 @@ public:
 
     Cont::size_type size() const { return reports_.size(); }
 
-    void add(const DiagnosticReport& report);
-    void add(const Diagnostic::Code code, const SourceLoc& loc);
-    void add(const Diagnostic::Code code, Ast* ast, const AstLocator* locator);
-    void add(const Diagnostic::Code code, Ast* ast, const std::unique_ptr<const AstLocator>&);
+    void report(const DiagnosticReport& report) override;
 };
 
 } // namespace uaiso
@@ -0,0 +1,86 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Parsing/Diagnostic.h"
+#include "Common/Test.h"
+#include <vector>
+
+using namespace uaiso;
+
+namespace {
+
+struct RecordingSink : DiagnosticSink
+{
+    void report(const DiagnosticReport& report) override
+    {
+        locs_.push_back(report.sourceLoc().lineCol());
+    }
+
+    std::vector<LineCol> locs_;
+};
+
+} // anonymous
+
+namespace uaiso {
+
+void test_DiagnosticFilter();
+
+class DiagnosticFilterTest final : public Test
+{
+public:
+    TEST_RUN(DiagnosticFilterTest
+             , &DiagnosticFilterTest::testCase1
+             )
+
+    void testCase1();
+};
+
+} // namespace uaiso
+
+void uaiso::DiagnosticFilterTest::testCase1()
+{
+    // Duplicates are dropped, so are diagnostics beyond the limit of a file.
+    RecordingSink sink;
+    DiagnosticFilter filter(&sink);
+    filter.setDeduplicate(true);
+    filter.setMaxPerFile(2);
+
+    SourceLoc loc(1, 2, 1, 3, "/a.py");
+    filter.add(Diagnostic::UnexpectedToken, loc);
+    filter.add(Diagnostic::UnexpectedToken, loc);
+    filter.add(Diagnostic::UndeclaredIdentifier, loc);
+    filter.add(Diagnostic::UnexpectedToken, SourceLoc(2, 0, 2, 1, "/a.py"));
+    filter.add(Diagnostic::UnexpectedToken, SourceLoc(2, 0, 2, 1, "/b.py"));
+
+    UAISO_EXPECT_INT_EQ(3, sink.locs_.size());
+    UAISO_EXPECT_INT_EQ(2, filter.dropped());
+    UAISO_EXPECT_INT_EQ(1, sink.locs_[1].line_);
+    UAISO_EXPECT_INT_EQ(2, sink.locs_[2].line_);
+}
+
+void uaiso::test_DiagnosticFilter()
+{
+    DiagnosticFilterTest test;
+    test.run();
+}
@@ -0,0 +1,150 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Parsing/GlrStats.h"
+#include "Common/Assert.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstring>
+#include <unordered_map>
+
+using namespace uaiso;
+
+namespace {
+
+thread_local GlrStats* current_ = nullptr;
+
+bool startsWith(const char* s, const char* prefix)
+{
+    return !std::strncmp(s, prefix, std::strlen(prefix));
+}
+
+} // anonymous
+
+struct uaiso::GlrStats::GlrStatsImpl
+{
+    size_t splits_ { 0 };
+    size_t merges_ { 0 };
+    size_t resumes_ { 0 };
+    std::unordered_map<int, size_t> deferred_;
+    GlrStats* prev_ { nullptr };
+    bool attached_ { false };
+};
+
+GlrStats::GlrStats()
+    : P(new GlrStatsImpl)
+{}
+
+GlrStats::~GlrStats()
+{
+    if (P->attached_)
+        detach();
+}
+
+void GlrStats::attach()
+{
+    UAISO_ASSERT(!P->attached_, return);
+
+    P->prev_ = current_;
+    P->attached_ = true;
+    current_ = this;
+}
+
+void GlrStats::detach()
+{
+    UAISO_ASSERT(P->attached_, return);
+    UAISO_ASSERT(current_ == this, return);
+
+    current_ = P->prev_;
+    P->prev_ = nullptr;
+    P->attached_ = false;
+}
+
+bool GlrStats::isAnyAttached()
+{
+    return current_ != nullptr;
+}
+
+void GlrStats::reset()
+{
+    P->splits_ = 0;
+    P->merges_ = 0;
+    P->resumes_ = 0;
+    P->deferred_.clear();
+}
+
+size_t GlrStats::splits() const
+{
+    return P->splits_;
+}
+
+size_t GlrStats::merges() const
+{
+    return P->merges_;
+}
+
+size_t GlrStats::resumes() const
+{
+    return P->resumes_;
+}
+
+std::vector<std::pair<int, size_t>> GlrStats::deferredReductions() const
+{
+    std::vector<std::pair<int, size_t>> rules(P->deferred_.begin(),
+                                              P->deferred_.end());
+    std::sort(rules.begin(), rules.end(),
+              [](const std::pair<int, size_t>& a, const std::pair<int, size_t>& b) {
+                  return a.second > b.second
+                          || (a.second == b.second && a.first < b.first);
+              });
+    return rules;
+}
+
+int GlrStats::trace(FILE* stream, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+
+    if (!current_) {
+        int written = vfprintf(stream, format, args);
+        va_end(args);
+        return written;
+    }
+
+    // The messages are those of bison's GLR skeleton.
+    GlrStatsImpl* impl = current_->P.get();
+    if (startsWith(format, "Splitting off stack")) {
+        ++impl->splits_;
+    } else if (startsWith(format, "Merging stack")) {
+        ++impl->merges_;
+    } else if (startsWith(format, "Returning to deterministic")) {
+        ++impl->resumes_;
+    } else if (startsWith(format, "Reduced stack")
+               && std::strstr(format, "action deferred")) {
+        va_arg(args, long); // The stack.
+        ++impl->deferred_[va_arg(args, int)];
+    }
+
+    va_end(args);
+    return 0;
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#ifndef UAISO_GLRSTATS_H__
+#define UAISO_GLRSTATS_H__
+
+#include "Common/Config.h"
+#include "Common/Pimpl.h"
+#include <cstddef>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace uaiso {
+
+/*!
+ * \brief The GlrStats class
+ *
+ * Count the nondeterminism a GLR parser runs into: stack splits, stack
+ * merges, and reductions deferred while the stack is split, per grammar
+ * rule. Rules are identified by their number, as in bison's report file.
+ *
+ * Counting happens while the stats are attached to the current thread,
+ * across any number of parses, which makes it possible to profile the
+ * grammar over a corpus.
+ *
+ * The grammars replace bison's global debug flag with a per-thread query,
+ * so attaching stats only affects parses in the current thread.
+ */
+class UAISO_API GlrStats final
+{
+public:
+    GlrStats();
+    ~GlrStats();
+
+    /*!
+     * \brief attach
+     *
+     * Start counting parses in the current thread.
+     */
+    void attach();
+
+    /*!
+     * \brief detach
+     *
+     * Stop counting, restoring the previously attached stats (if any).
+     */
+    void detach();
+
+    /*!
+     * \brief isAnyAttached
+     * \return
+     *
+     * Return whether stats are attached to the current thread.
+     */
+    static bool isAnyAttached();
+
+    void reset();
+
+    size_t splits() const;
+
+    size_t merges() const;
+
+    /*!
+     * \brief resumes
+     * \return
+     *
+     * Return how many times the parser returned to deterministic operation.
+     */
+    size_t resumes() const;
+
+    /*!
+     * \brief deferredReductions
+     * \return
+     *
+     * Return pairs of rule number and the count of its deferred reductions,
+     * the most frequent first.
+     */
+    std::vector<std::pair<int, size_t>> deferredReductions() const;
+
+    /*!
+     * \brief trace
+     *
+     * Replacement for bison's YYFPRINTF. When stats are attached, GLR
+     * traces are counted and swallowed, otherwise they're printed.
+     *
+     * Traces are recognized by the prefix of their format, which the GLR
+     * skeleton has kept across bison 3 releases, and no text is formatted.
+     */
+    static int trace(FILE* stream, const char* format, ...);
+
+private:
+    DECL_PIMPL(GlrStats)
+};
+
+} // namespace uaiso
+
+#endif
@@ -37,10 +37,17 @@ bool Lang::hasExecutableRecord() const { return false; }
 
 bool Lang::hasNewlineAsTerminator() const { return false; }
 
+bool Lang::hasOffsideRule() const { return false; }
+
 bool Lang::isPurelyOO() const { return false; }
 
 bool Lang::requiresReturnTypeInference() const { return false; }
 
+Lang::MemberOrder Lang::memberOrder() const
+{
+    return DepthFirst;
+}
+
 std::string Lang::packageSeparator() const
 {
     return ".";
@@ -95,6 +95,15 @@ public:
      */
     virtual bool hasNewlineAsTerminator() const;
 
+    /*!
+     * \brief hasOffsideRule
+     * \return
+     *
+     * Return whether blocks are delimited by indentation, as opposed to
+     * braces, such as in Python.
+     */
+    virtual bool hasOffsideRule() const;
+
     /*!
      * \brief The ImportMechanism enum
      */
@@ -124,6 +133,25 @@ public:
      */
     virtual bool isPurelyOO() const;
 
+    /*!
+     * \brief The MemberOrder enum
+     */
+    enum MemberOrder
+    {
+        DepthFirst,      //!< Bases looked up depth-first, left-to-right.
+        ResolutionOrder, //!< Bases linearized as in Python's C3 MRO.
+        Promotion        //!< Shallower embedded records win, as in Go.
+    };
+
+    /*!
+     * \brief memberOrder
+     * \return
+     *
+     * Return the order in which members inherited from base records (or
+     * promoted from embedded ones) are looked up.
+     */
+    virtual MemberOrder memberOrder() const;
+
     /*!
      * \brief requiresReturnTypeInference
      * \return
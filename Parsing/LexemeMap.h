@@ -41,6 +41,8 @@ class StrLit;
 
 /*!
  * \brief The LexemeMap class
+ *
+ * \note Safe to use from multiple threads.
  */
 class UAISO_API LexemeMap final
 {
@@ -0,0 +1,468 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Parsing/Outliner.h"
+#include "Parsing/Factory.h"
+#include "Parsing/Lang.h"
+#include "Parsing/Phrasing.h"
+#include "Parsing/Token.h"
+#include "Common/Assert.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+using namespace uaiso;
+
+namespace {
+
+/*
+ * Whatever, from a line, matters for outlining: the declaration cues and
+ * the braces, in order.
+ */
+struct Mark
+{
+    enum What : char
+    {
+        Decl,
+        Open,
+        Close
+    };
+
+    What what_;
+    Outliner::Kind kind_;
+    bool body_;         //!< Whether an open brace is a declaration's body.
+    int col_;
+    std::string name_;
+};
+
+struct LineSummary
+{
+    int indent_ { -1 };     //!< Column of the first token, if any.
+    int span_ { 0 };        //!< Further lines reached by tokens from here.
+    int brackets_ { 0 };    //!< Brackets opened minus brackets closed.
+    std::vector<Mark> marks_;
+};
+
+bool isOpening(Token tk)
+{
+    return tk == TK_LPAREN || tk == TK_LBRACKET || tk == TK_LBRACE;
+}
+
+bool isClosing(Token tk)
+{
+    return tk == TK_RPAREN || tk == TK_RBRACKET || tk == TK_RBRACE;
+}
+
+} // anonymous
+
+struct uaiso::Outliner::OutlinerImpl
+{
+    OutlinerImpl(Factory* factory)
+        : offside_(factory->makeLang()->hasOffsideRule())
+    {}
+
+    std::vector<LineSummary> summarize(const std::string& source,
+                                       const Phrasing* phrasing) const;
+    void rebuild();
+    void rebuildByBraces();
+    void rebuildByIndentation();
+
+    bool offside_;
+    std::vector<LineSummary> lines_;
+    std::vector<Outliner::Entry> entries_;
+    std::vector<Outliner::Fold> folds_;
+};
+
+std::vector<LineSummary>
+Outliner::OutlinerImpl::summarize(const std::string& source,
+                                  const Phrasing* phrasing) const
+{
+    std::vector<size_t> lineOffs { 0 };
+    const char* buff = source.c_str();
+    const char* end = buff + source.size();
+    for (const char* p = buff;
+         (p = static_cast<const char*>(std::memchr(p, '\n', end - p)));
+         ++p) {
+        lineOffs.push_back(p + 1 - buff);
+    }
+    std::vector<LineSummary> lines(lineOffs.size());
+    if (!phrasing)
+        return lines;
+
+    // Comments have no effect on structure, they're skipped.
+    const size_t tkCnt = phrasing->size();
+    auto skip = [phrasing, tkCnt] (size_t idx) {
+        for (; idx < tkCnt; ++idx) {
+            Token tk = phrasing->token(idx);
+            if (tk != TK_COMMENT && tk != TK_MULTILINE_COMMENT)
+                break;
+        }
+        return idx;
+    };
+    auto next = [skip] (size_t idx) { return skip(idx + 1); };
+    auto tokenAt = [phrasing, tkCnt] (size_t idx) {
+        return idx < tkCnt ? phrasing->token(idx) : TK_EOP;
+    };
+    auto spell = [&] (size_t idx) {
+        LineCol lineCol = phrasing->lineCol(idx);
+        size_t off = lineOffs[lineCol.line_] + lineCol.col_;
+        if (off >= source.size())
+            return std::string();
+        return source.substr(off, phrasing->length(idx));
+    };
+
+    // A declaration's body, if any, is the first brace past its name which
+    // isn't within parens or brackets, unless the declaration ends before.
+    std::vector<size_t> bodies;
+    auto findBody = [&] (size_t idx) {
+        int nesting = 0;
+        for (; idx < tkCnt; idx = next(idx)) {
+            Token tk = phrasing->token(idx);
+            if (tk == TK_LBRACE && !nesting) {
+                bodies.push_back(idx);
+                return;
+            }
+            if (isOpening(tk)) {
+                ++nesting;
+            } else if (isClosing(tk)) {
+                if (--nesting < 0)
+                    return;
+            } else if (tk == TK_SEMICOLON && !nesting) {
+                return;
+            }
+        }
+    };
+
+    int parens = 0;             // Parens and brackets.
+    int braces = 0;
+    int groupParens = -1;       // Within a Go-style `type ( ... )' group.
+    int groupBraces = -1;
+    Token prevTk = TK_INVALID;
+    size_t bodyCursor = 0;
+    for (size_t idx = skip(0); idx < tkCnt; idx = next(idx)) {
+        const Token tk = phrasing->token(idx);
+        const LineCol lineCol = phrasing->lineCol(idx);
+        UAISO_ASSERT(lineCol.line_ >= 0 && lineCol.line_ < (int)lines.size(),
+                     return lines);
+
+        LineSummary& line = lines[lineCol.line_];
+        if (line.indent_ < 0)
+            line.indent_ = lineCol.col_;
+
+        auto addDecl = [&] (Kind kind, size_t nameIdx) {
+            line.marks_.push_back(Mark{ Mark::Decl, kind, false, lineCol.col_,
+                                        spell(nameIdx) });
+            if (!offside_)
+                findBody(next(nameIdx));
+        };
+
+        switch (tk) {
+        case TK_LPAREN:
+        case TK_LBRACKET:
+            ++line.brackets_;
+            ++parens;
+            break;
+
+        case TK_RPAREN:
+        case TK_RBRACKET:
+            --line.brackets_;
+            if (--parens < groupParens)
+                groupParens = groupBraces = -1;
+            break;
+
+        case TK_LBRACE: {
+            ++line.brackets_;
+            ++braces;
+            if (offside_)
+                break;
+            while (bodyCursor < bodies.size() && bodies[bodyCursor] < idx)
+                ++bodyCursor;
+            bool body = bodyCursor < bodies.size() && bodies[bodyCursor] == idx;
+            line.marks_.push_back(Mark{ Mark::Open, Kind::Func, body,
+                                        lineCol.col_, std::string() });
+            break;
+        }
+
+        case TK_RBRACE:
+            --line.brackets_;
+            --braces;
+            if (!offside_) {
+                line.marks_.push_back(Mark{ Mark::Close, Kind::Func, false,
+                                            lineCol.col_, std::string() });
+            }
+            break;
+
+        case TK_STR_LIT: {
+            // Multiline strings extend the line.
+            size_t off = lineOffs[lineCol.line_] + lineCol.col_;
+            if (off < source.size()) {
+                const char* first = buff + off;
+                const char* last = first + std::min<size_t>(phrasing->length(idx),
+                                                            source.size() - off);
+                line.span_ = std::max<int>(line.span_,
+                                           std::count(first, last, '\n'));
+            }
+            break;
+        }
+
+        case TK_DEF:
+        case TK_FUNC: {
+            if (parens)
+                break;
+            size_t nameIdx = next(idx);
+            if (tk == TK_FUNC && tokenAt(nameIdx) == TK_LPAREN) {
+                // A method's receiver.
+                int nesting = 0;
+                do {
+                    Token recvTk = tokenAt(nameIdx);
+                    if (isOpening(recvTk))
+                        ++nesting;
+                    else if (isClosing(recvTk))
+                        --nesting;
+                    nameIdx = next(nameIdx);
+                } while (nesting > 0 && nameIdx < tkCnt);
+            }
+            // Function literals have no name.
+            const Token afterTk = tokenAt(next(nameIdx));
+            if (tokenAt(nameIdx) == TK_IDENT
+                    && (afterTk == TK_LPAREN || afterTk == TK_LBRACKET)) {
+                addDecl(Kind::Func, nameIdx);
+            }
+            break;
+        }
+
+        case TK_CLASS:
+        case TK_STRUCT:
+        case TK_UNION:
+        case TK_INTERFACE:
+        case TK_ENUM: {
+            // Anonymous types have no name (and aren't outlined).
+            size_t nameIdx = next(idx);
+            if (!parens && tokenAt(nameIdx) == TK_IDENT)
+                addDecl(tk == TK_ENUM ? Kind::Enum : Kind::Record, nameIdx);
+            break;
+        }
+
+        case TK_TYPE: {
+            if (parens)
+                break;
+            size_t nameIdx = next(idx);
+            if (tokenAt(nameIdx) == TK_LPAREN) {
+                groupParens = parens + 1;
+                groupBraces = braces;
+            } else if (tokenAt(nameIdx) == TK_IDENT) {
+                const Token specTk = tokenAt(next(nameIdx));
+                addDecl(specTk == TK_STRUCT || specTk == TK_INTERFACE
+                            ? Kind::Record : Kind::Type,
+                        nameIdx);
+            }
+            break;
+        }
+
+        case TK_IDENT:
+            if (parens == groupParens && braces == groupBraces
+                    && (prevTk == TK_LPAREN || prevTk == TK_SEMICOLON)) {
+                const Token specTk = tokenAt(next(idx));
+                addDecl(specTk == TK_STRUCT || specTk == TK_INTERFACE
+                            ? Kind::Record : Kind::Type,
+                        idx);
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        prevTk = tk;
+    }
+
+    return lines;
+}
+
+void Outliner::OutlinerImpl::rebuild()
+{
+    entries_.clear();
+    folds_.clear();
+    offside_ ? rebuildByIndentation() : rebuildByBraces();
+
+    // Folds were added as blocks opened, but single-line blocks don't fold.
+    folds_.erase(std::remove_if(folds_.begin(), folds_.end(),
+                                [] (const Outliner::Fold& fold) {
+                                    return fold.lastLine_ <= fold.line_;
+                                }),
+                 folds_.end());
+}
+
+void Outliner::OutlinerImpl::rebuildByBraces()
+{
+    struct Block
+    {
+        int entry_;
+        size_t fold_;
+    };
+    std::vector<Block> blocks;
+    int depth = 0;
+    int pending = -1;
+    for (int lineNum = 0; lineNum < (int)lines_.size(); ++lineNum) {
+        for (const Mark& mark : lines_[lineNum].marks_) {
+            switch (mark.what_) {
+            case Mark::Decl:
+                pending = entries_.size();
+                entries_.push_back(Outliner::Entry{
+                        mark.kind_, mark.name_, LineCol(lineNum, mark.col_),
+                        lineNum, depth });
+                break;
+
+            case Mark::Open: {
+                int entry = -1;
+                if (mark.body_ && pending != -1) {
+                    entry = pending;
+                    pending = -1;
+                    ++depth;
+                }
+                blocks.push_back(Block{ entry, folds_.size() });
+                folds_.push_back(Outliner::Fold{ lineNum, lineNum });
+                break;
+            }
+
+            case Mark::Close:
+                if (blocks.empty())
+                    break;
+                if (blocks.back().entry_ != -1) {
+                    entries_[blocks.back().entry_].lastLine_ = lineNum;
+                    --depth;
+                }
+                folds_[blocks.back().fold_].lastLine_ = lineNum;
+                blocks.pop_back();
+                break;
+            }
+        }
+    }
+
+    // Unbalanced braces extend to the end.
+    const int lastLine = lines_.empty() ? 0 : lines_.size() - 1;
+    for (const Block& block : blocks) {
+        if (block.entry_ != -1)
+            entries_[block.entry_].lastLine_ = lastLine;
+        folds_[block.fold_].lastLine_ = lastLine;
+    }
+}
+
+void Outliner::OutlinerImpl::rebuildByIndentation()
+{
+    struct Block
+    {
+        int indent_;
+        int entry_;
+        size_t fold_;
+    };
+    std::vector<Block> blocks;
+    int depth = 0;
+    int brackets = 0;
+    int reach = 0;
+    auto close = [&] () {
+        const Block& block = blocks.back();
+        if (block.entry_ != -1) {
+            entries_[block.entry_].lastLine_ = reach;
+            --depth;
+        }
+        folds_[block.fold_].lastLine_ = reach;
+        blocks.pop_back();
+    };
+
+    for (int lineNum = 0; lineNum < (int)lines_.size(); ++lineNum) {
+        const LineSummary& line = lines_[lineNum];
+        if (line.indent_ < 0)
+            continue;
+
+        // Lines continued within brackets don't start a block.
+        if (!brackets) {
+            while (!blocks.empty() && blocks.back().indent_ >= line.indent_)
+                close();
+
+            int entry = -1;
+            for (const Mark& mark : line.marks_) {
+                if (mark.what_ != Mark::Decl)
+                    continue;
+                entry = entries_.size();
+                entries_.push_back(Outliner::Entry{
+                        mark.kind_, mark.name_, LineCol(lineNum, mark.col_),
+                        lineNum, depth });
+                ++depth;
+                break;
+            }
+            blocks.push_back(Block{ line.indent_, entry, folds_.size() });
+            folds_.push_back(Outliner::Fold{ lineNum, lineNum });
+        }
+        brackets = std::max(0, brackets + line.brackets_);
+        reach = std::max(reach, lineNum + line.span_);
+    }
+
+    while (!blocks.empty())
+        close();
+}
+
+Outliner::Outliner(Factory* factory)
+    : P(new OutlinerImpl(factory))
+{}
+
+Outliner::~Outliner()
+{}
+
+void Outliner::outline(const std::string& source, const Phrasing* phrasing)
+{
+    P->lines_ = P->summarize(source, phrasing);
+    P->rebuild();
+}
+
+void Outliner::update(int line, int lineCnt,
+                      const std::string& source, const Phrasing* phrasing)
+{
+    UAISO_ASSERT(line >= 0 && lineCnt >= 0, return);
+    UAISO_ASSERT(line + lineCnt <= (int)P->lines_.size(), return);
+
+    // Line summaries are position independent, so those of the lines that
+    // weren't edited remain valid.
+    std::vector<LineSummary> lines = P->summarize(source, phrasing);
+    auto it = P->lines_.erase(P->lines_.begin() + line,
+                              P->lines_.begin() + line + lineCnt);
+    P->lines_.insert(it,
+                     std::make_move_iterator(lines.begin()),
+                     std::make_move_iterator(lines.end()));
+    P->rebuild();
+}
+
+const std::vector<Outliner::Entry>& Outliner::entries() const
+{
+    return P->entries_;
+}
+
+const std::vector<Outliner::Fold>& Outliner::folds() const
+{
+    return P->folds_;
+}
+
+size_t Outliner::lineCnt() const
+{
+    return P->lines_.size();
+}
@@ -0,0 +1,139 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#ifndef UAISO_OUTLINER_H__
+#define UAISO_OUTLINER_H__
+
+#include "Common/Config.h"
+#include "Common/LineCol.h"
+#include "Common/Pimpl.h"
+#include "Common/Test.h"
+#include <string>
+#include <vector>
+
+namespace uaiso {
+
+class Factory;
+class Phrasing;
+
+/*!
+ * \brief The Outliner class
+ *
+ * Outline declarations and folding ranges of a source out of the tokens
+ * collected by an IncrementalLexer. Neither an AST nor lexemes are needed:
+ * declarations are recognized by keyword cues, and their extent is given by
+ * brace matching or, in languages with the offside rule, by indentation.
+ *
+ * The outliner keeps a summary of every line, so once a source is outlined,
+ * it may be updated for edited lines only.
+ */
+class UAISO_API Outliner final
+{
+public:
+    Outliner(Factory* factory);
+    ~Outliner();
+
+    enum class Kind : char
+    {
+        Func,
+        Record,
+        Enum,
+        Type
+    };
+
+    /*!
+     * \brief The Entry struct
+     */
+    struct Entry
+    {
+        Kind kind_;
+        std::string name_;
+        LineCol lineCol_;   //!< Where the declaration starts.
+        int lastLine_;      //!< Last line of the declaration.
+        int depth_;         //!< Number of enclosing entries.
+    };
+
+    /*!
+     * \brief The Fold struct
+     */
+    struct Fold
+    {
+        int line_;
+        int lastLine_;
+    };
+
+    /*!
+     * \brief outline
+     * \param source
+     * \param phrasing
+     *
+     * Outline the source, whose tokens are in the phrasing.
+     */
+    void outline(const std::string& source, const Phrasing* phrasing);
+
+    /*!
+     * \brief update
+     * \param line
+     * \param lineCnt
+     * \param source
+     * \param phrasing
+     *
+     * Replace lineCnt lines, starting at line, by the lines of the source,
+     * whose tokens are in the phrasing (lexed with the state of the line
+     * before, as for an IncrementalLexer). The source mustn't start within
+     * a bracket, a string or a comment.
+     */
+    void update(int line, int lineCnt,
+                const std::string& source, const Phrasing* phrasing);
+
+    /*!
+     * \brief entries
+     * \return
+     *
+     * Return the declarations, in source order, with nested ones following
+     * the one that encloses them.
+     */
+    const std::vector<Entry>& entries() const;
+
+    /*!
+     * \brief folds
+     * \return
+     *
+     * Return the folding ranges, ordered by their first line.
+     */
+    const std::vector<Fold>& folds() const;
+
+    /*!
+     * \brief lineCnt
+     * \return
+     */
+    size_t lineCnt() const;
+
+private:
+    DECL_CLASS_TEST(Outliner)
+    DECL_PIMPL(Outliner)
+};
+
+} // namespace uaiso
+
+#endif
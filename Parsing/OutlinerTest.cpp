@@ -0,0 +1,240 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Parsing/Outliner.h"
+#include "Parsing/Factory.h"
+#include "Parsing/IncrementalLexer.h"
+#include "Parsing/Phrasing.h"
+#include <algorithm>
+
+using namespace uaiso;
+
+class Outliner::OutlinerTest : public Test
+{
+public:
+    TEST_RUN(OutlinerTest
+             , &OutlinerTest::testCase1
+             , &OutlinerTest::testCase2
+             , &OutlinerTest::testCase3
+             , &OutlinerTest::testCase4
+             )
+
+    std::unique_ptr<Phrasing> lex(Factory* factory, const std::string& code)
+    {
+        auto lexer = factory->makeIncrementalLexer();
+        lexer->lex(code);
+        return std::unique_ptr<Phrasing>(lexer->releasePhrasing());
+    }
+
+    void expectEntry(const Outliner& outliner, size_t index, Kind kind,
+                     const std::string& name, int line, int lastLine, int depth)
+    {
+        UAISO_EXPECT_TRUE(index < outliner.entries().size());
+        if (index >= outliner.entries().size())
+            return;
+        const Entry& entry = outliner.entries()[index];
+        UAISO_EXPECT_TRUE(entry.kind_ == kind);
+        UAISO_EXPECT_STR_EQ(name, entry.name_);
+        UAISO_EXPECT_INT_EQ(line, entry.lineCol_.line_);
+        UAISO_EXPECT_INT_EQ(lastLine, entry.lastLine_);
+        UAISO_EXPECT_INT_EQ(depth, entry.depth_);
+    }
+
+    void testCase1()
+    {
+        auto factory = FactoryCreator::create(LangId::Py);
+        std::string code = R"raw(import os
+
+class A(object):
+    """ Doc
+    string """
+    def f(self, a,
+          b):
+        # comment
+        return [a,
+  b]
+
+    @property
+    def g(self):
+        pass
+
+def h():
+    pass
+x = 1
+)raw";
+        Outliner outliner(factory.get());
+        auto phrasing = lex(factory.get(), code);
+        outliner.outline(code, phrasing.get());
+
+        UAISO_EXPECT_INT_EQ(4, outliner.entries().size());
+        expectEntry(outliner, 0, Kind::Record, "A", 2, 13, 0);
+        expectEntry(outliner, 1, Kind::Func, "f", 5, 9, 1);
+        expectEntry(outliner, 2, Kind::Func, "g", 12, 13, 1);
+        expectEntry(outliner, 3, Kind::Func, "h", 15, 16, 0);
+
+        // Multiline strings and statements fold too.
+        UAISO_EXPECT_INT_EQ(6, outliner.folds().size());
+        UAISO_EXPECT_INT_EQ(2, outliner.folds()[0].line_);
+        UAISO_EXPECT_INT_EQ(13, outliner.folds()[0].lastLine_);
+        UAISO_EXPECT_INT_EQ(3, outliner.folds()[1].line_);
+        UAISO_EXPECT_INT_EQ(4, outliner.folds()[1].lastLine_);
+        UAISO_EXPECT_INT_EQ(5, outliner.folds()[2].line_);
+        UAISO_EXPECT_INT_EQ(9, outliner.folds()[2].lastLine_);
+        UAISO_EXPECT_INT_EQ(8, outliner.folds()[3].line_);
+        UAISO_EXPECT_INT_EQ(9, outliner.folds()[3].lastLine_);
+    }
+
+    void testCase2()
+    {
+        // Update edited lines only.
+        auto factory = FactoryCreator::create(LangId::Py);
+        std::string code = "class A:\n    def f(self):\n        pass\n\ndef h():\n    pass\n";
+        Outliner outliner(factory.get());
+        auto phrasing = lex(factory.get(), code);
+        outliner.outline(code, phrasing.get());
+        UAISO_EXPECT_INT_EQ(3, outliner.entries().size());
+        UAISO_EXPECT_INT_EQ(7, outliner.lineCnt());
+
+        // Line 3 (blank) becomes a method.
+        std::string edit = "    def g(self):\n        pass";
+        phrasing = lex(factory.get(), edit);
+        outliner.update(3, 1, edit, phrasing.get());
+        UAISO_EXPECT_INT_EQ(8, outliner.lineCnt());
+        UAISO_EXPECT_INT_EQ(4, outliner.entries().size());
+        expectEntry(outliner, 0, Kind::Record, "A", 0, 4, 0);
+        expectEntry(outliner, 2, Kind::Func, "g", 3, 4, 1);
+        expectEntry(outliner, 3, Kind::Func, "h", 5, 6, 0);
+
+        // And h is removed.
+        phrasing = lex(factory.get(), "");
+        outliner.update(5, 2, "", phrasing.get());
+        UAISO_EXPECT_INT_EQ(7, outliner.lineCnt());
+        UAISO_EXPECT_INT_EQ(3, outliner.entries().size());
+    }
+
+    /*
+     * Phrase the tokens as given, locating them in the code one after the
+     * other (a token with an empty spelling is placed where the previous one
+     * ended, like an automatic semicolon).
+     */
+    std::unique_ptr<Phrasing> phrase(const std::string& code,
+                                     const std::vector<std::pair<Token, std::string>>& tks)
+    {
+        std::unique_ptr<Phrasing> phrasing(new Phrasing);
+        size_t pos = 0;
+        for (const auto& tk : tks) {
+            if (!tk.second.empty())
+                pos = code.find(tk.second, pos);
+            UAISO_EXPECT_TRUE(pos != std::string::npos);
+            size_t lineStart = code.rfind('\n', pos ? pos - 1 : 0);
+            lineStart = lineStart == std::string::npos || !pos ? 0 : lineStart + 1;
+            int line = std::count(code.begin(), code.begin() + pos, '\n');
+            phrasing->append(tk.first, LineCol(line, pos - lineStart),
+                             tk.second.size());
+            pos += tk.second.size();
+        }
+        return phrasing;
+    }
+
+    void testCase3()
+    {
+        auto factory = FactoryCreator::create(LangId::Go);
+        std::string code = R"raw(package p
+type (
+    U int
+    V struct {
+    }
+)
+func (t *T) m(f func(int) int) {
+    g := func() {
+    }
+}
+func n() {}
+)raw";
+        auto phrasing = phrase(code, {
+            { TK_PACKAGE, "package" }, { TK_IDENT, "p" }, { TK_SEMICOLON, "" },
+            { TK_TYPE, "type" }, { TK_LPAREN, "(" },
+            { TK_IDENT, "U" }, { TK_INT, "int" }, { TK_SEMICOLON, "" },
+            { TK_IDENT, "V" }, { TK_STRUCT, "struct" }, { TK_LBRACE, "{" },
+            { TK_RBRACE, "}" }, { TK_SEMICOLON, "" },
+            { TK_RPAREN, ")" }, { TK_SEMICOLON, "" },
+            { TK_FUNC, "func" }, { TK_LPAREN, "(" }, { TK_IDENT, "t" },
+            { TK_STAR, "*" }, { TK_IDENT, "T" }, { TK_RPAREN, ")" },
+            { TK_IDENT, "m" }, { TK_LPAREN, "(" }, { TK_IDENT, "f" },
+            { TK_FUNC, "func" }, { TK_LPAREN, "(" }, { TK_INT, "int" },
+            { TK_RPAREN, ")" }, { TK_INT, "int" }, { TK_RPAREN, ")" },
+            { TK_LBRACE, "{" },
+            { TK_IDENT, "g" }, { TK_COLON_EQ, ":=" }, { TK_FUNC, "func" },
+            { TK_LPAREN, "(" }, { TK_RPAREN, ")" }, { TK_LBRACE, "{" },
+            { TK_RBRACE, "}" }, { TK_SEMICOLON, "" },
+            { TK_RBRACE, "}" }, { TK_SEMICOLON, "" },
+            { TK_FUNC, "func" }, { TK_IDENT, "n" }, { TK_LPAREN, "(" },
+            { TK_RPAREN, ")" }, { TK_LBRACE, "{" }, { TK_RBRACE, "}" },
+            { TK_SEMICOLON, "" }
+        });
+        Outliner outliner(factory.get());
+        outliner.outline(code, phrasing.get());
+
+        UAISO_EXPECT_INT_EQ(4, outliner.entries().size());
+        expectEntry(outliner, 0, Kind::Type, "U", 2, 2, 0);
+        expectEntry(outliner, 1, Kind::Record, "V", 3, 4, 0);
+        expectEntry(outliner, 2, Kind::Func, "m", 6, 9, 0);
+        expectEntry(outliner, 3, Kind::Func, "n", 10, 10, 0);
+
+        UAISO_EXPECT_INT_EQ(3, outliner.folds().size());
+        UAISO_EXPECT_INT_EQ(3, outliner.folds()[0].line_);
+        UAISO_EXPECT_INT_EQ(4, outliner.folds()[0].lastLine_);
+        UAISO_EXPECT_INT_EQ(6, outliner.folds()[1].line_);
+        UAISO_EXPECT_INT_EQ(9, outliner.folds()[1].lastLine_);
+        UAISO_EXPECT_INT_EQ(7, outliner.folds()[2].line_);
+        UAISO_EXPECT_INT_EQ(8, outliner.folds()[2].lastLine_);
+    }
+
+    void testCase4()
+    {
+        auto factory = FactoryCreator::create(LangId::Go);
+        std::string code = "package p\nfunc f() {\n}\n";
+        auto phrasing = phrase(code, {
+            { TK_PACKAGE, "package" }, { TK_IDENT, "p" }, { TK_SEMICOLON, "" },
+            { TK_FUNC, "func" }, { TK_IDENT, "f" }, { TK_LPAREN, "(" },
+            { TK_RPAREN, ")" }, { TK_LBRACE, "{" },
+            { TK_RBRACE, "}" }, { TK_SEMICOLON, "" }
+        });
+        Outliner outliner(factory.get());
+        outliner.outline(code, phrasing.get());
+        UAISO_EXPECT_INT_EQ(1, outliner.entries().size());
+
+        // A nested type.
+        std::string edit = "    type S struct {\n    }";
+        phrasing = phrase(edit, {
+            { TK_TYPE, "type" }, { TK_IDENT, "S" }, { TK_STRUCT, "struct" },
+            { TK_LBRACE, "{" }, { TK_RBRACE, "}" }, { TK_SEMICOLON, "" }
+        });
+        outliner.update(2, 0, edit, phrasing.get());
+        UAISO_EXPECT_INT_EQ(2, outliner.entries().size());
+        expectEntry(outliner, 0, Kind::Func, "f", 1, 4, 0);
+        expectEntry(outliner, 1, Kind::Record, "S", 2, 3, 1);
+    }
+};
+
+MAKE_CLASS_TEST(Outliner)
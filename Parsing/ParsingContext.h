@@ -111,10 +111,34 @@ public:
      * \brief collectReports
      * \param reports
      *
-     * Specify where to collect parsing diagnostics. If not set, reports
+     * Specify where to report parsing diagnostics. If not set, reports
      * won't be collected.
      */
-    void collectReports(DiagnosticReports* reports) { reports_ = reports; }
+    void collectReports(DiagnosticSink* reports) { reports_ = reports; }
+
+    /*!
+     * \brief lexemes
+     * \return
+     */
+    LexemeMap* lexemes() const { return lexs_; }
+
+    /*!
+     * \brief tokens
+     * \return
+     */
+    TokenMap* tokens() const { return tokens_; }
+
+    /*!
+     * \brief phrasing
+     * \return
+     */
+    Phrasing* phrasing() const { return phrasing_; }
+
+    /*!
+     * \brief reports
+     * \return
+     */
+    DiagnosticSink* reports() const { return reports_; }
 
     /*!
      * \brief trackLexeme
@@ -243,7 +267,7 @@ protected:
     LexemeMap* lexs_ { nullptr };
     TokenMap* tokens_ { nullptr };
     Phrasing* phrasing_ { nullptr };
-    DiagnosticReports* reports_ { nullptr };
+    DiagnosticSink* reports_ { nullptr };
     std::unique_ptr<Ast> ast_;
 
     //! Premature stop of lexing, useful for completion.
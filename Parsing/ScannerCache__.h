@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+///////////////////////////////////////////////////////
+///                                                 ///
+///         This is an INTERNAL header              ///
+///                                                 ///
+///   Do not include this header from outside the   ///
+///   the uaiso lib or from any public API header   ///
+///                                                 ///
+///////////////////////////////////////////////////////
+
+#ifndef UAISO_SCANNERCACHE_H__
+#define UAISO_SCANNERCACHE_H__
+
+namespace uaiso {
+
+/*!
+ * \brief The ScannerCache class
+ *
+ * Setting up a reentrant Flex scanner is not cheap, so each thread keeps one
+ * around (the cache is meant to be a thread_local) to be reused across
+ * parses. A nested parse on the same thread (which shouldn't happen) gets a
+ * scanner of its own.
+ *
+ * The functions are the ones generated by Flex for a given prefix, plus one
+ * that brings a reused scanner back to its initial state.
+ */
+template <class ContextT,
+          int (*InitExtra)(ContextT*, void**),
+          void (*SetExtra)(ContextT*, void*),
+          void (*ResetState)(void*),
+          int (*Destroy)(void*)>
+class ScannerCache final
+{
+public:
+    ScannerCache() = default;
+    ScannerCache(const ScannerCache&) = delete;
+    ScannerCache& operator=(const ScannerCache&) = delete;
+
+    ~ScannerCache()
+    {
+        if (scanner_)
+            Destroy(scanner_);
+    }
+
+    void* acquire(ContextT* context)
+    {
+        void* scanner = nullptr;
+        if (busy_ || !scanner_) {
+            if (InitExtra(context, &scanner))
+                return nullptr;
+            if (busy_)
+                return scanner;
+            scanner_ = scanner;
+        } else {
+            scanner = scanner_;
+            SetExtra(context, scanner);
+            ResetState(scanner);
+        }
+        busy_ = true;
+        return scanner;
+    }
+
+    void release(void* scanner)
+    {
+        if (scanner != scanner_) {
+            Destroy(scanner);
+            return;
+        }
+        busy_ = false;
+    }
+
+private:
+    void* scanner_ { nullptr };
+    bool busy_ { false };
+};
+
+} // namespace uaiso
+
+#endif
@@ -32,6 +32,8 @@ namespace uaiso {
 
 /*!
  * \brief The TokenMap class
+ *
+ * \note Safe to use from multiple threads.
  */
 class UAISO_API TokenMap final
 {
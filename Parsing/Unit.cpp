@@ -65,3 +65,8 @@ DiagnosticReports* Unit::releaseReports()
     P->reports_.reset(new DiagnosticReports);
     return reports;
 }
+
+void Unit::collectDiagnostics(DiagnosticSink* sink)
+{
+    P->sink_ = sink;
+}
@@ -86,6 +86,9 @@ public:
      * \param lexs
      *
      * Parse the assigned input.
+     *
+     * The token map may be null, in which case it's not populated. The AST
+     * records the tokens needed by the Binder and the TypeChecker.
      */
     virtual void parse(TokenMap* tokens,
                        LexemeMap* lexs) = 0;
@@ -115,9 +118,20 @@ public:
     /*!
      * \brief releaseReports
      * \return
+     *
+     * Return the diagnostics buffered during parsing.
      */
     DiagnosticReports* releaseReports();
 
+    /*!
+     * \brief collectDiagnostics
+     * \param sink
+     *
+     * Report diagnostics to the given sink, as they're found, instead of
+     * buffering them. Pass null to buffer again.
+     */
+    void collectDiagnostics(DiagnosticSink* sink);
+
 protected:
     DECL_CLASS_TEST(Unit)
     DECL_PIMPL(Unit)
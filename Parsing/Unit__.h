@@ -61,6 +61,14 @@ struct Unit::UnitImpl
     std::string fullFileName_;
     std::unique_ptr<Ast> ast_;
     std::unique_ptr<DiagnosticReports> reports_;
+    DiagnosticSink* sink_ { nullptr };
+
+    DiagnosticSink* sink() const
+    {
+        if (sink_)
+            return sink_;
+        return reports_.get();
+    }
 
     union
     {
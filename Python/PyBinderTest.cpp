@@ -23,6 +23,8 @@
 
 #include "Semantic/BinderTest.h"
 #include "Semantic/Program.h"
+#include "Semantic/ProgramImage.h"
+#include "Semantic/Snapshot.h"
 #include "Semantic/Symbol.h"
 #include "Semantic/Type.h"
 #include "Parsing/Factory.h"
@@ -30,6 +32,8 @@
 #include "Parsing/LexemeMap.h"
 #include "Parsing/TokenMap.h"
 #include "Parsing/Unit.h"
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 
 using namespace uaiso;
@@ -363,3 +367,80 @@ class c2:
     UAISO_EXPECT_TRUE(clazzEnv.searchValueDecl(sm));
     UAISO_EXPECT_TRUE(clazzEnv.searchValueDecl(m));
 }
+
+void Binder::BinderTest::PyTestCase13()
+{
+    // Long chains of binary expressions and of elif arms.
+    std::string code = "x = 0";
+    for (int i = 0; i < 20000; ++i)
+        code += " + x";
+    code += "\nif x == 0:\n    pass\n";
+    for (int i = 1; i < 2000; ++i)
+        code += "elif x == " + std::to_string(i) + ":\n    pass\n";
+    code += "else:\n    last = x\n";
+
+    std::unique_ptr<Program> prog(core(FactoryCreator::create(LangId::Py),
+                                       code, "/test.py"));
+    UAISO_EXPECT_TRUE(prog);
+
+    const Ident* x = lexs_.findAnyOfIdent("x");
+    const Ident* last = lexs_.findAnyOfIdent("last");
+
+    Environment env = prog->env();
+    UAISO_EXPECT_TRUE(env.searchValueDecl(x));
+    UAISO_EXPECT_TRUE(env.searchValueDecl(last));
+}
+
+void Binder::BinderTest::PyTestCase14()
+{
+#ifndef _WIN32
+    char dirTemplate[] = "/tmp/uaisoXXXXXX";
+    if (!mkdtemp(dirTemplate))
+        UAISO_SKIP_TEST;
+    const std::string imageFileName = std::string(dirTemplate) + "/test.img";
+#else
+    UAISO_SKIP_TEST;
+    const std::string imageFileName;
+#endif
+
+    // Round trip through a program image, relocated to another root.
+    std::unique_ptr<Program> prog(core(FactoryCreator::create(LangId::Py),
+                                       basicCode, "/lib/test.py"));
+    UAISO_EXPECT_TRUE(prog);
+    bool written = ProgramImage::write(imageFileName, "/lib/", { prog.get() });
+
+    ProgramImage image;
+    bool opened = written && image.open(imageFileName, "/other/");
+    std::unique_ptr<Program> loaded;
+    if (opened)
+        loaded = image.program("/other/test.py", &lexs_);
+
+    // The image stays mapped while opened, but the file may go.
+    std::remove(imageFileName.c_str());
+    std::remove(dirTemplate);
+    UAISO_EXPECT_TRUE(written);
+    UAISO_EXPECT_TRUE(opened);
+    UAISO_EXPECT_INT_EQ(1, image.fileNames().size());
+    UAISO_EXPECT_FALSE(image.contains("/lib/test.py"));
+    UAISO_EXPECT_TRUE(image.contains("/other/test.py"));
+    UAISO_EXPECT_FALSE(image.program("/lib/test.py", &lexs_));
+
+    PyVerifyBasicCode(loaded.get());
+
+    const Ident* c = lexs_.findAnyOfIdent("c");
+    const Ident* init = lexs_.findAnyOfIdent("__init__");
+    auto record = loaded->env().searchTypeDecl(c);
+    UAISO_EXPECT_INT_EQ(static_cast<int>(Symbol::Kind::Record),
+                        static_cast<int>(record->kind()));
+    auto method = ConstRecord_Cast(record)->type()->env().searchValueDecl(init);
+    UAISO_EXPECT_TRUE(method);
+    UAISO_EXPECT_INT_EQ(static_cast<int>(Symbol::Kind::Func),
+                        static_cast<int>(method->kind()));
+    UAISO_EXPECT_INT_EQ(2, ConstFunc_Cast(method)->paramsType().size());
+    UAISO_EXPECT_INT_EQ(2, ConstFunc_Cast(method)->env().listValueDecls().size());
+
+    // All of the image's programs go into a snapshot at once.
+    Snapshot snapshot;
+    UAISO_EXPECT_INT_EQ(1, image.load(&lexs_, snapshot));
+    UAISO_EXPECT_TRUE(snapshot.find("/other/test.py"));
+}
@@ -27,6 +27,7 @@
 #include "Semantic/Environment.h"
 #include "Semantic/Symbol.h"
 #include "Semantic/Type.h"
+#include <atomic>
 
 using namespace uaiso;
 
@@ -38,8 +39,9 @@ const char* const kPyBuiltinFloat = "<__pybuiltin_float__>";
 const char* const kPyBuiltinInt = "<__pybuiltin_int__>";
 
 // An incremented-per-use line to make sure there are no location collisions
-// in the identifiers created for the builtins file.
-int line = 0;
+// in the identifiers created for the builtins file. Builtins of different
+// programs may be created concurrently.
+std::atomic<int> line { 0 };
 
 const Ident* insertOrFindIdent(LexemeMap* lexs, const char* name)
 {
@@ -1026,8 +1026,6 @@ def doit():
 
 void CompletionProposer::CompletionProposerTest::PyTestCase45()
 {
-    UAISO_SKIP_TEST;
-
     std::string code = R"raw(
 class A:
     def f(): pass
@@ -1052,14 +1050,83 @@ def foo():
 
 void CompletionProposer::CompletionProposerTest::PyTestCase46()
 {
+    std::string code = R"raw(
+class A:
+    a = 1
+    f = 1
+
+class B(A):
+    f = 2
+
+class C(A):
+    c = 3
+                                                 # line 10
+class D(B, C):
+    d = 4
+
+d = D()
+d.
+# ^
+# |
+# complete at up-arrow
+)raw";
+
+    // Members come in the method resolution order: D, B, C, A.
+    lineCol_ = { 15, 2 };
+    ordered_ = true;
+    auto expected = { "d", "f", "c", "a" };
+    runCore(FactoryCreator::create(LangId::Py), code, "/test.py", expected);
 }
 
 void CompletionProposer::CompletionProposerTest::PyTestCase47()
 {
+    std::string code = R"raw(
+class A:
+    a = 1
+
+class B:
+    b = "b"
+                                                 # line 6
+class C:
+    def make(self):
+        return B()
+
+def foo():
+    c = C()
+    p = c.make()
+    p.
+#     ^
+#     |
+#     complete at up-arrow
+)raw";
+
+    lineCol_ = { 14, 6 };
+    auto expected = { "b" };
+    runCore(FactoryCreator::create(LangId::Py), code, "/test.py", expected);
 }
 
 void CompletionProposer::CompletionProposerTest::PyTestCase48()
 {
+    std::string code = R"raw(
+class A:
+    a = 1
+
+def make():
+    return A()
+                                                 # line 6
+def foo():
+    p = None
+    if x:
+        p = make()
+    p.
+#     ^
+#     |
+#     complete at up-arrow
+)raw";
+
+    lineCol_ = { 11, 6 };
+    auto expected = { "a" };
+    runCore(FactoryCreator::create(LangId::Py), code, "/test.py", expected);
 }
 
 void CompletionProposer::CompletionProposerTest::PyTestCase49()
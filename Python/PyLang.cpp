@@ -34,6 +34,8 @@ bool PyLang::hasExecutableRecord() const { return true; }
 
 bool PyLang::hasNewlineAsTerminator() const { return true; }
 
+bool PyLang::hasOffsideRule() const { return true; }
+
 bool PyLang::requiresReturnTypeInference() const { return true; }
 
 PyLang::Structure PyLang::structure() const
@@ -46,6 +48,11 @@ PyLang::ImportMechanism PyLang::importMechanism() const
     return PerModuleAndPackage;
 }
 
+PyLang::MemberOrder PyLang::memberOrder() const
+{
+    return ResolutionOrder;
+}
+
 std::string PyLang::sourceFileSuffix() const
 {
     return ".py";
@@ -39,12 +39,16 @@ public:
 
     bool hasNewlineAsTerminator() const override;
 
+    bool hasOffsideRule() const override;
+
     bool requiresReturnTypeInference() const override;
 
     Structure structure() const override;
 
     ImportMechanism importMechanism() const override;
 
+    MemberOrder memberOrder() const override;
+
     bool isPurelyOO() const override;
 
     std::string sourceFileSuffix() const override;
@@ -24,12 +24,16 @@
 #include "Python/PyLexer.h"
 #include "Python/PyKeywords.h"
 #include "Python/PyLang.h"
+#include "Parsing/Diagnostic.h"
 #include "Parsing/Lexeme.h"
 #include "Parsing/ParsingContext.h"
 #include "Common/Assert.h"
 #include "Common/Trace__.h"
 #include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <thread>
 
 #define TRACE_NAME "PyLexer"
 
@@ -97,6 +101,21 @@ const int oprtrDelimTable[] =
 
 Token PyLexer::lex()
 {
+    // Tokens lexed upfront are handed out in order, then the end of program
+    // repeatedly (at the location of the last token).
+    if (replay_) {
+        if (replay_ == replayEnd_)
+            return TK_EOP;
+        const LexedToken& lexed = *replay_++;
+        line_ = lexed.line_;
+        col_ = lexed.col_;
+        breaks_ = lexed.breaks_;
+        rearLeng_ = lexed.rearLeng_;
+        mark_ = lexed.mark_;
+        curr_ = lexed.curr_;
+        return lexed.tk_;
+    }
+
     Token tk = TK_INVALID;
     updatePos();
 
@@ -162,6 +181,10 @@ LexNextToken:
 
     switch (ch) {
     case 0:
+        // The end of a chunk that isn't the last one is not the end of the
+        // input, so the indentation context remains.
+        if (bit_.midChunk_)
+            return TK_EOP;
         if (indentStack_.top() > 0) {
             indentStack_.pop();
             return TK_DEDENT;
@@ -376,6 +399,353 @@ LexNextToken:
     return tk;
 }
 
+namespace {
+
+// A line start at which lexing may begin afresh: outside strings, comments
+// and brackets, and not a continuation of the previous line.
+struct SplitPoint
+{
+    const char* pos_;
+    int line_;
+    std::vector<size_t> indents_;
+};
+
+const uint64_t kOnes = 0x0101010101010101ULL;
+const uint64_t kHighs = 0x8080808080808080ULL;
+
+// Whether any byte of the word is \a c, checking 8 bytes at once.
+inline bool hasByte(uint64_t word, char c)
+{
+    const uint64_t x = word ^ (kOnes * static_cast<unsigned char>(c));
+    return ((x - kOnes) & ~x & kHighs) != 0;
+}
+
+inline uint64_t loadWord(const char* p)
+{
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+// Skip the bytes which play no role in the code structure.
+const char* skipPlainCode(const char* p, const char* eof)
+{
+    while (eof - p >= 8) {
+        const uint64_t word = loadWord(p);
+        if (hasByte(word, '\n') || hasByte(word, '#') || hasByte(word, '\\')
+                || hasByte(word, '"') || hasByte(word, '\'')
+                || hasByte(word, '(') || hasByte(word, ')')
+                || hasByte(word, '[') || hasByte(word, ']')
+                || hasByte(word, '{') || hasByte(word, '}')) {
+            break;
+        }
+        p += 8;
+    }
+    return p;
+}
+
+// Skip the bytes of a string literal which can't end it (or a line).
+const char* skipPlainStrLit(const char* p, const char* eof, char quote)
+{
+    while (eof - p >= 8) {
+        const uint64_t word = loadWord(p);
+        if (hasByte(word, quote) || hasByte(word, '\\') || hasByte(word, '\n'))
+            break;
+        p += 8;
+    }
+    return p;
+}
+
+/*
+ * Go through the buffer, keeping track of strings, comments, brackets and
+ * indentation exactly as PyLexer would, and pick the first line start past
+ * every multiple of the chunk size. Lines are counted as the lexer does it
+ * (which doesn't include the ones skipped by a string literal join).
+ */
+std::vector<SplitPoint> findSplitPoints(const char* buff,
+                                        const char* eof,
+                                        size_t chunkSize)
+{
+    std::vector<SplitPoint> points;
+    std::vector<size_t> indents { 0 };
+    const char* wanted = buff + chunkSize;
+    uint8_t brackets = 0;
+    uint8_t indent = 0;
+    bool atLineStart = true;
+    bool lineStart = true;
+    bool continued = false;
+    int line = 0;
+
+    const char* p = buff;
+    while (p < eof) {
+        if (lineStart) {
+            lineStart = false;
+            if (atLineStart) {
+                if (!continued && p >= wanted) {
+                    points.push_back(SplitPoint{ p, line, indents });
+                    wanted = p + chunkSize;
+                }
+                const char* q = p;
+                while (q < eof && (*q == ' ' || *q == '\t'))
+                    ++q;
+                if (q < eof && *q != '#' && *q != '\n') {
+                    indent += static_cast<uint8_t>(q - p);
+                    if (indent > indents.back()) {
+                        indents.push_back(indent);
+                    } else {
+                        while (indent < indents.back() && indents.size() > 1)
+                            indents.pop_back();
+                    }
+                }
+                p = q;
+                continue;
+            }
+        }
+        continued = false;
+
+        if (!atLineStart)
+            p = skipPlainCode(p, eof);
+        if (p == eof)
+            break;
+
+        const char ch = *p;
+        switch (ch) {
+        case '\n':
+            ++line;
+            ++p;
+            indent = 0;
+            if (!brackets)
+                atLineStart = true;
+            lineStart = true;
+            break;
+
+        case ' ':
+        case '\t':
+        case '\f':
+            ++p;
+            break;
+
+        case '#':
+            p = static_cast<const char*>(std::memchr(p, '\n', eof - p));
+            if (!p)
+                p = eof;
+            break;
+
+        case '\\':
+            if (p + 1 < eof && p[1] == '\n') {
+                ++line;
+                p += 2;
+                lineStart = true;
+                continued = true;
+                break;
+            }
+            ++p;
+            atLineStart = false;
+            break;
+
+        case '"':
+        case '\'': {
+            atLineStart = false;
+            const bool triple = eof - p >= 3 && p[1] == ch && p[2] == ch;
+            p += triple ? 3 : 1;
+            while (p < eof) {
+                p = skipPlainStrLit(p, eof, ch);
+                if (p == eof)
+                    break;
+                if (*p == '\\') {
+                    ++p;
+                    if (p < eof && *p == '\n') {
+                        // A join, the lexer skips spaces without counting.
+                        while (p < eof && std::isspace(*p))
+                            ++p;
+                    } else if (p < eof) {
+                        ++p;
+                    }
+                    continue;
+                }
+                if (*p == '\n') {
+                    ++line;
+                    ++p;
+                    continue;
+                }
+                if (*p == ch) {
+                    if (!triple) {
+                        ++p;
+                        break;
+                    }
+                    if (eof - p >= 3 && p[1] == ch && p[2] == ch) {
+                        p += 3;
+                        break;
+                    }
+                }
+                ++p;
+            }
+            break;
+        }
+
+        case '(':
+        case '[':
+        case '{':
+            ++brackets;
+            ++p;
+            atLineStart = false;
+            break;
+
+        case ')':
+        case ']':
+        case '}':
+            --brackets;
+            ++p;
+            atLineStart = false;
+            break;
+
+        default:
+            ++p;
+            atLineStart = false;
+            break;
+        }
+    }
+
+    return points;
+}
+
+} // anonymous
+
+bool PyLexer::lexConcurrently(unsigned threadCnt, size_t minChunkSize)
+{
+    UAISO_ASSERT(context_, return false);
+    UAISO_ASSERT(lexed_.empty() && curr_ == buff_, return false);
+
+    if (context_->hasStopMark() || context_->phrasing())
+        return false;
+
+    const size_t len = eof_ - buff_;
+    if (threadCnt < 2 || minChunkSize == 0 || len / minChunkSize < 2)
+        return false;
+
+    const size_t chunkCnt = std::min<size_t>(threadCnt, len / minChunkSize);
+    std::vector<SplitPoint> points =
+            findSplitPoints(buff_, eof_, len / chunkCnt);
+    if (points.empty())
+        return false;
+    points.insert(points.begin(), SplitPoint{ buff_, 0, { 0 } });
+
+    // Every chunk gets its own context (so it may track its comment state
+    // independently), but lexemes and tokens go into the same maps, which
+    // are safe for concurrent insertion. The first chunk, lexed by this
+    // thread, reports straight to the sink; the others buffer their reports
+    // until they're joined, in source order.
+    std::vector<std::vector<LexedToken>> chunkTks(points.size());
+    std::vector<DiagnosticReports> chunkReports(points.size());
+    auto lexChunk = [&] (size_t idx) {
+        const SplitPoint& point = points[idx];
+        const bool last = idx + 1 == points.size();
+        const char* end = last ? eof_ : points[idx + 1].pos_;
+
+        ParsingContext context;
+        context.setFileName(context_->fileName());
+        context.setAllowComments(context_->allowComments());
+        context.collectLexemes(context_->lexemes());
+        context.collectTokens(context_->tokens());
+        context.collectReports(idx ? &chunkReports[idx] : context_->reports());
+
+        PyLexer lexer;
+        lexer.setContext(&context);
+        lexer.setBuffer(point.pos_, end - point.pos_);
+        lexer.line_ = point.line_;
+        lexer.bit_.midChunk_ = !last;
+        for (auto indent : point.indents_) {
+            if (indent)
+                lexer.indentStack_.push(indent);
+        }
+
+        auto& tks = chunkTks[idx];
+        Token tk;
+        do {
+            tk = lexer.lex();
+            if (tk == TK_EOP && !last)
+                break;
+            tks.push_back(LexedToken{ tk, lexer.line_, lexer.col_,
+                                      lexer.breaks_, lexer.rearLeng_,
+                                      lexer.mark_, lexer.curr_ });
+        } while (tk != TK_EOP);
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t idx = 1; idx < points.size(); ++idx)
+        threads.emplace_back(lexChunk, idx);
+    lexChunk(0);
+    for (size_t idx = 1; idx < points.size(); ++idx) {
+        threads[idx - 1].join();
+        for (const auto& report : chunkReports[idx])
+            context_->trackReport(report);
+    }
+
+    size_t total = 0;
+    for (const auto& tks : chunkTks)
+        total += tks.size();
+    lexed_.reserve(total);
+    for (const auto& tks : chunkTks)
+        lexed_.insert(lexed_.end(), tks.begin(), tks.end());
+    replay_ = lexed_.data();
+    replayEnd_ = replay_ + lexed_.size();
+
+    return true;
+}
+
+std::vector<size_t> PyLexer::splitAtTopLevelDecls(size_t chunkCnt) const
+{
+    if (lexed_.empty() || chunkCnt < 2)
+        return std::vector<size_t>();
+
+    // A split point is a def, a class, or the first decorator of them, at
+    // the start of a line with no indentation. Since the preceding statement
+    // has ended by then, each range parses independently.
+    std::vector<size_t> bounds { 0 };
+    const size_t target = lexed_.size() / chunkCnt;
+    size_t depth = 0;
+    bool lineStart = true;
+    bool decorated = false;
+    for (size_t idx = 0; idx < lexed_.size(); ++idx) {
+        const Token tk = lexed_[idx].tk_;
+        if (lineStart && !depth) {
+            bool split = false;
+            if (tk == TK_AT) {
+                split = !decorated;
+                decorated = true;
+            } else {
+                split = !decorated && (tk == TK_DEF || tk == TK_CLASS);
+                decorated = false;
+            }
+            if (split && idx - bounds.back() >= target && idx) {
+                bounds.push_back(idx);
+                if (bounds.size() == chunkCnt)
+                    break;
+            }
+        }
+
+        if (tk == TK_INDENT)
+            ++depth;
+        else if (tk == TK_DEDENT && depth)
+            --depth;
+        lineStart = tk == TK_NEWLINE || tk == TK_DEDENT;
+    }
+
+    if (bounds.size() < 2)
+        return std::vector<size_t>();
+    bounds.push_back(lexed_.size());
+
+    return bounds;
+}
+
+void PyLexer::replay(const PyLexer& lexer, size_t first, size_t last)
+{
+    UAISO_ASSERT(first <= last && last <= lexer.lexed_.size(), return);
+
+    replay_ = lexer.lexed_.data() + first;
+    replayEnd_ = lexer.lexed_.data() + last;
+}
+
 Token PyLexer::lexStrLit(char& ch)
 {
     UAISO_ASSERT(ch == '"' || ch == '\'', return TK_INVALID);
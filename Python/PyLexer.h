@@ -28,6 +28,7 @@
 #include "Common/Test.h"
 #include "Parsing/Lexer.h"
 #include <stack>
+#include <vector>
 
 namespace uaiso {
 
@@ -44,6 +45,48 @@ public:
 
     Token lex() override;
 
+    /*!
+     * \brief lexConcurrently
+     * \param threadCnt
+     * \param minChunkSize
+     * \return
+     *
+     * Lex the entire buffer upfront, split into chunks which are lexed
+     * concurrently, and return whether that was done. Chunks start at lines
+     * known to be outside strings and brackets, with the indentation context
+     * found by a pre-scan. Afterwards, lex hands out the buffered tokens.
+     * Diagnostics of a chunk are reported as soon as it (and the chunks
+     * before it) are done.
+     *
+     * Nothing is done if the buffer isn't large enough for two chunks, or if
+     * a stop mark is set or phrasing is collected in the context.
+     */
+    bool lexConcurrently(unsigned threadCnt, size_t minChunkSize = 256 * 1024);
+
+    /*!
+     * \brief splitAtTopLevelDecls
+     * \param chunkCnt
+     * \return
+     *
+     * Split the tokens lexed upfront into at most chunkCnt ranges of
+     * similar size. Ranges start only at a top-level (column 0) function or
+     * class definition, decorators included. The returned positions are the
+     * ranges' bounds, from 0 to the token count. If the tokens weren't lexed
+     * upfront, or there's no place to split, the result is empty.
+     */
+    std::vector<size_t> splitAtTopLevelDecls(size_t chunkCnt) const;
+
+    /*!
+     * \brief replay
+     * \param lexer
+     * \param first
+     * \param last
+     *
+     * Hand out the tokens, from first to last (exclusive), lexed upfront by
+     * another lexer, followed by the end of program.
+     */
+    void replay(const PyLexer& lexer, size_t first, size_t last);
+
 private:
     DECL_CLASS_TEST(PyLexer)
 
@@ -61,6 +104,7 @@ private:
         uint32_t indent_         : 8;
         uint32_t pendingDedent_  : 8;
         uint32_t brackets_       : 8;
+        uint32_t midChunk_       : 1;
     };
     union
     {
@@ -69,6 +113,21 @@ private:
     };
 
     std::stack<size_t> indentStack_;
+
+    //! A token lexed upfront, along with the lexer state that locates it.
+    struct LexedToken
+    {
+        Token tk_;
+        int line_;
+        int col_;
+        int breaks_;
+        int rearLeng_;
+        const char* mark_;
+        const char* curr_;
+    };
+    std::vector<LexedToken> lexed_;
+    const LexedToken* replay_ { nullptr };
+    const LexedToken* replayEnd_ { nullptr };
 };
 
 } // namespace uaiso
@@ -100,6 +100,7 @@ public:
              , &PyLexerTest::testCase64
              , &PyLexerTest::testCase65
              , &PyLexerTest::testCase66
+             , &PyLexerTest::testCase67
              )
 
     // Some test cases were taken from CPython.
@@ -170,6 +171,7 @@ public:
     void testCase64();
     void testCase65();
     void testCase66();
+    void testCase67();
 
     std::vector<Token> core(const std::string& code)
     {
@@ -180,6 +182,8 @@ public:
         PyLexer lexer;
         lexer.setContext(&context);
         lexer.setBuffer(code.c_str(), code.length());
+        if (chunkSize_)
+            UAISO_EXPECT_TRUE(lexer.lexConcurrently(4, chunkSize_));
         std::vector<Token> tks;
         while (true) {
             tks.push_back(lexer.lex());
@@ -211,12 +215,14 @@ public:
         dumpTokens_ = false;
         dumpLocs_ = false;
         keepComments_ = false;
+        chunkSize_ = 0;
         locs_.clear();
     }
 
     bool dumpTokens_ { false };
     bool dumpLocs_ { false };
     bool keepComments_ { false };
+    size_t chunkSize_ { 0 };
     std::vector<SourceLoc> locs_;
 };
 
@@ -1293,4 +1299,50 @@ void PyLexer::PyLexerTest::testCase66()
     UAISO_EXPECT_CONTAINER_EQ(expected, tks);
 }
 
+void PyLexer::PyLexerTest::testCase67()
+{
+    std::string piece = R"raw(
+class C:
+    def f(self, a,
+          b):  # A comment with "quotes"
+        s = """multi
+line ' " string"""
+        t = 'joined \
+  string'
+        if a and \
+   b:
+            return [1,
+  2]
+
+    x = { 'k': (a) }
+)raw";
+    std::string code;
+    for (int i = 0; i < 30; ++i)
+        code += piece;
+
+    // Lexing in chunks must be indistinguishable from lexing all at once.
+    auto tks = core(code);
+    auto locs = locs_;
+    locs_.clear();
+    chunkSize_ = 64;
+    auto chunkTks = core(code);
+
+    UAISO_EXPECT_INT_EQ(tks.size(), chunkTks.size());
+    UAISO_EXPECT_CONTAINER_EQ(tks, chunkTks);
+    UAISO_EXPECT_INT_EQ(locs.size(), locs_.size());
+    for (size_t i = 0; i < locs.size() && i < locs_.size(); ++i) {
+        UAISO_EXPECT_INT_EQ(locs[i].line_, locs_[i].line_);
+        UAISO_EXPECT_INT_EQ(locs[i].col_, locs_[i].col_);
+        UAISO_EXPECT_INT_EQ(locs[i].lastLine_, locs_[i].lastLine_);
+        UAISO_EXPECT_INT_EQ(locs[i].lastCol_, locs_[i].lastCol_);
+    }
+
+    // Too small to be split.
+    ParsingContext context;
+    PyLexer lexer;
+    lexer.setContext(&context);
+    lexer.setBuffer(piece.c_str(), piece.length());
+    UAISO_EXPECT_FALSE(lexer.lexConcurrently(4, piece.length()));
+}
+
 MAKE_CLASS_TEST(PyLexer)
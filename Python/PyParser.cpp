@@ -28,7 +28,9 @@
 #include "Common/Trace__.h"
 #include "Common/Util__.h"
 #include "Parsing/ParsingContext.h"
+#include <thread>
 #include <tuple>
+#include <vector>
 
 #define TRACE_NAME "PyParser"
 
@@ -89,13 +91,77 @@ bool PyParser::parse(Lexer* lexer, ParsingContext* context)
     setLexer(lexer);
     setContext(context);
     consumeToken();
-    StmtList stmts;
-    while (ahead_ != TK_EOP) {
-        if (maybeConsume(TK_NEWLINE))
-            continue;
-        appendOrCreate(stmts, parseStmt());
+    StmtList stmts = parseFileInput();
+    if (stmts) {
+        auto prog = std::unique_ptr<ProgramAst>(newAst<ProgramAst>());
+        prog->setStmts(std::move(stmts));
+        context->takeAst(std::unique_ptr<Ast>(prog.release()));
+        return true;
     }
 
+    return false;
+}
+
+bool PyParser::parseConcurrently(PyLexer* lexer,
+                                 ParsingContext* context,
+                                 unsigned threadCnt)
+{
+    UAISO_ASSERT(lexer, return false);
+    UAISO_ASSERT(context && context->fileName(), return false);
+
+    const std::vector<size_t> bounds = lexer->splitAtTopLevelDecls(threadCnt);
+    if (bounds.empty())
+        return parse(lexer, context);
+
+    // Every range is parsed with a lexer and a context of its own. Reports
+    // are kept aside, since a range's parse isn't necessarily the one of the
+    // program as a whole if there are errors. Ranges before the first one
+    // with reports are clean, so their statements are kept.
+    const size_t rangeCnt = bounds.size() - 1;
+    std::vector<StmtList> rangeStmts(rangeCnt);
+    std::vector<DiagnosticReports> rangeReports(rangeCnt);
+    auto parseRange = [&] (size_t idx) {
+        ParsingContext rangeContext;
+        rangeContext.setFileName(context->fileName());
+        rangeContext.collectReports(&rangeReports[idx]);
+
+        PyLexer rangeLexer;
+        rangeLexer.setContext(&rangeContext);
+        rangeLexer.replay(*lexer, bounds[idx], bounds[idx + 1]);
+
+        PyParser parser;
+        parser.setLexer(&rangeLexer);
+        parser.setContext(&rangeContext);
+        parser.consumeToken();
+        rangeStmts[idx] = parser.parseFileInput();
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t idx = 1; idx < rangeCnt; ++idx)
+        threads.emplace_back(parseRange, idx);
+    parseRange(0);
+    for (auto& thread : threads)
+        thread.join();
+
+    size_t cleanCnt = 0;
+    while (cleanCnt < rangeCnt && !rangeReports[cleanCnt].size())
+        ++cleanCnt;
+
+    StmtList stmts;
+    for (size_t idx = 0; idx < cleanCnt; ++idx)
+        mergeOrReplace(stmts, std::move(rangeStmts[idx]));
+
+    // The remainder is parsed sequentially, reporting to the actual context.
+    if (cleanCnt < rangeCnt) {
+        PyLexer restLexer;
+        restLexer.setContext(context);
+        restLexer.replay(*lexer, bounds[cleanCnt], bounds.back());
+
+        setLexer(&restLexer);
+        setContext(context);
+        consumeToken();
+        mergeOrReplace(stmts, parseFileInput());
+    }
     if (stmts) {
         auto prog = std::unique_ptr<ProgramAst>(newAst<ProgramAst>());
         prog->setStmts(std::move(stmts));
@@ -106,6 +172,20 @@ bool PyParser::parse(Lexer* lexer, ParsingContext* context)
     return false;
 }
 
+/*
+ * file_input: (NEWLINE | stmt)* ENDMARKER
+ */
+Parser::StmtList PyParser::parseFileInput()
+{
+    StmtList stmts;
+    while (ahead_ != TK_EOP) {
+        if (maybeConsume(TK_NEWLINE))
+            continue;
+        appendOrCreate(stmts, parseStmt());
+    }
+    return stmts;
+}
+
 /*
  * stmt: simple_stmt | compound_stmt
  * simple_stmt: small_stmt (';' small_stmt)* [';'] NEWLINE
@@ -1557,20 +1637,22 @@ Parser::Expr PyParser::parseAtom()
 
     case TK_INT_LIT:
         consumeToken();
-        return NumLitExprAst::create(prevLoc_, NumLitVariety::IntFormat);
+        return NumLitExprAst::create(prevLoc_, TK_INT_LIT, NumLitVariety::IntFormat);
 
     case TK_FLOAT_LIT:
         consumeToken();
-        return NumLitExprAst::create(prevLoc_, NumLitVariety::FloatFormat);
+        return NumLitExprAst::create(prevLoc_, TK_FLOAT_LIT, NumLitVariety::FloatFormat);
 
     case TK_NULL_VALUE:
         consumeToken();
-        return NullLitExprAst::create(prevLoc_);
+        return NullLitExprAst::create(prevLoc_, TK_NULL_VALUE);
 
     case TK_TRUE_VALUE:
-    case TK_FALSE_VALUE:
+    case TK_FALSE_VALUE: {
+        auto tk = ahead_;
         consumeToken();
-        return BoolLitExprAst::create(prevLoc_);
+        return BoolLitExprAst::create(prevLoc_, tk);
+    }
 
     case TK_STR_LIT:
         return parseStrLit();
@@ -1875,7 +1957,7 @@ Parser::Expr PyParser::parseStrLit()
     UAISO_ASSERT(ahead_ == TK_STR_LIT, return Expr());
 
     consumeToken();
-    auto str = StrLitExprAst::create(prevLoc_);
+    auto str = StrLitExprAst::create(prevLoc_, TK_STR_LIT);
     if (ahead_ == TK_STR_LIT) {
         auto concat = ConcatExprAst::create();
         concat->setExpr1(std::move(str));
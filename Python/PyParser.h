@@ -34,6 +34,7 @@ namespace uaiso {
 
 class Lexer;
 class ParsingContext;
+class PyLexer;
 
 /*!
  * \brief The PyParser class
@@ -47,6 +48,25 @@ public:
 
     bool parse(Lexer* lexer, ParsingContext* context) override;
 
+    /*!
+     * \brief parseConcurrently
+     * \param lexer
+     * \param context
+     * \param threadCnt
+     * \return
+     *
+     * Parse the program in ranges of top-level declarations, each one on its
+     * own thread, and splice the statements together in source order. This
+     * requires the tokens to have been lexed upfront (see
+     * PyLexer::lexConcurrently), otherwise the parse is sequential.
+     *
+     * Should a range report a diagnostic, the program is parsed sequentially
+     * from that range on, with diagnostics going to the context as they're
+     * found, so they're exactly those of parse.
+     */
+    bool parseConcurrently(PyLexer* lexer, ParsingContext* context,
+                           unsigned threadCnt);
+
 private:
     DECL_CLASS_TEST(PyParser)
 
@@ -88,6 +108,7 @@ private:
 
     //--- Statements ---//
 
+    StmtList parseFileInput();
     Stmt parseStmt();
     Stmt parseSimpleStmt();
     Stmt parseSmallStmt();
@@ -26,6 +26,12 @@
 #include "Python/PyLang.h"
 #include "Parsing/LangId.h"
 #include "Parsing/ParserTest.h"
+#include "Ast/AstHasher.h"
+#include "Ast/AstLocator.h"
+#include "Ast/AstVisitor.h"
+#include "Parsing/Lang.h"
+#include "Parsing/TokenMap.h"
+#include "Parsing/Unit.h"
 
 using namespace uaiso;
 
@@ -192,9 +198,11 @@ public:
              , &PyParserTest::testcase154
              , &PyParserTest::testcase155
              , &PyParserTest::testcase156
-             , &PyParserTest::testcase157
              , &PyParserTest::testcase158
              , &PyParserTest::testcase159
+             , &PyParserTest::testcase160
+             , &PyParserTest::testcase161
+             , &PyParserTest::testcase162
             )
 
     void testCase1();
@@ -353,9 +361,14 @@ public:
     void testcase154();
     void testcase155();
     void testcase156();
-    void testcase157();
     void testcase158();
     void testcase159();
+    void testcase160();
+    void testcase161();
+    void testcase162();
+
+    std::string parseAndDump(const std::string& code, bool concurrently,
+                             DiagnosticReports* reports);
 };
 
 MAKE_CLASS_TEST(PyParser)
@@ -1380,18 +1393,336 @@ void PyParser::PyParserTest::testcase155()
     core("[1,]\n");
 }
 
+namespace {
+
+struct RecordingSink : DiagnosticSink
+{
+    void report(const DiagnosticReport& report) override
+    {
+        locs_.push_back(report.sourceLoc().lineCol());
+    }
+
+    std::vector<LineCol> locs_;
+};
+
+} // anonymous
+
 void PyParser::PyParserTest::testcase156()
 {
+    // Diagnostics are streamed to a sink instead of buffered.
+    RecordingSink sink;
+    LexemeMap lexs;
+    TokenMap tokens;
+    std::unique_ptr<Unit> unit(FactoryCreator::create(LangId::Py)->makeUnit());
+    unit->setFileName("/testfile");
+    std::string code = "print x and\n";
+    unit->assignInput(code);
+    unit->collectDiagnostics(&sink);
+    unit->parse(&tokens, &lexs);
+
+    UAISO_EXPECT_TRUE(!sink.locs_.empty());
+    std::unique_ptr<DiagnosticReports> reports(unit->releaseReports());
+    UAISO_EXPECT_INT_EQ(0, reports->size());
 }
 
-void PyParser::PyParserTest::testcase157()
+namespace {
+
+class LitTokens final : public AstVisitor<LitTokens>
 {
-}
+public:
+    std::vector<Token> tks_;
+
+private:
+    friend class AstVisitor<LitTokens>;
+
+    VisitResult visitNumLitExpr(NumLitExprAst* ast)
+    {
+        tks_.push_back(ast->litTk());
+        return Continue;
+    }
+
+    VisitResult visitBoolLitExpr(BoolLitExprAst* ast)
+    {
+        tks_.push_back(ast->litTk());
+        return Continue;
+    }
+
+    VisitResult visitNullLitExpr(NullLitExprAst* ast)
+    {
+        tks_.push_back(ast->litTk());
+        return Continue;
+    }
+
+    VisitResult visitStrLitExpr(StrLitExprAst* ast)
+    {
+        tks_.push_back(ast->litTk());
+        return Continue;
+    }
+};
+
+} // anonymous
 
 void PyParser::PyParserTest::testcase158()
 {
+    // Literals carry their tokens, without a token map.
+    auto factory = FactoryCreator::create(LangId::Py);
+    LexemeMap lexs;
+    std::unique_ptr<Unit> unit(factory->makeUnit());
+    unit->setFileName("/testfile");
+    std::string code = "a = 1\nb = 2.0\nc = False\nd = None\ne = 'e'\n";
+    unit->assignInput(code);
+    unit->parse(nullptr, &lexs);
+    UAISO_EXPECT_TRUE(unit->ast());
+
+    LitTokens lits;
+    traverseProgram(Program_Cast(unit->ast()), &lits, factory->makeLang().get());
+    UAISO_EXPECT_INT_EQ(5, lits.tks_.size());
+    UAISO_EXPECT_INT_EQ(TK_INT_LIT, lits.tks_[0]);
+    UAISO_EXPECT_INT_EQ(TK_FLOAT_LIT, lits.tks_[1]);
+    UAISO_EXPECT_INT_EQ(TK_FALSE_VALUE, lits.tks_[2]);
+    UAISO_EXPECT_INT_EQ(TK_NULL_VALUE, lits.tks_[3]);
+    UAISO_EXPECT_INT_EQ(TK_STR_LIT, lits.tks_[4]);
 }
 
 void PyParser::PyParserTest::testcase159()
 {
 }
+
+namespace {
+
+class AllAsts final : public AstVisitor<AllAsts>
+{
+public:
+    VisitResult visitName(NameAst* ast) { return collect(ast); }
+    VisitResult visitSpec(SpecAst* ast) { return collect(ast); }
+    VisitResult visitAttr(AttrAst* ast) { return collect(ast); }
+    VisitResult visitDecl(DeclAst* ast) { return collect(ast); }
+    VisitResult visitExpr(ExprAst* ast) { return collect(ast); }
+    VisitResult visitStmt(StmtAst* ast) { return collect(ast); }
+
+    VisitResult collect(Ast* ast)
+    {
+        asts_.push_back(ast);
+        return Continue;
+    }
+
+    std::vector<Ast*> asts_;
+};
+
+} // anonymous
+
+void PyParser::PyParserTest::testcase161()
+{
+    // Spans are cached while parsing, and they match the computed ones.
+    auto factory = FactoryCreator::create(LangId::Py);
+    LexemeMap lexs;
+    std::unique_ptr<Unit> unit(factory->makeUnit());
+    unit->setFileName("/testfile");
+    std::string code = R"raw(
+import os.path
+class A(object):
+    def f(self, a, b=[1, 2]):
+        if a:
+            return self.g(a)[0]
+        elif b:
+            return lambda x: x + b
+        else:
+            return {'a': a, 'b': (b, not a)}
+x = A().f(1, 2 * 3 - 4).y
+)raw";
+    unit->assignInput(code);
+    unit->parse(nullptr, &lexs);
+    UAISO_EXPECT_TRUE(unit->ast());
+
+    AllAsts all;
+    traverseProgram(Program_Cast(unit->ast()), &all, factory->makeLang().get());
+    UAISO_EXPECT_TRUE(all.asts_.size() > 40);
+
+    auto locator = factory->makeAstLocator();
+    std::vector<SourceLoc> locs;
+    for (auto ast : all.asts_) {
+        UAISO_EXPECT_TRUE(ast->hasSpan());
+        locs.push_back(fullLoc(ast, locator.get()));
+    }
+    for (auto ast : all.asts_)
+        ast->setSpan(nullptr, nullptr);
+    for (size_t i = 0; i < all.asts_.size(); ++i)
+        UAISO_EXPECT_TRUE(locs[i] == fullLoc(all.asts_[i], locator.get()));
+
+    // The last assignment.
+    auto it = std::find_if(all.asts_.rbegin(), all.asts_.rend(), [](Ast* ast) {
+        return ast->kind() == Ast::Kind::AssignExpr;
+    });
+    UAISO_EXPECT_TRUE(it != all.asts_.rend());
+    const SourceLoc& loc = locs[all.asts_.rend() - it - 1];
+    UAISO_EXPECT_INT_EQ(10, loc.line_);
+    UAISO_EXPECT_INT_EQ(0, loc.col_);
+    UAISO_EXPECT_INT_EQ(10, loc.lastLine_);
+    UAISO_EXPECT_INT_EQ(25, loc.lastCol_);
+}
+
+void PyParser::PyParserTest::testcase162()
+{
+    // Declarations are hashed while parsing, and a reparse is diffed.
+    auto factory = FactoryCreator::create(LangId::Py);
+    LexemeMap oldLexs;
+    std::unique_ptr<Unit> oldUnit(factory->makeUnit());
+    oldUnit->setFileName("/testfile");
+    std::string oldCode = R"raw(
+import os
+def f(a):
+    return a + 1
+class A(object):
+    def g(self):
+        return 1
+    def h(self):
+        pass
+x = 1
+def k():
+    pass
+)raw";
+    oldUnit->assignInput(oldCode);
+    oldUnit->parse(nullptr, &oldLexs);
+    UAISO_EXPECT_TRUE(oldUnit->ast());
+
+    LexemeMap newLexs;
+    std::unique_ptr<Unit> newUnit(factory->makeUnit());
+    newUnit->setFileName("/testfile");
+    std::string newCode = R"raw(
+import os
+def k():
+    pass
+class A(object):
+    def g(self):
+        return 2
+    def i(self):
+        pass
+x = 1
+def f(a):
+    return a + 1
+y = 2
+)raw";
+    newUnit->assignInput(newCode);
+    newUnit->parse(nullptr, &newLexs);
+    UAISO_EXPECT_TRUE(newUnit->ast());
+
+    auto oldProg = Program_Cast(oldUnit->ast());
+    auto newProg = Program_Cast(newUnit->ast());
+    for (auto stmt : *oldProg->stmts_)
+        UAISO_EXPECT_TRUE(stmt->hash());
+
+    // A moved function keeps its hash.
+    auto funcOf = [](ProgramAst* prog, size_t idx) {
+        for (auto stmt : *prog->stmts_) {
+            if (!idx--)
+                return DeclStmt_Cast(stmt)->decl_.get();
+        }
+        return static_cast<DeclAst*>(nullptr);
+    };
+    UAISO_EXPECT_TRUE(funcOf(oldProg, 1)->hash() == funcOf(newProg, 4)->hash());
+    UAISO_EXPECT_TRUE(funcOf(oldProg, 4)->hash() == funcOf(newProg, 1)->hash());
+    UAISO_EXPECT_TRUE(funcOf(oldProg, 1)->hash() != funcOf(oldProg, 4)->hash());
+    UAISO_EXPECT_TRUE(funcOf(oldProg, 2)->hash() != funcOf(newProg, 2)->hash());
+    UAISO_EXPECT_TRUE(funcOf(oldProg, 2)->nameHash() == funcOf(newProg, 2)->nameHash());
+
+    auto changes = diffPrograms(oldProg, newProg);
+    UAISO_EXPECT_INT_EQ(5, changes.size());
+    UAISO_EXPECT_TRUE(changes[0].kind_ == AstChange::Kind::Modified);
+    UAISO_EXPECT_TRUE(changes[0].newAst_->kind() == Ast::Kind::RecordDecl);
+    UAISO_EXPECT_INT_EQ(0, changes[0].depth_);
+    UAISO_EXPECT_TRUE(changes[1].kind_ == AstChange::Kind::Modified);
+    UAISO_EXPECT_TRUE(changes[1].oldAst_->kind() == Ast::Kind::FuncDecl);
+    UAISO_EXPECT_INT_EQ(1, changes[1].depth_);
+    UAISO_EXPECT_TRUE(changes[2].kind_ == AstChange::Kind::Added);
+    UAISO_EXPECT_TRUE(!changes[2].oldAst_);
+    UAISO_EXPECT_INT_EQ(1, changes[2].depth_);
+    UAISO_EXPECT_TRUE(changes[3].kind_ == AstChange::Kind::Removed);
+    UAISO_EXPECT_TRUE(!changes[3].newAst_);
+    UAISO_EXPECT_INT_EQ(1, changes[3].depth_);
+    UAISO_EXPECT_TRUE(changes[4].kind_ == AstChange::Kind::Added);
+    UAISO_EXPECT_TRUE(changes[4].newAst_->kind() == Ast::Kind::ExprStmt);
+    UAISO_EXPECT_INT_EQ(0, changes[4].depth_);
+
+    UAISO_EXPECT_TRUE(diffPrograms(newProg, newProg).empty());
+}
+
+std::string PyParser::PyParserTest::parseAndDump(const std::string& code,
+                                                 bool concurrently,
+                                                 DiagnosticReports* reports)
+{
+    ParsingContext context;
+    context.setFileName("/testfile");
+    context.collectReports(reports);
+    LexemeMap lexs;
+    context.collectLexemes(&lexs);
+
+    PyLexer lexer;
+    lexer.setContext(&context);
+    lexer.setBuffer(code.c_str(), code.length());
+    auto parser = FactoryCreator::create(LangId::Py)->makeParser();
+    if (concurrently) {
+        UAISO_EXPECT_TRUE(lexer.lexConcurrently(4, 64));
+        UAISO_EXPECT_TRUE(lexer.splitAtTopLevelDecls(4).size() > 2);
+        UAISO_EXPECT_TRUE(static_cast<PyParser*>(parser.get())->
+                          parseConcurrently(&lexer, &context, 4));
+    } else {
+        UAISO_EXPECT_TRUE(parser->parse(&lexer, &context));
+    }
+
+    std::unique_ptr<Ast> ast(context.releaseAst());
+    std::ostringstream oss;
+    AstDumper().dumpProgram(Program_Cast(ast.get()), oss);
+    return oss.str();
+}
+
+void PyParser::PyParserTest::testcase160()
+{
+    // Top-level declarations parsed concurrently make the same program.
+    std::string piece = R"raw(
+import os
+x = [1,
+     2]
+
+@decor
+@other(x)
+def f(a, *b):
+    if a:
+        return 1
+    return b
+
+class C(object):
+    def g(self):
+        pass
+
+for i in x:
+    print i
+)raw";
+    std::string code;
+    for (int i = 0; i < 20; ++i)
+        code += piece;
+
+    DiagnosticReports seqReports;
+    DiagnosticReports concReports;
+    UAISO_EXPECT_STR_EQ(parseAndDump(code, false, &seqReports),
+                        parseAndDump(code, true, &concReports));
+    UAISO_EXPECT_INT_EQ(0, concReports.size());
+
+    // With errors, diagnostics are those of a sequential parse (only the
+    // ranges from the first one with an error on are parsed again).
+    code.insert(10 * piece.length(), "x = 1 +\n");
+    code += "def h(a b):\n    pass\n";
+    code += piece;
+    DiagnosticReports seqErrReports;
+    DiagnosticReports concErrReports;
+    UAISO_EXPECT_STR_EQ(parseAndDump(code, false, &seqErrReports),
+                        parseAndDump(code, true, &concErrReports));
+    UAISO_EXPECT_TRUE(seqErrReports.size() > 0);
+    UAISO_EXPECT_INT_EQ(seqErrReports.size(), concErrReports.size());
+    auto seqIt = seqErrReports.begin();
+    auto concIt = concErrReports.begin();
+    for (; seqIt != seqErrReports.end(); ++seqIt, ++concIt) {
+        UAISO_EXPECT_INT_EQ(seqIt->code(), concIt->code());
+        UAISO_EXPECT_INT_EQ(seqIt->sourceLoc().line_, concIt->sourceLoc().line_);
+        UAISO_EXPECT_INT_EQ(seqIt->sourceLoc().col_, concIt->sourceLoc().col_);
+    }
+}
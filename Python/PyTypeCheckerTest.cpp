@@ -0,0 +1,166 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+#include "Semantic/TypeCheckerTest.h"
+#include "Parsing/Factory.h"
+#include "Parsing/Unit.h"
+
+using namespace uaiso;
+
+void TypeChecker::TypeCheckerTest::PyTestCase1()
+{
+    std::string code = R"raw(
+class A:
+    n = 1
+a = A()
+x = a.n
+)raw";
+
+    runCore(FactoryCreator::create(LangId::Py), code, "/test.py",
+            std::vector<Diagnostic::Code>(),
+            std::make_pair("x", Type::Kind::Int));
+}
+
+void TypeChecker::TypeCheckerTest::PyTestCase2()
+{
+    std::string code = R"raw(
+class B:
+    c = "c"
+class A:
+    b = B()
+x = A().b.c
+)raw";
+
+    runCore(FactoryCreator::create(LangId::Py), code, "/test.py",
+            std::vector<Diagnostic::Code>(),
+            std::make_pair("x", Type::Kind::Str));
+}
+
+void TypeChecker::TypeCheckerTest::PyTestCase3()
+{
+    std::string code = R"raw(
+class Base:
+    f = 1.5
+class Derived(Base):
+    pass
+x = Derived().f
+)raw";
+
+    runCore(FactoryCreator::create(LangId::Py), code, "/test.py",
+            std::vector<Diagnostic::Code>(),
+            std::make_pair("x", Type::Kind::Float));
+}
+
+void TypeChecker::TypeCheckerTest::PyTestCase4()
+{
+    std::string code = R"raw(
+class A:
+    n = 1
+a = A()
+x = a.unknown
+)raw";
+
+    runCore(FactoryCreator::create(LangId::Py), code, "/test.py",
+            std::vector<Diagnostic::Code>(),
+            std::make_pair("x", Type::Kind::Inferred));
+}
+
+void TypeChecker::TypeCheckerTest::PyTestCase5()
+{
+    std::string code = R"raw(
+class A:
+    pass
+def make():
+    a = None
+    a = A()
+    return a
+x = make()
+)raw";
+
+    runCore(FactoryCreator::create(LangId::Py), code, "/test.py",
+            std::vector<Diagnostic::Code>(),
+            std::make_pair("x", Type::Kind::Record));
+}
+
+void TypeChecker::TypeCheckerTest::PyTestCase6()
+{
+    std::string code = R"raw(
+def f():
+    return g()
+def g():
+    n = 1
+    n = 2.5
+    return n
+x = f()
+)raw";
+
+    runCore(FactoryCreator::create(LangId::Py), code, "/test.py",
+            std::vector<Diagnostic::Code>(),
+            std::make_pair("x", Type::Kind::Float));
+}
+
+void TypeChecker::TypeCheckerTest::PyTestCase7()
+{
+    std::string code = R"raw(
+def f():
+    v = 1
+    v = "v"
+    return v
+x = f()
+)raw";
+
+    runCore(FactoryCreator::create(LangId::Py), code, "/test.py",
+            std::vector<Diagnostic::Code>(),
+            std::make_pair("x", Type::Kind::Inferred));
+}
+
+void TypeChecker::TypeCheckerTest::PyTestCase8()
+{
+    // A long chain of binary expressions, whose type is decided at its
+    // very end.
+    std::string code = "x = 1";
+    for (int i = 0; i < 20000; ++i)
+        code += (i % 2) ? " + 1" : " - 1";
+    code += " + 2.5\n";
+
+    runCore(FactoryCreator::create(LangId::Py), code, "/test.py",
+            std::vector<Diagnostic::Code>(),
+            std::make_pair("x", Type::Kind::Float));
+}
+
+void TypeChecker::TypeCheckerTest::PyTestCase9()
+{
+    // A value is typed again once a local it uses is widened.
+    std::string code = R"raw(
+def f():
+    a = 1
+    b = a
+    c = b
+    a = 2.5
+    return c
+x = f()
+)raw";
+
+    runCore(FactoryCreator::create(LangId::Py), code, "/test.py",
+            std::vector<Diagnostic::Code>(),
+            std::make_pair("x", Type::Kind::Float));
+}
@@ -22,13 +22,17 @@
 /*--------------------------*/
 
 #include "Python/PyUnit.h"
+#include "Python/PyAstLocator.h"
 #include "Python/PyLexer.h"
 #include "Python/PyParser.h"
 #include "Ast/Ast.h"
+#include "Ast/AstHasher.h"
+#include "Common/AllocStats.h"
 #include "Parsing/ParsingContext.h"
 #include "Parsing/Diagnostic.h"
 #include "Parsing/Token.h"
 #include "Parsing/Unit__.h"
+#include <thread>
 
 #define TRACE_NAME "PyUnit"
 
@@ -38,11 +42,13 @@ void PyUnit::parseCore(TokenMap* tokens,
                        LexemeMap* lexs,
                        ParsingContext* context)
 {
+    AllocStats::Phase phase("parse", P->fullFileName_);
+
     P->ast_.reset(nullptr);
 
     context->collectLexemes(lexs);
     context->collectTokens(tokens);
-    context->collectReports(P->reports_.get());
+    context->collectReports(P->sink());
     context->setFileName(P->fullFileName_.c_str());
 
     PyLexer lexer;
@@ -59,11 +65,18 @@ void PyUnit::parseCore(TokenMap* tokens,
         lexer.setBuffer(P->source_->c_str(), P->source_->size());
     }
 
+    // Large inputs are lexed upfront, in chunks, by several threads. Then
+    // their top-level declarations are parsed concurrently too.
+    const unsigned threadCnt = std::thread::hardware_concurrency();
+    lexer.lexConcurrently(threadCnt);
 
     PyParser parser;
-    bool success = parser.parse(&lexer, context);
-    if (success)
+    bool success = parser.parseConcurrently(&lexer, context, threadCnt);
+    if (success) {
         P->ast_.reset(context->releaseAst());
+        PyAstLocator().cacheSpans(Program_Cast(P->ast_.get()));
+        AstHasher(lexs, P->fullFileName_).hashProgram(Program_Cast(P->ast_.get()));
+    }
 }
 
 void PyUnit::parse(TokenMap* tokens, LexemeMap* lexs)
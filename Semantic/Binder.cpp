@@ -35,8 +35,10 @@
 #include "Ast/Ast.h"
 #include "Ast/AstLocator.h"
 #include "Ast/AstVariety.h"
+#include "Common/AllocStats.h"
 #include "Common/Assert.h"
 #include "Common/FileInfo.h"
+#include "Common/LatencyStats.h"
 #include "Common/Trace__.h"
 #include "Parsing/Factory.h"
 #include "Parsing/LangId.h"
@@ -219,8 +221,16 @@ struct uaiso::Binder::BinderImpl
             reports_->add(std::forward<Args>(args)...);
     }
 
+    Token tokenAt(Token tk, const SourceLoc& loc) const
+    {
+        // Parsers record the token in the AST, the map is only a fallback.
+        if (tk != TK_INVALID || !tokens_)
+            return tk;
+        return tokens_->findAt(loc.fileName_, loc.lineCol());
+    }
+
     const LexemeMap* lexs_; //!< Lexeme map of all AST locations.
-    const TokenMap* tokens_;   //!< Token map of all AST locations.
+    const TokenMap* tokens_;   //!< Token map of all AST locations (optional).
 
     //! File name corresponding the to given AST.
     std::string fileName_;
@@ -243,6 +253,9 @@ struct uaiso::Binder::BinderImpl
     //! Symbol under process.
     std::stack<std::unique_ptr<Symbol>> sym_;
 
+    //! Parameter types of the param clause under process.
+    std::stack<std::vector<std::unique_ptr<Type>>> paramTys_;
+
     //! Language-specific AST sanitizer.
     std::unique_ptr<const Sanitizer> sanitizer_;
 
@@ -259,7 +272,7 @@ struct uaiso::Binder::BinderImpl
     std::unique_ptr<const Builtin> builtins_;
 
     //! Diagnostic reports collected.
-    DiagnosticReports* reports_;
+    DiagnosticSink* reports_;
 
     //! Program being constructed.
     std::unique_ptr<Program> program_;
@@ -293,7 +306,7 @@ void Binder::setTokens(const TokenMap* tokens)
     P->tokens_ = tokens;
 }
 
-void Binder::collectDiagnostics(DiagnosticReports* reports)
+void Binder::collectDiagnostics(DiagnosticSink* reports)
 {
     P->reports_ = reports;
 }
@@ -314,6 +327,10 @@ std::unique_ptr<Program> Binder::bind(ProgramAst* progAst,
     UAISO_ASSERT(progAst, return std::unique_ptr<Program>());
     UAISO_ASSERT(!fullFileName.empty(), return std::unique_ptr<Program>());
 
+    AllocStats::Phase phase("bind", fullFileName);
+    static const LatencyStats::Key bindKey("bind");
+    LatencyStats::Timer timer(bindKey);
+
     P->fileName_.assign(fullFileName);
     P->program_.reset(new Program(P->fileName_));
 
@@ -451,7 +468,7 @@ Binder::VisitResult Binder::visitInferredSpec(InferredSpecAst* ast)
 Binder::VisitResult Binder::visitBuiltinSpec(BuiltinSpecAst* ast)
 {
     const SourceLoc& loc = ast->keyLoc();
-    Token tk = P->tokens_->findAt(loc.fileName_, loc.lineCol());
+    Token tk = P->tokenAt(ast->keyTk(), loc);
 
     std::unique_ptr<Type> ty;
     switch (tk) {
@@ -639,7 +656,7 @@ Binder::VisitResult Binder::traverseNamedSpec(NamedSpecAst* ast)
 Binder::VisitResult Binder::visitVisibilityAttr(VisibilityAttrAst* ast)
 {
     const SourceLoc& loc = ast->keyLoc();
-    Token tk = P->tokens_->findAt(loc.fileName_, loc.lineCol());
+    Token tk = P->tokenAt(ast->keyTk(), loc);
 
     ENSURE_TOP_SYMBOL_IS_DECL;
     Decl* sym = DeclSymbol_Cast(P->sym_.top().get());
@@ -684,7 +701,7 @@ Binder::VisitResult Binder::visitAnnotAttr(AnnotAttrAst* ast)
 Binder::VisitResult Binder::visitDeclAttr(DeclAttrAst* ast)
 {
     const SourceLoc& loc = ast->keyLoc();
-    Token tk = P->tokens_->findAt(loc.fileName_, loc.lineCol());
+    Token tk = P->tokenAt(ast->keyTk(), loc);
 
     ENSURE_TOP_SYMBOL_IS_DECL;
     Decl* sym = TypeDecl_Cast(P->sym_.top().get());
@@ -742,7 +759,7 @@ Binder::VisitResult Binder::visitDeclAttr(DeclAttrAst* ast)
 Binder::VisitResult Binder::visitAutoAttr(AutoAttrAst* ast)
 {
     const SourceLoc& loc = ast->keyLoc();
-    Token tk = P->tokens_->findAt(loc.fileName_, loc.lineCol());
+    Token tk = P->tokenAt(ast->keyTk(), loc);
 
     ENSURE_TOP_SYMBOL_IS_DECL;
     Decl* sym = DeclSymbol_Cast(P->sym_.top().get());
@@ -771,7 +788,7 @@ Binder::VisitResult Binder::visitCodegenAttr(CodegenAttrAst* ast)
 Binder::VisitResult Binder::visitParamDirAttr(ParamDirAttrAst* ast)
 {
     const SourceLoc& loc = ast->keyLoc();
-    Token tk = P->tokens_->findAt(loc.fileName_, loc.lineCol());
+    Token tk = P->tokenAt(ast->keyTk(), loc);
 
     ENSURE_TOP_SYMBOL_IS(Param);
     Param* param = Param_Cast(P->sym_.top().get());
@@ -804,7 +821,7 @@ Binder::VisitResult Binder::visitParamDirAttr(ParamDirAttrAst* ast)
 Binder::VisitResult Binder::visitEvalStrategyAttr(EvalStrategyAttrAst* ast)
 {
     const SourceLoc& loc = ast->keyLoc();
-    Token tk = P->tokens_->findAt(loc.fileName_, loc.lineCol());
+    Token tk = P->tokenAt(ast->keyTk(), loc);
 
     ENSURE_TOP_SYMBOL_IS(Param);
     Param* param = Param_Cast(P->sym_.top().get());
@@ -834,7 +851,7 @@ Binder::VisitResult Binder::visitEvalStrategyAttr(EvalStrategyAttrAst* ast)
 Binder::VisitResult Binder::visitStorageClassAttr(StorageClassAttrAst* ast)
 {
     const SourceLoc& loc = ast->keyLoc();
-    Token tk = P->tokens_->findAt(loc.fileName_, loc.lineCol());
+    Token tk = P->tokenAt(ast->keyTk(), loc);
 
     ENSURE_TOP_SYMBOL_IS_DECL;
     Decl* sym = DeclSymbol_Cast(P->sym_.top().get());
@@ -870,7 +887,7 @@ Binder::VisitResult Binder::visitStorageClassAttr(StorageClassAttrAst* ast)
 Binder::VisitResult Binder::visitLinkageAttr(LinkageAttrAst* ast)
 {
     const SourceLoc& loc = ast->keyLoc();
-    Token tk = P->tokens_->findAt(loc.fileName_, loc.lineCol());
+    Token tk = P->tokenAt(ast->keyTk(), loc);
 
     ENSURE_TOP_SYMBOL_IS_VALUEDECL;
     ValueDecl* sym = ValueDecl_Cast(P->sym_.top().get());
@@ -900,7 +917,7 @@ Binder::VisitResult Binder::visitLinkageAttr(LinkageAttrAst* ast)
 Binder::VisitResult Binder::visitTypeQualAttr(TypeQualAttrAst* ast)
 {
     const SourceLoc& loc = ast->keyLoc();
-    Token tk = P->tokens_->findAt(loc.fileName_, loc.lineCol());
+    Token tk = P->tokenAt(ast->keyTk(), loc);
 
     ENSURE_NONEMPTY_TYPE_STACK;
     Type* ty = P->declTy_.top().get();
@@ -1114,21 +1131,44 @@ Binder::VisitResult Binder::traverseTemplateParamClauseDecl(TemplateParamClauseD
 
 Binder::VisitResult Binder::traverseParamGroupDecl(ParamGroupDeclAst* ast)
 {
-    if (!ast->decls() || !ast->spec())
+    // Every parameter contributes a type to the clause, even when it
+    // couldn't be bound (it's unnamed or its type is unspecified).
+    auto addParamType = [this](std::unique_ptr<Type> ty) {
+        if (!P->paramTys_.empty())
+            P->paramTys_.top().push_back(std::move(ty));
+    };
+
+    if (!ast->spec()) {
+        if (ast->decls()) {
+            for (auto it = ast->decls()->begin(); it != ast->decls()->end(); ++it)
+                addParamType(std::unique_ptr<Type>(new InferredType));
+        }
+        return Continue;
+    }
+
+    // The spec is shared by the group, so it's bound only once.
+    VIS_CALL(traverseSpec(ast->spec()));
+    ENSURE_NONEMPTY_TYPE_STACK;
+    std::unique_ptr<Type> groupTy = P->popDeclType<>();
+
+    if (!ast->decls()) {
+        addParamType(std::move(groupTy));
         return Continue;
+    }
 
     for (auto decl : *ast->decls()) {
         UAISO_ASSERT(decl->kind() == Ast::Kind::ParamDecl, return Abort);
         ParamDeclAst* paramDecl = ParamDecl_Cast(decl);
 
+        addParamType(std::unique_ptr<Type>(groupTy->clone()));
+        auto depth = P->sym_.size();
         VIS_CALL(traverseDecl(paramDecl));
+        if (P->sym_.size() == depth)
+            continue; // Anonymous
+
         ENSURE_TOP_SYMBOL_IS(Param);
         Param* param = Param_Cast(P->sym_.top().get());
-
-        VIS_CALL(traverseSpec(ast->spec()));
-        ENSURE_NONEMPTY_TYPE_STACK;
-        param->setValueType(P->popDeclType<>());
-
+        param->setValueType(std::unique_ptr<Type>(groupTy->clone()));
         P->env_.insertValueDecl(P->popSymbol<Param>());
     }
 
@@ -1308,9 +1348,26 @@ Binder::VisitResult Binder::traverseFuncDecl(FuncDeclAst* ast)
     if (P->lang_->hasFuncLevelScope())
         P->enterSubEnv();
 
-    VIS_CALL(traverseDecl(ast->paramClause()));
+    // A receiver turns the function into a method of the receiver's type.
+    // It's bound like a parameter, but it's not part of the signature.
+    if (ast->recv()) {
+        P->paramTys_.emplace();
+        VIS_CALL(traverseDecl(ast->recv()));
+        auto recvTys = std::move(P->paramTys_.top());
+        P->paramTys_.pop();
+        if (!recvTys.empty()) {
+            ENSURE_TOP_SYMBOL_IS(Func);
+            Func_Cast(P->sym_.top().get())->setRecvType(std::move(recvTys.front()));
+        }
+    }
 
+    P->paramTys_.emplace();
+    VIS_CALL(traverseDecl(ast->paramClause()));
     std::unique_ptr<FuncType> funcTy(new FuncType);
+    for (auto& paramTy : P->paramTys_.top())
+        funcTy->addParamType(std::move(paramTy));
+    P->paramTys_.pop();
+
     if (!P->lang_->requiresReturnTypeInference() && ast->result()) {
         VIS_CALL(traverseSpec(ast->result()));
         ENSURE_NONEMPTY_TYPE_STACK;
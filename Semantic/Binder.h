@@ -54,7 +54,8 @@ public:
      * \brief setTokens
      * \param tokens
      *
-     * Set the token map.
+     * Set the token map, which is optional: tokens are taken from the AST,
+     * the map is only consulted for nodes built without one.
      */
     void setTokens(const TokenMap* tokens);
 
@@ -65,7 +66,7 @@ public:
      * Set a diagnostic collector. If none is set, no diagnostics will be
      * collected.
      */
-    void collectDiagnostics(DiagnosticReports* reports);
+    void collectDiagnostics(DiagnosticSink* reports);
 
     /*!
      * \brief ignoreBuiltins
@@ -40,6 +40,7 @@ public:
     TEST_RUN(BinderTest
              // Go
              , &BinderTest::GoTestCase1
+             , &BinderTest::GoTestCase2
              // Python
              , &BinderTest::PyTestCase1
              , &BinderTest::PyTestCase2
@@ -53,11 +54,14 @@ public:
              , &BinderTest::PyTestCase10
              , &BinderTest::PyTestCase11
              , &BinderTest::PyTestCase12
+             , &BinderTest::PyTestCase13
+             , &BinderTest::PyTestCase14
              )
 
     //--- Go ---//
 
     void GoTestCase1();
+    void GoTestCase2();
 
     //--- Python ---//
 
@@ -74,6 +78,8 @@ public:
     void PyTestCase10();
     void PyTestCase11();
     void PyTestCase12();
+    void PyTestCase13();
+    void PyTestCase14();
 
 
     std::unique_ptr<Program> core(std::unique_ptr<Factory> factory,
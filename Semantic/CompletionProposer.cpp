@@ -30,7 +30,10 @@
 #include "Semantic/TypeResolver.h"
 #include "Ast/Ast.h"
 #include "Ast/AstVisitor.h"
+#include "Common/AllocStats.h"
 #include "Common/Assert.h"
+#include "Common/FileInfo.h"
+#include "Common/LatencyStats.h"
 #include "Common/Trace__.h"
 #include "Parsing/Factory.h"
 #include "Parsing/Lexeme.h"
@@ -245,6 +248,9 @@ struct uaiso::CompletionProposer::CompletionProposerImpl
 
     //! Type resolver.
     TypeResolver resolver_;
+
+    //! Snapshot whose revision member tables are valid for.
+    Snapshot snapshot_;
 };
 
 CompletionProposer::CompletionProposer(Factory *factory)
@@ -254,12 +260,24 @@ CompletionProposer::CompletionProposer(Factory *factory)
 CompletionProposer::~CompletionProposer()
 {}
 
+void CompletionProposer::setSnapshot(Snapshot snapshot)
+{
+    P->snapshot_ = snapshot;
+    P->resolver_.setSnapshot(snapshot);
+}
+
 CompletionProposer::Result
 CompletionProposer::propose(ProgramAst* progAst, const LexemeMap* lexs)
 {
     UAISO_ASSERT(progAst->program_,
                  return Result(Symbols(), CompletionAstNotFound));
 
+    AllocStats::Phase phase("complete", AllocStats::isAttached()
+                                ? progAst->program_->fileInfo().fullFileName()
+                                : std::string());
+    static const LatencyStats::Key completeKey("complete");
+    LatencyStats::Timer timer(completeKey);
+
     CompletionContext context(P->lang_.get());
     auto ok = context.analyse(progAst, lexs, progAst->program_->env());
 
@@ -302,8 +320,17 @@ CompletionProposer::propose(ProgramAst* progAst, const LexemeMap* lexs)
                      return Result(Symbols(), InternalError));
         const Type* ty = nullptr;
         for (auto ident : context.name_) {
-            auto tySym = env.searchTypeDecl(ident);
-            if (tySym) {
+            // Members of a record, inherited ones included, come from its
+            // table, where their resolved types are cached.
+            const Type* memberTy = nullptr;
+            if (ty && ty->kind() == Type::Kind::Record)
+                memberTy = ConstRecordType_Cast(ty)->memberType(ident, P->lang_.get(),
+                                                                 P->snapshot_);
+
+            auto tySym = memberTy ? nullptr : env.searchTypeDecl(ident);
+            if (memberTy) {
+                ty = memberTy;
+            } else if (tySym) {
                 ty = tySym->type();
             } else {
                 auto valSym = env.searchValueDecl(ident);
@@ -363,33 +390,13 @@ CompletionProposer::propose(ProgramAst* progAst, const LexemeMap* lexs)
             return Result(addExtraSyms(env.listDecls(), syms), Success);
         }
 
-        // Look into base classes.
+        // A record's members, including inherited ones, are in its table.
         Symbols syms;
-        addExtraSyms(env.listDecls(), syms);
-        std::stack<const Type*> allTy;
-        allTy.push(ty);
-        while (!allTy.empty()) {
-            const Type* curTy = allTy.top();
-            allTy.pop();
-            UAISO_ASSERT(curTy, return Result(Symbols(), InternalError));
-            if (curTy->kind() != Type::Kind::Record)
-                continue;
-
-            const RecordType* recTy = ConstRecordType_Cast(curTy);
-            for (auto base : recTy->bases()) {
-                auto baseTySym = env.searchTypeDecl(base->name());
-                if (!baseTySym)
-                    continue;
-
-                bool baseHasEnv;
-                Environment baseEnv;
-                std::tie(baseHasEnv, baseEnv) = envForType(baseTySym->type(), baseEnv);
-                if (baseHasEnv) {
-                    allTy.push(baseTySym->type());
-                    addExtraSyms(baseEnv.listDecls(), syms);
-                }
-            }
-        }
+        if (ty->kind() == Type::Kind::Record)
+            addExtraSyms(*ConstRecordType_Cast(ty)->members(P->lang_.get(), P->snapshot_),
+                         syms);
+        else
+            addExtraSyms(env.listDecls(), syms);
 
         if (P->lang_->isPurelyOO())
             P->addRootRecordDecls(lexs, env, syms);
@@ -67,6 +67,15 @@ public:
     using Symbols = std::vector<const Symbol*>;
     using Result = std::tuple<Symbols, ResultCode>;
 
+    /*!
+     * \brief setSnapshot
+     * \param snapshot
+     *
+     * Set the snapshot in which resolutions of elaborate types are memoized,
+     * and with which member tables of records are kept up-to-date.
+     */
+    void setSnapshot(Snapshot snapshot);
+
     Result propose(ProgramAst* ast, const LexemeMap* lexs);
 
 private:
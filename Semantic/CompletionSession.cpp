@@ -0,0 +1,205 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+
+#include "Semantic/CompletionSession.h"
+#include "Semantic/Manager.h"
+#include "Semantic/Program.h"
+#include "Semantic/Snapshot.h"
+#include "Semantic/Symbol.h"
+#include "Common/Assert.h"
+#include "Common/LatencyStats.h"
+#include "Common/Trace__.h"
+#include "Parsing/Lexeme.h"
+#include <algorithm>
+#include <cctype>
+
+#define TRACE_NAME "CompletionSession"
+
+using namespace uaiso;
+
+namespace {
+
+bool isIdentChar(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+const Ident* symbolName(const Symbol* sym)
+{
+    if (isDecl(sym))
+        return ConstDeclSymbol_Cast(sym)->name();
+    if (sym->kind() == Symbol::Kind::Namespace)
+        return ConstNamespace_Cast(sym)->name();
+    return nullptr;
+}
+
+} // anonymous
+
+struct uaiso::CompletionSession::CompletionSessionImpl
+{
+    CompletionSessionImpl(Manager* manager)
+        : manager_(manager)
+    {}
+
+    Manager* manager_;
+
+    // The completion context: the snapshot revision and where the identifier
+    // being completed starts, together with the code of its top-level
+    // declaration up to the identifier and the rest of the identifier's line.
+    std::string fileName_;
+    size_t revision_ { 0 };
+    int line_ { -1 };
+    size_t identBegin_ { std::string::npos };
+    std::string head_;
+    std::string tail_;
+
+    // The program the candidates were looked up from, kept alive.
+    std::shared_ptr<const Program> prog_;
+    CompletionProposer::Symbols candidates_;
+    size_t misses_ { 0 };
+
+    bool matches(const std::string& code,
+                 const std::string& fullFileName,
+                 size_t revision,
+                 int line,
+                 size_t identBegin,
+                 size_t identEnd,
+                 size_t lineEnd) const
+    {
+        if (identBegin_ == std::string::npos
+                || identBegin != identBegin_
+                || line != line_
+                || revision != revision_
+                || fullFileName != fileName_
+                || lineEnd - identEnd != tail_.size()) {
+            return false;
+        }
+        return !code.compare(identBegin - head_.size(), head_.size(), head_)
+                && !code.compare(identEnd, tail_.size(), tail_);
+    }
+};
+
+CompletionSession::CompletionSession(Manager* manager)
+    : P(new CompletionSessionImpl(manager))
+{
+    UAISO_ASSERT(manager, {});
+}
+
+CompletionSession::~CompletionSession()
+{}
+
+CompletionProposer::Result CompletionSession::complete(const std::string& code,
+                                                       const std::string& fullFileName,
+                                                       const LineCol& lineCol)
+{
+    using Result = CompletionProposer::Result;
+
+    size_t lineBegin = 0;
+    for (int line = lineCol.line_; line > 0; --line) {
+        lineBegin = code.find('\n', lineBegin);
+        if (lineBegin == std::string::npos)
+            return Result(CompletionProposer::Symbols(),
+                          CompletionProposer::CompletionAstNotFound);
+        ++lineBegin;
+    }
+    size_t lineEnd = std::min(code.find('\n', lineBegin), code.size());
+    size_t identEnd = std::min(lineBegin + lineCol.col_, lineEnd);
+    size_t identBegin = identEnd;
+    while (identBegin > lineBegin && isIdentChar(code[identBegin - 1]))
+        --identBegin;
+
+    if (!P->matches(code, fullFileName, P->manager_->snapshot().revision(),
+                    lineCol.line_, identBegin, identEnd, lineEnd)) {
+        // Candidates are proposed for the start of the identifier, so
+        // they aren't narrowed by what's typed.
+        ++P->misses_;
+        static const LatencyStats::Key sessionCacheMissesKey("session.cacheMisses");
+        LatencyStats::count(sessionCacheMissesKey);
+        LineCol identLineCol(lineCol.line_, int(identBegin - lineBegin));
+        std::shared_ptr<const Program> prog;
+        Result result = P->manager_->complete(code, fullFileName,
+                                              identLineCol, &prog);
+        if (std::get<1>(result) != CompletionProposer::Success) {
+            invalidate();
+            return result;
+        }
+
+        // Only the enclosing top-level declaration, which starts at the
+        // closest unindented line, is parsed again by the manager.
+        size_t declBegin = lineBegin;
+        while (declBegin > 0 && isBlank(code[declBegin])) {
+            size_t prevLineEnd = declBegin - 1;
+            declBegin = prevLineEnd ? code.rfind('\n', prevLineEnd - 1) + 1 : 0;
+        }
+
+        // Completing may process the file, which is a revision of its own.
+        P->fileName_ = fullFileName;
+        P->revision_ = P->manager_->snapshot().revision();
+        P->line_ = lineCol.line_;
+        P->identBegin_ = identBegin;
+        P->head_.assign(code, declBegin, identBegin - declBegin);
+        P->tail_.assign(code, identEnd, lineEnd - identEnd);
+        P->prog_ = std::move(prog);
+        P->candidates_ = std::move(std::get<0>(result));
+    } else {
+        DEBUG_TRACE("reuse %zu candidates\n", P->candidates_.size());
+        static const LatencyStats::Key sessionCacheHitsKey("session.cacheHits");
+        LatencyStats::count(sessionCacheHitsKey);
+    }
+
+    const char* prefix = code.data() + identBegin;
+    size_t prefixLen = identEnd - identBegin;
+    CompletionProposer::Symbols syms;
+    for (auto sym : P->candidates_) {
+        const Ident* name = symbolName(sym);
+        if (!prefixLen || (name && !name->str().compare(0, prefixLen,
+                                                        prefix, prefixLen))) {
+            syms.push_back(sym);
+        }
+    }
+
+    return Result(syms, CompletionProposer::Success);
+}
+
+void CompletionSession::invalidate()
+{
+    P->fileName_.clear();
+    P->revision_ = 0;
+    P->line_ = -1;
+    P->identBegin_ = std::string::npos;
+    P->head_.clear();
+    P->tail_.clear();
+    P->prog_.reset();
+    P->candidates_.clear();
+}
+
+size_t CompletionSession::misses() const
+{
+    return P->misses_;
+}
@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+
+#ifndef UAISO_COMPLETIONSESSION_H__
+#define UAISO_COMPLETIONSESSION_H__
+
+#include "Common/Config.h"
+#include "Common/LineCol.h"
+#include "Common/Pimpl.h"
+#include "Common/Test.h"
+#include "Semantic/CompletionProposer.h"
+#include <string>
+
+namespace uaiso {
+
+class Manager;
+
+/*!
+ * \brief The CompletionSession class
+ *
+ * Keep the candidates proposed for a completion context while the user
+ * types the identifier being completed: as long as the snapshot's revision,
+ * the identifier's position, and the code of its top-level declaration up
+ * to the end of the identifier's line don't change, candidates are filtered
+ * by the identifier's prefix instead of being proposed again. As in
+ * Manager::complete, other edits aren't seen until the file is processed.
+ *
+ * \note The program the candidates were looked up from is kept alive by
+ * the session, the others by the snapshot's revision being checked.
+ */
+class UAISO_API CompletionSession final
+{
+public:
+    CompletionSession(Manager* manager);
+    ~CompletionSession();
+
+    /*!
+     * \brief complete
+     * \param code
+     * \param fullFileName
+     * \param lineCol
+     * \return
+     *
+     * Propose completions for the identifier that ends at the given line
+     * and column of the code, with the spelling typed so far as prefix.
+     */
+    CompletionProposer::Result complete(const std::string& code,
+                                        const std::string& fullFileName,
+                                        const LineCol& lineCol);
+
+    /*!
+     * \brief invalidate
+     *
+     * Drop the cached candidates.
+     */
+    void invalidate();
+
+    /*!
+     * \brief misses
+     * \return
+     *
+     * Return how many completions couldn't reuse cached candidates.
+     */
+    size_t misses() const;
+
+private:
+    DECL_PIMPL(CompletionSession)
+    DECL_CLASS_TEST(CompletionSession)
+};
+
+} // namespace uaiso
+
+#endif
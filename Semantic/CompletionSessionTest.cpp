@@ -0,0 +1,169 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+
+#include "Semantic/CompletionSession.h"
+#include "Semantic/Manager.h"
+#include "Semantic/Snapshot.h"
+#include "Semantic/Symbol.h"
+#include "Parsing/Factory.h"
+#include "Parsing/Lang.h"
+#include "Parsing/Lexeme.h"
+#include "Parsing/LexemeMap.h"
+#include "Parsing/TokenMap.h"
+#include "Parsing/Unit.h"
+#include <algorithm>
+
+using namespace uaiso;
+
+class CompletionSession::CompletionSessionTest : public Test
+{
+public:
+    TEST_RUN(CompletionSessionTest
+             , &CompletionSessionTest::testCase1
+             , &CompletionSessionTest::testCase2
+             , &CompletionSessionTest::testCase3
+             )
+
+    void reset() override
+    {
+        factory_ = FactoryCreator::create(LangId::Py);
+        snapshot_ = Snapshot();
+        manager_.reset(new Manager);
+        manager_->config(factory_.get(), &tokens_, &lexs_, snapshot_);
+        manager_->setBehaviour(Manager::BehaviourFlag::IgnoreBuiltins);
+    }
+
+    void testCase1();
+    void testCase2();
+    void testCase3();
+
+    std::vector<std::string> names(const CompletionProposer::Result& result)
+    {
+        std::vector<std::string> names;
+        for (auto sym : std::get<0>(result)) {
+            if (isDecl(sym))
+                names.push_back(ConstDeclSymbol_Cast(sym)->name()->str());
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    std::string code(const std::string& typed)
+    {
+        return R"raw(
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+    def show(self):
+        pass
+
+p = Point()
+p.)raw" + typed + "\n";
+    }
+
+    std::unique_ptr<Factory> factory_;
+    TokenMap tokens_;
+    LexemeMap lexs_;
+    Snapshot snapshot_;
+    std::unique_ptr<Manager> manager_;
+};
+
+MAKE_CLASS_TEST(CompletionSession)
+
+void CompletionSession::CompletionSessionTest::testCase1()
+{
+    // Typing further filters the candidates proposed at first.
+    CompletionSession session(manager_.get());
+    auto result = session.complete(code(""), "/test.py", LineCol(9, 2));
+    UAISO_EXPECT_INT_EQ(CompletionProposer::Success, std::get<1>(result));
+    std::vector<std::string> expected { "__init__", "show", "x", "y" };
+    UAISO_EXPECT_TRUE(expected == names(result));
+    UAISO_EXPECT_INT_EQ(1, session.misses());
+
+    result = session.complete(code("s"), "/test.py", LineCol(9, 3));
+    expected = { "show" };
+    UAISO_EXPECT_TRUE(expected == names(result));
+    result = session.complete(code("sx"), "/test.py", LineCol(9, 4));
+    UAISO_EXPECT_TRUE(names(result).empty());
+    result = session.complete(code("x"), "/test.py", LineCol(9, 3));
+    expected = { "x" };
+    UAISO_EXPECT_TRUE(expected == names(result));
+    UAISO_EXPECT_INT_EQ(1, session.misses());
+}
+
+void CompletionSession::CompletionSessionTest::testCase2()
+{
+    // An edit in the identifier's line, another file, or a new revision of
+    // the snapshot drops the candidates; an edit past the line doesn't.
+    CompletionSession session(manager_.get());
+    session.complete(code("s"), "/test.py", LineCol(9, 3));
+    UAISO_EXPECT_INT_EQ(1, session.misses());
+
+    session.complete(code("s # c"), "/test.py", LineCol(9, 3));
+    UAISO_EXPECT_INT_EQ(2, session.misses());
+    session.complete(code("sh # c"), "/test.py", LineCol(9, 4));
+    UAISO_EXPECT_INT_EQ(2, session.misses());
+    auto result = session.complete(code("sh # c") + "q = 1\n", "/test.py",
+                                   LineCol(9, 4));
+    UAISO_EXPECT_INT_EQ(2, session.misses());
+    std::vector<std::string> expected { "show" };
+    UAISO_EXPECT_TRUE(expected == names(result));
+
+    session.complete(code("s"), "/other.py", LineCol(9, 3));
+    UAISO_EXPECT_INT_EQ(3, session.misses());
+
+    manager_->process("x = 1\n", "/another.py", LineCol());
+    session.complete(code("s"), "/other.py", LineCol(9, 3));
+    UAISO_EXPECT_INT_EQ(4, session.misses());
+
+    session.invalidate();
+    session.complete(code("s"), "/other.py", LineCol(9, 3));
+    UAISO_EXPECT_INT_EQ(5, session.misses());
+}
+
+void CompletionSession::CompletionSessionTest::testCase3()
+{
+    // An edit earlier in the enclosing declaration, even one that keeps
+    // every offset, drops the candidates.
+    std::string code = R"raw(
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+def f():
+    a = Point()
+    a.
+)raw";
+    CompletionSession session(manager_.get());
+    auto result = session.complete(code, "/test.py", LineCol(8, 6));
+    std::vector<std::string> expected { "__init__", "x", "y" };
+    UAISO_EXPECT_TRUE(expected == names(result));
+    UAISO_EXPECT_INT_EQ(1, session.misses());
+
+    code.replace(code.find("a = Point()"), 1, "b");
+    session.complete(code, "/test.py", LineCol(8, 6));
+    UAISO_EXPECT_INT_EQ(2, session.misses());
+}
@@ -76,16 +76,18 @@ CompletionProposer::CompletionProposerTest::runCore(
         std::cout << oss.str();
     }
 
-    Program* prog = snapshot.find(fullFileName);
+    auto prog = snapshot.find(fullFileName);
     UAISO_EXPECT_TRUE(prog);
     UAISO_EXPECT_FALSE(prog->env().isEmpty());
 
     TypeChecker checker(factory.get());
     checker.setLexemes(&lexs);
     checker.setTokens(&tokens);
+    checker.setSnapshot(snapshot);
     checker.check(progAst);
 
     CompletionProposer completer(factory.get());
+    completer.setSnapshot(snapshot);
     auto syms = std::get<0>(completer.propose(progAst, &lexs));
     if (dumpCompletions_) {
         std::ostringstream oss;
@@ -103,6 +105,13 @@ CompletionProposer::CompletionProposerTest::runCore(
     }
 
     UAISO_EXPECT_INT_EQ(expected.size(), syms.size());
+    if (ordered_) {
+        for (size_t i = 0; i < std::min(expected.size(), syms.size()); ++i) {
+            UAISO_EXPECT_TRUE(isDecl(syms[i]));
+            UAISO_EXPECT_STR_EQ(expected[i],
+                                ConstDeclSymbol_Cast(syms[i])->name()->str());
+        }
+    }
     for (const auto& s : expected) {
         UAISO_EXPECT_TRUE(std::find_if(syms.begin(), syms.end(),
                                        [s](auto sym) {
@@ -232,6 +232,7 @@ public:
         disableAutoModules_ = true;
         dumpAst_ = false;
         dumpCompletions_ = false;
+        ordered_ = false;
     }
 
     LineCol lineCol_;
@@ -239,6 +240,7 @@ public:
     bool disableAutoModules_ { true };
     bool dumpAst_ { false };
     bool dumpCompletions_ { false };
+    bool ordered_ { false };
 };
 
 } // namespace uaiso
@@ -173,6 +173,11 @@ bool Environment::isEmpty() const
     return P->isEmpty();
 }
 
+size_t Environment::hash() const
+{
+    return std::hash<const void*>()(P.get());
+}
+
 const Decl* Environment::searchDecl(const Ident* name) const
 {
     UAISO_ASSERT(name, return nullptr);
@@ -244,6 +249,14 @@ void Environment::detachOuterEnv()
     P->outer_.reset();
 }
 
+void Environment::attachOuterEnv(Environment env)
+{
+    UAISO_ASSERT(isRootEnv(), return);
+    UAISO_ASSERT(env.P != P, return);
+
+    P->outer_ = env.P;
+}
+
 void Environment::includeImport(std::unique_ptr<const Import> import)
 {
     P->imports_.push_back(std::move(import));
@@ -306,11 +319,28 @@ std::vector<const Decl*> Environment::listDecls() const
 
 void Environment::injectNamespace(std::unique_ptr<Namespace> sym, bool mergeEnv)
 {
-    if (mergeEnv)
+    // Dependencies are processed again when a program is refreshed, so the
+    // same namespace may be injected more than once.
+    if (mergeEnv
+            && std::find(P->mergedEnvs_.begin(), P->mergedEnvs_.end(),
+                         sym->env()) == P->mergedEnvs_.end()) {
         P->mergedEnvs_.push_back(sym->env());
+    }
+
+    if (sym->isAnonymous())
+        return;
+
+    auto range = P->namespaces_.table_.equal_range(sym->name());
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->env() == sym->env())
+            return;
+    }
+    P->namespaces_.insert(std::move(sym));
+}
 
-    if (!sym->isAnonymous())
-        P->namespaces_.insert(std::move(sym));
+const std::vector<Environment>& Environment::mergedEnvs() const
+{
+    return P->mergedEnvs_;
 }
 
 const Namespace* Environment::fetchNamespace(const Ident* name) const
@@ -53,6 +53,15 @@ public:
 
     bool isEmpty() const;
 
+    /*!
+     * \brief hash
+     * \return
+     *
+     * Return a hash of the environment's identity (not of its contents),
+     * consistent with the equality operator.
+     */
+    size_t hash() const;
+
     /*!
      * \brief takeOver
      * \param env
@@ -86,6 +95,15 @@ public:
      */
     void detachOuterEnv();
 
+    /*!
+     * \brief attachOuterEnv
+     * \param env
+     *
+     * Attach this root environment to the given outer environment, so
+     * lookups that fail here continue there.
+     */
+    void attachOuterEnv(Environment env);
+
     /*!
      * \brief outerEnv
      * \return
@@ -123,6 +141,17 @@ public:
      */
     void injectNamespace(std::unique_ptr<Namespace> sym, bool mergeEnv);
 
+    /*!
+     * \brief mergedEnvs
+     * \return
+     *
+     * Return the environments merged into this environment by namespace
+     * injection.
+     *
+     * \sa injectNamespace
+     */
+    const std::vector<Environment>& mergedEnvs() const;
+
     /*!
      * \brief fetchNamespace
      * \param name
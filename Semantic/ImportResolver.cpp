@@ -24,6 +24,7 @@
 #include "Semantic/ImportResolver.h"
 #include "Semantic/Import.h"
 #include "Common/FileInfo.h"
+#include "Common/LatencyStats.h"
 #include "Common/Util__.h"
 #include "Common/Trace__.h"
 #include "Tinydir/Tinydir.h"
@@ -122,6 +123,9 @@ std::vector<std::string> ImportResolver::
 resolve(Import* import,
         const std::vector<std::string>& searchPaths) const
 {
+    static const LatencyStats::Key resolveImportKey("resolveImport");
+    LatencyStats::Timer timer(resolveImportKey);
+
     std::unordered_set<std::string> selected;
     std::for_each(import->selectedItems().begin(),
                   import->selectedItems().end(),
@@ -23,30 +23,76 @@
 
 #include "Semantic/Manager.h"
 #include "Semantic/Binder.h"
+#include "Semantic/Environment.h"
 #include "Semantic/Import.h"
 #include "Semantic/ImportResolver.h"
+#include "Semantic/NameResolver.h"
 #include "Semantic/Program.h"
+#include "Semantic/ProgramImage.h"
 #include "Semantic/Snapshot.h"
 #include "Semantic/Symbol.h"
+#include "Semantic/TypeChecker.h"
+#include "Common/AllocStats.h"
 #include "Common/Assert.h"
 #include "Common/FileInfo.h"
+#include "Common/LatencyStats.h"
 #include "Common/Trace__.h"
 #include "Parsing/Factory.h"
+#include "Parsing/IncrementalLexer.h"
 #include "Parsing/Lexeme.h"
 #include "Parsing/LexemeMap.h"
+#include "Parsing/Outliner.h"
+#include "Parsing/Phrasing.h"
 #include "Parsing/TokenMap.h"
 #include "Parsing/Unit.h"
+#include <algorithm>
 #include <iostream>
+#include <mutex>
 #include <stack>
+#include <unordered_map>
 #include <unordered_set>
 
 #define TRACE_NAME "Manager"
 
 using namespace uaiso;
 
+namespace {
+
+/*!
+ * \brief lineOffset
+ * \return
+ *
+ * Return the offset at which the given line of the code starts, or npos
+ * if there's no such line. Lines are counted from the given offset.
+ */
+size_t lineOffset(const std::string& code, int line, size_t offset = 0)
+{
+    for (; line > 0; --line) {
+        offset = code.find('\n', offset);
+        if (offset == std::string::npos)
+            return offset;
+        ++offset;
+    }
+    return offset;
+}
+
+/*!
+ * \brief lineEnd
+ * \return
+ *
+ * Return the offset at which the line that starts at the given offset ends,
+ * including its line break.
+ */
+size_t lineEnd(const std::string& code, size_t offset)
+{
+    offset = code.find('\n', offset);
+    return offset == std::string::npos ? code.size() : offset + 1;
+}
+
+} // anonymous
+
 #define ENSURE_CONFIG \
     UAISO_ASSERT(P->factory_, return std::unique_ptr<Unit>()); \
-    UAISO_ASSERT(P->tokens_, return std::unique_ptr<Unit>()); \
     UAISO_ASSERT(P->lexs_, return std::unique_ptr<Unit>())
 
 struct uaiso::Manager::ManagerImpl
@@ -56,8 +102,129 @@ struct uaiso::Manager::ManagerImpl
     LexemeMap* lexs_ { nullptr };
     Snapshot snapshot_;
     std::vector<std::string> searchPaths_;
+    std::vector<std::shared_ptr<const ProgramImage>> images_;
+    std::unordered_set<std::string> core_; // Files processed explicitly.
+    std::mutex coreMutex_;
+    std::recursive_mutex depsMutex_;
+
+    bool isCore(const std::string& fullFileName)
+    {
+        std::lock_guard<std::mutex> lock(coreMutex_);
+        return core_.count(fullFileName) != 0;
+    }
+
+    // The files a tracked program imports and, reversely, the programs
+    // importing a file, as resolved when dependencies were last processed.
+    // Along with the programs that have an import not resolved to any file,
+    // that's what a refresh needs. Guarded by the dependencies mutex.
+    std::unordered_map<std::string, std::vector<std::string>> imported_;
+    std::unordered_map<std::string, std::unordered_set<std::string>> importers_;
+    std::unordered_set<std::string> unresolved_;
+
+    void untrackImports(const std::string& fullFileName)
+    {
+        auto it = imported_.find(fullFileName);
+        if (it != imported_.end()) {
+            for (const auto& target : it->second) {
+                auto importersIt = importers_.find(target);
+                if (importersIt == importers_.end())
+                    continue;
+                importersIt->second.erase(fullFileName);
+                if (importersIt->second.empty())
+                    importers_.erase(importersIt);
+            }
+            imported_.erase(it);
+        }
+        unresolved_.erase(fullFileName);
+    }
+
+    void trackImports(const std::string& fullFileName,
+                      std::vector<std::string> targets,
+                      bool hasUnresolved)
+    {
+        untrackImports(fullFileName);
+        for (const auto& target : targets)
+            importers_[target].insert(fullFileName);
+        imported_[fullFileName] = std::move(targets);
+        if (hasUnresolved)
+            unresolved_.insert(fullFileName);
+    }
     char behaviour_ { 0 };
 
+    /*!
+     * A file's last program processed completely, whose environment is
+     * reused for completion, along with the unit and program of the last
+     * completion (their symbols are the ones proposed). Completions of a
+     * file are serialized by the entry's mutex.
+     */
+    struct Completion
+    {
+        std::mutex mutex_;
+        bool bound_ { false };
+        std::string code_;
+        Environment env_;
+        bool outlined_ { false };
+        std::vector<int> declLines_; // Where top-level declarations start.
+        std::unique_ptr<Unit> unit_;
+        std::shared_ptr<Program> prog_;
+    };
+    std::unordered_map<std::string, std::shared_ptr<Completion>> completions_;
+    std::mutex completionsMutex_;
+
+    std::shared_ptr<Completion> completion(const std::string& fullFileName)
+    {
+        std::lock_guard<std::mutex> lock(completionsMutex_);
+        auto& cache = completions_[fullFileName];
+        if (!cache)
+            cache = std::make_shared<Completion>();
+        return cache;
+    }
+
+    void keepForCompletion(const std::string& code,
+                           const std::string& fullFileName)
+    {
+        auto prog = snapshot_.find(fullFileName);
+        UAISO_ASSERT(prog, return);
+
+        auto cache = completion(fullFileName);
+        std::lock_guard<std::mutex> lock(cache->mutex_);
+        cache->bound_ = true;
+        cache->code_ = code;
+        cache->env_ = prog->env();
+        cache->outlined_ = false;
+        cache->declLines_.clear();
+    }
+
+    void outline(Completion& cache)
+    {
+        cache.outlined_ = true;
+        auto lexer = factory_->makeIncrementalLexer();
+        if (!lexer)
+            return;
+
+        lexer->lex(cache.code_);
+        std::unique_ptr<Phrasing> phrasing(lexer->releasePhrasing());
+        Outliner outliner(factory_);
+        outliner.outline(cache.code_, phrasing.get());
+        for (const auto& entry : outliner.entries()) {
+            if (!entry.depth_)
+                cache.declLines_.push_back(entry.lineCol_.line_);
+        }
+    }
+
+    CompletionProposer::Result propose(Unit* unit)
+    {
+        TypeChecker checker(factory_);
+        checker.setLexemes(lexs_);
+        checker.setTokens(tokens_);
+        checker.setSnapshot(snapshot_);
+        checker.check(Program_Cast(unit->ast()));
+
+        CompletionProposer proposer(factory_);
+        proposer.setSnapshot(snapshot_);
+        return proposer.propose(Program_Cast(unit->ast()), lexs_);
+    }
+
     std::unique_ptr<Unit> parse(const std::string& code,
                                 FILE* file,
                                 const std::string& fullFileName,
@@ -82,7 +249,18 @@ struct uaiso::Manager::ManagerImpl
         return unit;
     }
 
-    std::unique_ptr<Program> bind(Unit* unit, bool isDep)
+    // Types inferred from a program's code are set to its symbols before
+    // the program is shared, they depend only on the file and its builtins.
+    void infer(Unit* unit)
+    {
+        TypeChecker checker(factory_);
+        checker.setLexemes(lexs_);
+        checker.setTokens(tokens_);
+        checker.setSnapshot(snapshot_);
+        checker.infer(Program_Cast(unit->ast()));
+    }
+
+    std::unique_ptr<Program> bind(Unit* unit, bool isDep, bool infer = true)
     {
         using Prog = std::unique_ptr<Program>;
 
@@ -97,7 +275,10 @@ struct uaiso::Manager::ManagerImpl
             binder.ignoreBuiltins();
         if (isDep || (flags & BehaviourFlag::IgnoreAutomaticModules))
             binder.ignoreAutomaticModules();
-        return binder.bind(Program_Cast(unit->ast()), unit->fileName());
+        auto prog = binder.bind(Program_Cast(unit->ast()), unit->fileName());
+        if (prog && infer)
+            this->infer(unit);
+        return prog;
     }
 };
 
@@ -119,11 +300,28 @@ void Manager::config(Factory *factory,
     P->snapshot_ = snapshot;
 }
 
+Snapshot Manager::snapshot() const
+{
+    return P->snapshot_;
+}
+
 void Manager::addSearchPath(const std::string& searchPath)
 {
     P->searchPaths_.push_back(searchPath);
 }
 
+const std::vector<std::string>& Manager::searchPaths() const
+{
+    return P->searchPaths_;
+}
+
+void Manager::addProgramImage(std::shared_ptr<const ProgramImage> image)
+{
+    UAISO_ASSERT(image, return);
+
+    P->images_.push_back(std::move(image));
+}
+
 void Manager::setBehaviour(BehaviourFlags flags)
 {
     P->behaviour_ = flags;
@@ -134,15 +332,34 @@ Manager::BehaviourFlags Manager::behaviour() const
     return BehaviourFlags(P->behaviour_);
 }
 
-void Manager::processCore(Unit* unit)
+bool Manager::processCore(Unit* unit)
 {
-    std::unique_ptr<Program> prog = P->bind(unit, false);
+    std::shared_ptr<Program> prog = P->bind(unit, false);
     if (!prog)
-        return;
+        return false;
+
+    // Dependencies are processed one file at a time. Otherwise, the one of
+    // another file could replace this program after looking it up and not
+    // finding it. Binding and name resolution happen concurrently, the
+    // program is kept alive here even if it's replaced meanwhile.
+    {
+        std::lock_guard<std::recursive_mutex> lock(P->depsMutex_);
 
-    P->snapshot_.insertOrReplace(unit->fileName(), std::move(prog));
+        P->snapshot_.insertOrReplace(unit->fileName(), prog);
+        {
+            std::lock_guard<std::mutex> lock(P->coreMutex_);
+            P->core_.insert(unit->fileName());
+        }
 
-    processDeps(unit->fileName());
+        processDeps(unit->fileName());
+    }
+
+    // With dependencies in place, the environment is complete and name uses
+    // can be annotated.
+    NameResolver resolver(P->factory_);
+    resolver.resolve(Program_Cast(unit->ast()), P->lexs_);
+
+    return true;
 }
 
 std::unique_ptr<Unit> Manager::process(const std::string& code,
@@ -157,11 +374,17 @@ std::unique_ptr<Unit> Manager::process(const std::string& code,
 {
     ENSURE_CONFIG;
 
+    static const LatencyStats::Key processKey("process");
+    LatencyStats::Timer timer(processKey);
+    static const LatencyStats::Key processFilesKey("process.files");
+    LatencyStats::count(processFilesKey);
+
     std::unique_ptr<Unit> unit = P->parse(code, nullptr, fullFileName, lineCol);
     if (!unit->ast())
         return unit;
 
-    processCore(unit.get());
+    if (processCore(unit.get()) && lineCol.isEmpty())
+        P->keepForCompletion(code, fullFileName);
 
     return unit;
 }
@@ -171,6 +394,11 @@ std::unique_ptr<Unit> Manager::process(FILE* file,
 {
     ENSURE_CONFIG;
 
+    static const LatencyStats::Key processKey("process");
+    LatencyStats::Timer timer(processKey);
+    static const LatencyStats::Key processFilesKey("process.files");
+    LatencyStats::count(processFilesKey);
+
     std::unique_ptr<Unit> unit = P->parse("", file, fullFileName);
     if (!unit->ast())
         return unit;
@@ -180,34 +408,192 @@ std::unique_ptr<Unit> Manager::process(FILE* file,
     return unit;
 }
 
+CompletionProposer::Result Manager::complete(const std::string& code,
+                                             const std::string& fullFileName,
+                                             const LineCol& lineCol)
+{
+    return complete(code, fullFileName, lineCol, nullptr);
+}
+
+CompletionProposer::Result Manager::complete(const std::string& code,
+                                             const std::string& fullFileName,
+                                             const LineCol& lineCol,
+                                             std::shared_ptr<const Program>* prog)
+{
+    using Result = CompletionProposer::Result;
+
+    UAISO_ASSERT(P->factory_, return Result());
+    UAISO_ASSERT(P->lexs_, return Result());
+
+    static const LatencyStats::Key managerCompleteKey("managerComplete");
+    LatencyStats::Timer timer(managerCompleteKey);
+
+    auto entry = P->completion(fullFileName);
+    std::lock_guard<std::mutex> entryLock(entry->mutex_);
+    ManagerImpl::Completion& cache = *entry;
+    if (cache.bound_ && !cache.outlined_)
+        P->outline(cache);
+
+    // The declaration enclosing the cursor is the last top-level one that
+    // starts before it, provided it still starts where it used to.
+    size_t begin = std::string::npos;
+    auto decl = std::upper_bound(cache.declLines_.begin(),
+                                 cache.declLines_.end(), lineCol.line_);
+    if (decl != cache.declLines_.begin()) {
+        --decl;
+        size_t goodBegin = lineOffset(cache.code_, *decl);
+        begin = lineOffset(code, *decl);
+        if (begin != std::string::npos
+                && code.compare(begin, lineEnd(code, begin) - begin,
+                                cache.code_, goodBegin,
+                                lineEnd(cache.code_, goodBegin) - goodBegin)) {
+            begin = std::string::npos;
+        }
+    }
+
+    std::unique_ptr<Unit> unit;
+    std::unique_ptr<Program> snippetProg;
+    if (begin != std::string::npos) {
+        size_t end = lineOffset(code, lineCol.line_ - *decl, begin);
+        if (end != std::string::npos) {
+            // Lines before the first declaration (say, a package clause) are
+            // kept, the others are left blank so positions are preserved.
+            int headerLines = cache.declLines_.front();
+            std::string snippet = cache.code_.substr(
+                        0, lineOffset(cache.code_, headerLines));
+            snippet.append(*decl - headerLines, '\n');
+            end = lineEnd(code, end);
+            snippet.append(code, begin, end - begin);
+
+            unit = P->parse(snippet, nullptr, fullFileName, lineCol);
+            if (unit->ast())
+                snippetProg = P->bind(unit.get(), true, false);
+        }
+    }
+
+    Result result(CompletionProposer::Symbols(),
+                  CompletionProposer::CompletionAstNotFound);
+    if (snippetProg) {
+        // The cached environment is shared with the snapshot.
+        std::lock_guard<std::recursive_mutex> lock(P->depsMutex_);
+
+        Environment env = snippetProg->env();
+        while (!env.isRootEnv())
+            env = env.outerEnv();
+
+        // The snippet's declarations are in the cached environment as well,
+        // as they were. Those stale ones aren't proposed.
+        std::unordered_set<const Symbol*> stale;
+        for (auto sym : snippetProg->env().listDecls()) {
+            if (!sym->name())
+                continue;
+            for (auto range = cache.env_.searchValueDecls(sym->name());
+                 range.first != range.second; ++range.first) {
+                stale.insert(*range.first);
+            }
+            for (auto range = cache.env_.searchTypeDecls(sym->name());
+                 range.first != range.second; ++range.first) {
+                stale.insert(*range.first);
+            }
+        }
+
+        env.attachOuterEnv(cache.env_);
+        P->infer(unit.get());
+        result = P->propose(unit.get());
+
+        auto& syms = std::get<0>(result);
+        syms.erase(std::remove_if(syms.begin(), syms.end(),
+                                  [&stale](const Symbol* sym) {
+            return stale.count(sym) != 0;
+        }), syms.end());
+    }
+    if (std::get<1>(result) != CompletionProposer::CompletionAstNotFound) {
+        static const LatencyStats::Key completionCacheHitsKey("completion.cacheHits");
+        LatencyStats::count(completionCacheHitsKey);
+        cache.unit_ = std::move(unit);
+        cache.prog_ = std::move(snippetProg);
+        if (prog)
+            *prog = cache.prog_;
+        return result;
+    }
+
+    DEBUG_TRACE("complete %s as a whole\n", fullFileName.c_str());
+    static const LatencyStats::Key completionCacheMissesKey("completion.cacheMisses");
+    LatencyStats::count(completionCacheMissesKey);
+    unit = process(code, fullFileName, lineCol);
+    if (unit->ast())
+        result = P->propose(unit.get());
+    cache.unit_ = std::move(unit);
+    cache.prog_.reset();
+    if (prog)
+        *prog = P->snapshot_.find(fullFileName);
+
+    return result;
+}
+
 void Manager::processDeps(const std::string& fullFileName) const
 {
     UAISO_ASSERT(P->snapshot_.find(fullFileName), return);
 
+    // Dependencies are shared among programs, as are their environments.
+    std::lock_guard<std::recursive_mutex> lock(P->depsMutex_);
+
+    AllocStats::Phase phase("deps", fullFileName);
+    static const LatencyStats::Key depsKey("deps");
+    LatencyStats::Timer timer(depsKey);
+
     ImportResolver resolver(P->factory_);
 
-    std::stack<const Program*> progs;
-    progs.push(P->snapshot_.find(fullFileName));
+    std::stack<std::pair<std::string, std::shared_ptr<const Program>>> progs;
+    progs.emplace(fullFileName, P->snapshot_.find(fullFileName));
     std::unordered_set<std::string> visited;
     visited.insert(fullFileName);
     DEBUG_TRACE("process dependencies of %s\n", fullFileName.c_str());
     while (!progs.empty()) {
-        const Program* curProg = progs.top();
+        std::string curFileName = std::move(progs.top().first);
+        auto curProg = std::move(progs.top().second);
         progs.pop();
 
         // Inspect all imports and, if any of them is not already in the
         // snapshot, parse it, bind it, and start tracking it.
         auto curProgEnv = curProg->env();
         auto imports = curProgEnv.imports();
+        std::vector<std::string> targets;
+        bool hasUnresolved = false;
         for (auto import : imports) {
             DEBUG_TRACE("imported module name: %s\n", import->target().c_str());
             auto fileNames = resolver.resolve(const_cast<Import*>(import), P->searchPaths_);
+            targets.insert(targets.end(), fileNames.begin(), fileNames.end());
+            if (fileNames.empty())
+                hasUnresolved = true;
+            // The files of a package are reached through a single
+            // environment shared by all of them, injected only once.
+            bool wholePackage = !import->isSelective()
+                    && import->targetEntity() == Import::Package;
+            std::string packageName;
             for (auto& fileName : fileNames) {
+                if (wholePackage)
+                    packageName = FileInfo(fileName).dir();
+
                 if (visited.count(fileName))
                     continue;
 
                 DEBUG_TRACE("candidate file: %s\n", fileName.c_str());
-                Program* otherProg = P->snapshot_.find(fileName);
+                std::shared_ptr<const Program> otherProg = P->snapshot_.find(fileName);
+                if (!otherProg) {
+                    for (const auto& image : P->images_) {
+                        std::unique_ptr<Program> newProg =
+                                image->program(fileName, P->lexs_);
+                        if (!newProg)
+                            continue;
+
+                        P->snapshot_.insertOrReplace(fileName, std::move(newProg));
+                        otherProg = P->snapshot_.find(fileName);
+                        static const LatencyStats::Key depsImagesKey("deps.images");
+                        LatencyStats::count(depsImagesKey);
+                        break;
+                    }
+                }
                 if (!otherProg) {
                     FILE* file = fopen(fileName.c_str(), "r");
                     if (!file)
@@ -221,13 +607,18 @@ void Manager::processDeps(const std::string& fullFileName) const
                     if (!newProg)
                         continue;
 
-                    otherProg = newProg.get();
                     P->snapshot_.insertOrReplace(fileName, std::move(newProg));
+                    otherProg = P->snapshot_.find(fileName);
+                    static const LatencyStats::Key depsFilesKey("deps.files");
+                    LatencyStats::count(depsFilesKey);
                 }
                 DEBUG_TRACE("import (partially) resolved: %s\n", fileName.c_str());
-                progs.push(otherProg);
+                progs.emplace(fileName, otherProg);
                 visited.insert(fileName);
 
+                if (wholePackage)
+                    continue;
+
                 if (!import->isSelective()) {
                     std::unique_ptr<Namespace> space;
                     if (!import->isQualified()) {
@@ -272,6 +663,123 @@ void Manager::processDeps(const std::string& fullFileName) const
                     }
                 }
             }
+
+            if (!packageName.empty()) {
+                std::unique_ptr<Namespace> space;
+                if (!import->isQualified()) {
+                    space.reset(new Namespace);
+                } else {
+                    space.reset(new Namespace(import->localName()));
+                }
+                space->setEnv(P->snapshot_.packageEnv(packageName));
+                curProgEnv.injectNamespace(std::move(space), !import->isQualified());
+            }
+        }
+        P->trackImports(curFileName, std::move(targets), hasUnresolved);
+    }
+}
+
+std::vector<std::string> Manager::refresh(const std::vector<std::string>& fullFileNames)
+{
+    UAISO_ASSERT(P->factory_, return std::vector<std::string>());
+    UAISO_ASSERT(P->lexs_, return std::vector<std::string>());
+
+    std::lock_guard<std::recursive_mutex> lock(P->depsMutex_);
+
+    // A file that isn't tracked is of interest only if it was just created
+    // and some tracked program now imports it. Only the programs that might
+    // have their imports resolved differently are inspected: the ones with
+    // an import not resolved before and the importers of the new file's
+    // siblings (it may be part of their package).
+    std::vector<std::string> affected;
+    std::unordered_set<std::string> visited;
+    std::unordered_set<std::string> candidates;
+    std::unordered_set<std::string> created;
+    for (const auto& fileName : fullFileNames) {
+        if (P->snapshot_.find(fileName)) {
+            if (visited.insert(fileName).second)
+                affected.push_back(fileName);
+            continue;
+        }
+        created.insert(fileName);
+        const std::string dir = FileInfo(fileName).fullDir();
+        for (const auto& entry : P->importers_) {
+            if (FileInfo(entry.first).fullDir() == dir)
+                candidates.insert(entry.second.begin(), entry.second.end());
+        }
+    }
+    if (!created.empty()) {
+        candidates.insert(P->unresolved_.begin(), P->unresolved_.end());
+        ImportResolver resolver(P->factory_);
+        for (const auto& fileName : candidates) {
+            auto prog = P->snapshot_.find(fileName);
+            if (!prog || visited.count(fileName))
+                continue;
+            for (auto import : prog->env().imports()) {
+                auto targets = resolver.resolve(const_cast<Import*>(import), P->searchPaths_);
+                if (std::any_of(targets.begin(), targets.end(),
+                                [&created](const std::string& target) {
+                                    return created.count(target) != 0;
+                                })) {
+                    visited.insert(fileName);
+                    affected.push_back(fileName);
+                    break;
+                }
+            }
+        }
+    }
+
+    // The changed files come first, followed by their importers, so that
+    // the latter are bound against up-to-date programs.
+    for (size_t i = 0; i < affected.size(); ++i) {
+        auto it = P->importers_.find(affected[i]);
+        if (it == P->importers_.end())
+            continue;
+        for (const auto& importer : it->second) {
+            if (visited.insert(importer).second)
+                affected.push_back(importer);
         }
     }
+
+    std::vector<std::string> stale;
+    std::vector<std::string> rebound;
+    for (const auto& fileName : affected) {
+        if (P->isCore(fileName)) {
+            stale.push_back(fileName);
+            continue;
+        }
+
+        // Lexemes and tokens are indexed by position, the ones from the
+        // previous contents must go.
+        P->lexs_->clear(fileName);
+        if (P->tokens_)
+            P->tokens_->clear(fileName);
+
+        FILE* file = fopen(fileName.c_str(), "r");
+        if (!file) {
+            DEBUG_TRACE("%s is gone\n", fileName.c_str());
+            P->snapshot_.remove(fileName);
+            P->untrackImports(fileName);
+            continue;
+        }
+
+        std::unique_ptr<Unit> unit = P->parse("", file, fileName);
+        if (!unit->ast())
+            continue;
+
+        std::unique_ptr<Program> prog = P->bind(unit.get(), true);
+        if (!prog)
+            continue;
+
+        P->snapshot_.insertOrReplace(fileName, std::move(prog));
+        rebound.push_back(fileName);
+    }
+
+    for (const auto& fileName : rebound)
+        processDeps(fileName);
+
+    DEBUG_TRACE("refreshed %zu dependencies, %zu programs are stale\n",
+                rebound.size(), stale.size());
+
+    return stale;
 }
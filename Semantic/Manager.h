@@ -27,7 +27,9 @@
 #include "Common/Flag.h"
 #include "Common/LineCol.h"
 #include "Common/Pimpl.h"
+#include "Semantic/CompletionProposer.h"
 #include <cstdio>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -35,12 +37,22 @@ namespace uaiso {
 
 class Factory;
 class LexemeMap;
+class Program;
+class ProgramImage;
 class Snapshot;
 class TokenMap;
 class Unit;
 
 /*!
  * \brief The Manager class
+ *
+ * Once configured, a manager may process different files concurrently:
+ * parsing and binding of the files themselves runs in parallel, while
+ * processing of dependencies (which are shared among files) is serialized.
+ * The TokenMap, LexemeMap, and Snapshot are safe to be shared as well.
+ *
+ * Processing the same file concurrently is not supported, neither is
+ * reconfiguring the manager while it's in use.
  */
 class UAISO_API Manager final
 {
@@ -48,13 +60,43 @@ public:
     Manager();
     ~Manager();
 
+    /*!
+     * \brief config
+     * \param factory
+     * \param tokens
+     * \param lexs
+     * \param snapshot
+     *
+     * The token map may be null, in which case tokens aren't tracked.
+     */
     void config(Factory* factory,
                 TokenMap* tokens,
                 LexemeMap* lexs,
                 Snapshot snapshot);
 
+    /*!
+     * \brief snapshot
+     * \return
+     */
+    Snapshot snapshot() const;
+
     void addSearchPath(const std::string& searchPath);
 
+    /*!
+     * \brief searchPaths
+     * \return
+     */
+    const std::vector<std::string>& searchPaths() const;
+
+    /*!
+     * \brief addProgramImage
+     * \param image
+     *
+     * Dependencies contained in the (opened) image are taken from it
+     * instead of being parsed and bound.
+     */
+    void addProgramImage(std::shared_ptr<const ProgramImage> image);
+
     /*!
      * \brief The BehaviourFlag enum
      */
@@ -85,7 +127,8 @@ public:
      * \return
      *
      * Parse and bind the code associated with the given name, insert it
-     * into the Snapshot, and process its dependencies.
+     * into the Snapshot, and process its dependencies. Name uses in
+     * the unit's AST are then annotated with their declarations.
      */
     std::unique_ptr<Unit> process(const std::string& code,
                                   const std::string& fullFileName);
@@ -117,6 +160,47 @@ public:
                                   const std::string& fullFileName,
                                   const LineCol& lineCol);
 
+    /*!
+     * \brief complete
+     * \param code
+     * \param fullFileName
+     * \param lineCol
+     * \return
+     *
+     * Propose completions for the given line and column of the code. When
+     * the file has been processed before, only the top-level declaration
+     * enclosing the cursor is parsed and bound, against the environment of
+     * the last program processed completely. Otherwise, or when that isn't
+     * possible, the code is processed up to the cursor as a whole.
+     *
+     * \note Declarations outside the enclosing one are seen as they were
+     * in the last program processed completely.
+     *
+     * \note The proposed symbols are valid until the next completion in the
+     * same file. Completions in a file are serialized.
+     */
+    CompletionProposer::Result complete(const std::string& code,
+                                        const std::string& fullFileName,
+                                        const LineCol& lineCol);
+
+    /*!
+     * \brief complete
+     * \param code
+     * \param fullFileName
+     * \param lineCol
+     * \param prog
+     * \return
+     *
+     * Overload that stores in \a prog the program of the file the proposed
+     * symbols were looked up from, so they outlive the next completion in
+     * the same file. Symbols declared elsewhere are valid as long as the
+     * snapshot's revision doesn't change.
+     */
+    CompletionProposer::Result complete(const std::string& code,
+                                        const std::string& fullFileName,
+                                        const LineCol& lineCol,
+                                        std::shared_ptr<const Program>* prog);
+
     /*!
      * \brief resolveDeps
      * \param fullFileName
@@ -128,10 +212,26 @@ public:
      */
     void processDeps(const std::string& fullFileName) const;
 
+    /*!
+     * \brief refresh
+     * \param fullFileNames
+     * \return
+     *
+     * Account for external changes to the given files. Tracked dependencies
+     * among them, as well as dependencies importing them (directly or not),
+     * are parsed and bound again from disk; the ones that don't exist anymore
+     * are removed from the snapshot. Files that aren't tracked are taken as
+     * new, and the tracked programs whose imports now resolve to them are
+     * bound again too. Programs that were processed explicitly are not, since
+     * their code may not be the one on disk; their names are returned so that
+     * they can be processed again.
+     */
+    std::vector<std::string> refresh(const std::vector<std::string>& fullFileNames);
+
 private:
     DECL_PIMPL(Manager)
 
-    void processCore(Unit* unit);
+    bool processCore(Unit* unit);
 };
 
 } // namespace uaiso
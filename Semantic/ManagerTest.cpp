@@ -0,0 +1,734 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Semantic/Manager.h"
+#include "Semantic/Environment.h"
+#include "Semantic/Program.h"
+#include "Semantic/ProgramImage.h"
+#include "Semantic/Snapshot.h"
+#include "Semantic/Symbol.h"
+#include "Semantic/Type.h"
+#include "Semantic/TypeResolver.h"
+#include "Semantic/Watcher.h"
+#include "Ast/Ast.h"
+#include "Ast/AstVisitor.h"
+#include "Common/AllocStats.h"
+#include "Common/Test.h"
+#include "Parsing/Factory.h"
+#include "Parsing/Lang.h"
+#include "Parsing/Lexeme.h"
+#include "Parsing/LexemeMap.h"
+#include "Parsing/TokenMap.h"
+#include "Parsing/Unit.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+using namespace uaiso;
+
+namespace {
+
+class IdentUses final : public AstVisitor<IdentUses>
+{
+public:
+    VisitResult visitIdentExpr(IdentExprAst* ast)
+    {
+        idents_.push_back(ast);
+        return Continue;
+    }
+
+    std::vector<IdentExprAst*> idents_;
+};
+
+} // anonymous
+
+namespace uaiso {
+
+void test_Manager();
+
+/*!
+ * Manager's public interface is all that's tested, so the test isn't
+ * declared within the class (sparing its header from the test machinery).
+ */
+class ManagerTest final : public Test
+{
+public:
+    TEST_RUN(ManagerTest
+             , &ManagerTest::testCase1
+             , &ManagerTest::testCase2
+             , &ManagerTest::testCase3
+             , &ManagerTest::testCase4
+             , &ManagerTest::testCase5
+             , &ManagerTest::testCase6
+             , &ManagerTest::testCase7
+             , &ManagerTest::testCase8
+             , &ManagerTest::testCase9
+             , &ManagerTest::testCase10
+             , &ManagerTest::testCase11
+             , &ManagerTest::testCase12
+             , &ManagerTest::testCase13
+             , &ManagerTest::testCase14
+             , &ManagerTest::testCase15
+             , &ManagerTest::GoTestCase1
+             )
+
+    ~ManagerTest()
+    {
+        removeFiles();
+    }
+
+    void reset() override
+    {
+        removeFiles();
+#ifndef _WIN32
+        char dirTemplate[] = "/tmp/uaisoXXXXXX";
+        if (mkdtemp(dirTemplate))
+            dir_ = std::string(dirTemplate) + "/";
+#endif
+        factory_ = FactoryCreator::create(LangId::Py);
+        snapshot_ = Snapshot();
+        manager_.reset(new Manager);
+        manager_->config(factory_.get(), &tokens_, &lexs_, snapshot_);
+        manager_->setBehaviour(Manager::BehaviourFlag::IgnoreBuiltins);
+    }
+
+    void removeFiles()
+    {
+        // Directories come before their files.
+        for (auto it = files_.rbegin(); it != files_.rend(); ++it)
+            std::remove(it->c_str());
+        files_.clear();
+        if (!dir_.empty())
+            std::remove(dir_.c_str());
+        dir_.clear();
+    }
+
+    void testCase1();
+    void testCase2();
+    void testCase3();
+    void testCase4();
+    void testCase5();
+    void testCase6();
+    void testCase7();
+    void testCase8();
+    void testCase9();
+    void testCase10();
+    void testCase11();
+    void testCase12();
+    void testCase13();
+    void testCase14();
+    void testCase15();
+    void GoTestCase1();
+
+    std::string writeFile(const std::string& name, const std::string& code)
+    {
+        std::string fileName = dir_ + name;
+        std::ofstream ofs(fileName, std::ios::trunc);
+        ofs << code;
+        if (std::find(files_.begin(), files_.end(), fileName) == files_.end())
+            files_.push_back(fileName);
+        return fileName;
+    }
+
+    std::string makeDir(const std::string& name)
+    {
+        std::string dirName = dir_ + name;
+#ifndef _WIN32
+        if (mkdir(dirName.c_str(), 0700) == 0)
+            files_.push_back(dirName);
+#endif
+        return dirName + "/";
+    }
+
+    bool declares(const std::string& fileName, const char* name)
+    {
+        auto prog = snapshot_.find(fileName);
+        if (!prog)
+            return false;
+        const Ident* ident = lexs_.findAnyOfIdent(name);
+        return ident && prog->env().searchValueDecl(ident);
+    }
+
+    std::vector<std::string> names(const CompletionProposer::Result& result)
+    {
+        std::vector<std::string> names;
+        for (auto sym : std::get<0>(result)) {
+            if (isDecl(sym))
+                names.push_back(ConstDeclSymbol_Cast(sym)->name()->str());
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    std::string dir_;
+    std::vector<std::string> files_;
+    std::unique_ptr<Factory> factory_;
+    TokenMap tokens_;
+    LexemeMap lexs_;
+    Snapshot snapshot_;
+    std::unique_ptr<Manager> manager_;
+};
+
+} // namespace uaiso
+
+void uaiso::ManagerTest::testCase1()
+{
+    if (dir_.empty())
+        UAISO_SKIP_TEST;
+
+    // A changed dependency is bound again, its importer is reported.
+    auto mod = writeFile("mod.py", "a = 1\n");
+    auto main = dir_ + "main.py";
+    manager_->process("import mod\n", main);
+    UAISO_EXPECT_TRUE(declares(mod, "a"));
+
+    writeFile("mod.py", "b = 2\n");
+    auto stale = manager_->refresh({ mod });
+    UAISO_EXPECT_INT_EQ(1, stale.size());
+    UAISO_EXPECT_STR_EQ(main, stale[0]);
+    UAISO_EXPECT_FALSE(declares(mod, "a"));
+    UAISO_EXPECT_TRUE(declares(mod, "b"));
+
+    // Untracked and unchanged files are left alone.
+    auto prog = snapshot_.find(mod);
+    stale = manager_->refresh({ dir_ + "other.py" });
+    UAISO_EXPECT_TRUE(stale.empty());
+    UAISO_EXPECT_PTR_EQ(prog, snapshot_.find(mod));
+}
+
+void uaiso::ManagerTest::testCase2()
+{
+    if (dir_.empty())
+        UAISO_SKIP_TEST;
+
+    // Dependencies importing a changed one are bound again as well.
+    auto base = writeFile("base.py", "a = 1\n");
+    auto mod = writeFile("mod.py", "import base\nm = 1\n");
+    auto main = dir_ + "main.py";
+    manager_->process("import mod\n", main);
+    auto prog = snapshot_.find(mod);
+    UAISO_EXPECT_TRUE(prog);
+
+    writeFile("base.py", "b = 2\n");
+    auto stale = manager_->refresh({ base });
+    UAISO_EXPECT_INT_EQ(1, stale.size());
+    UAISO_EXPECT_STR_EQ(main, stale[0]);
+    UAISO_EXPECT_TRUE(declares(base, "b"));
+    UAISO_EXPECT_TRUE(snapshot_.find(mod) != prog);
+    UAISO_EXPECT_TRUE(declares(mod, "m"));
+
+    const Ident* base_ = lexs_.findAnyOfIdent("base");
+    auto space = snapshot_.find(mod)->env().fetchNamespace(base_);
+    UAISO_EXPECT_TRUE(space);
+    const Ident* b = lexs_.findAnyOfIdent("b");
+    UAISO_EXPECT_TRUE(space->env().searchValueDecl(b));
+}
+
+void uaiso::ManagerTest::testCase3()
+{
+    if (dir_.empty() || !Watcher::isSupported())
+        UAISO_SKIP_TEST;
+
+    auto mod = writeFile("mod.py", "a = 1\n");
+    auto main = dir_ + "main.py";
+    manager_->process("import mod\n", main);
+
+    Watcher watcher(manager_.get(), snapshot_);
+    UAISO_EXPECT_TRUE(watcher.start());
+    UAISO_EXPECT_TRUE(watcher.poll(0).empty());
+
+    writeFile("mod.py", "b = 2\n");
+    writeFile("mod.py", "c = 3\n");
+    auto stale = watcher.poll(2000);
+    UAISO_EXPECT_INT_EQ(1, stale.size());
+    UAISO_EXPECT_STR_EQ(main, stale[0]);
+    UAISO_EXPECT_INT_EQ(1, watcher.lastBatchSize());
+    UAISO_EXPECT_TRUE(declares(mod, "c"));
+}
+
+void uaiso::ManagerTest::testCase4()
+{
+    if (dir_.empty())
+        UAISO_SKIP_TEST;
+
+    // Allocations are accounted to the phase and file they're made for.
+    auto mod = writeFile("mod.py", "a = 1\n");
+    auto main = dir_ + "main.py";
+
+    AllocStats stats;
+    stats.attach();
+    manager_->process("import mod\nb = 2\n", main);
+    stats.detach();
+    // Nothing is counted unless Common/AllocHook.cpp is linked.
+    if (!stats.total().allocs_)
+        UAISO_SKIP_TEST;
+
+    auto has = [&stats](const char* phase, const std::string& fileName) {
+        for (const auto& entry : stats.entries()) {
+            if (entry.phase_ == phase && entry.fullFileName_ == fileName)
+                return entry.counters_.allocs_ != 0;
+        }
+        return false;
+    };
+    UAISO_EXPECT_TRUE(has("parse", main));
+    UAISO_EXPECT_TRUE(has("bind", main));
+    UAISO_EXPECT_TRUE(has("deps", main));
+    UAISO_EXPECT_TRUE(has("parse", mod));
+    UAISO_EXPECT_TRUE(has("bind", mod));
+    UAISO_EXPECT_FALSE(has("deps", mod));
+}
+
+void uaiso::ManagerTest::testCase5()
+{
+    if (dir_.empty())
+        UAISO_SKIP_TEST;
+
+    // Tokens needn't be tracked.
+    manager_->config(factory_.get(), nullptr, &lexs_, snapshot_);
+    auto mod = writeFile("mod.py", "a = 1\n");
+    auto main = dir_ + "main.py";
+    manager_->process("import mod\nb = 2\n", main);
+    UAISO_EXPECT_TRUE(declares(main, "b"));
+    UAISO_EXPECT_TRUE(declares(mod, "a"));
+    UAISO_EXPECT_INT_EQ(TK_INVALID, tokens_.findAt(main, LineCol(1, 4)));
+
+    writeFile("mod.py", "c = 3\n");
+    manager_->refresh({ mod });
+    UAISO_EXPECT_TRUE(declares(mod, "c"));
+}
+
+void uaiso::ManagerTest::testCase6()
+{
+    // Name uses are annotated with the declarations they resolve to.
+    auto main = dir_ + "main.py";
+    auto unit = manager_->process("a = 1\ndef f(b):\n    return a + b + c\n", main);
+    UAISO_EXPECT_TRUE(unit->ast());
+
+    IdentUses uses;
+    std::unique_ptr<Lang> lang(factory_->makeLang());
+    traverseProgram(Program_Cast(unit->ast()), &uses, lang.get());
+
+    int resolved = 0;
+    int unresolved = 0;
+    for (auto ident : uses.idents_) {
+        if (ident->name()->kind() != Ast::Kind::SimpleName)
+            continue;
+        const auto& loc = SimpleName_Cast(ident->name())->nameLoc_;
+        auto name = lexs_.findAt<Ident>(main, loc.lineCol());
+        UAISO_EXPECT_TRUE(name);
+        if (name->str() == "c") {
+            UAISO_EXPECT_TRUE(ident->resolution() == NameResolution::Unresolved);
+            UAISO_EXPECT_FALSE(ident->decl());
+            ++unresolved;
+        } else {
+            UAISO_EXPECT_TRUE(ident->resolution() == NameResolution::AsValue);
+            UAISO_EXPECT_TRUE(ident->decl());
+            UAISO_EXPECT_TRUE(ident->decl()->name() == name);
+            ++resolved;
+        }
+    }
+    UAISO_EXPECT_INT_EQ(3, resolved);
+    UAISO_EXPECT_INT_EQ(1, unresolved);
+}
+
+void uaiso::ManagerTest::testCase7()
+{
+    std::string code = R"raw(
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+def f(a):
+    return a
+
+def g():
+    b = 1
+    return b
+)raw";
+
+    // Without a program processed completely, the code is processed
+    // as a whole.
+    auto result = manager_->complete(code, "/test.py", LineCol(7, 11));
+    UAISO_EXPECT_INT_EQ(CompletionProposer::Success, std::get<1>(result));
+    std::vector<std::string> expected { "Point", "a", "f" };
+    UAISO_EXPECT_TRUE(expected == names(result));
+
+    // Otherwise, only the enclosing declaration is parsed and bound, the
+    // program in the snapshot stays.
+    manager_->process(code, "/test.py");
+    auto prog = snapshot_.find("/test.py");
+    UAISO_EXPECT_TRUE(prog);
+
+    std::string edit = R"raw(
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+def f(a):
+    return a
+
+def g():
+    b = 1
+    p = Point()
+    p.
+)raw";
+    result = manager_->complete(edit, "/test.py", LineCol(12, 6));
+    UAISO_EXPECT_INT_EQ(CompletionProposer::Success, std::get<1>(result));
+    expected = { "__init__", "x", "y" };
+    UAISO_EXPECT_TRUE(expected == names(result));
+    UAISO_EXPECT_PTR_EQ(prog, snapshot_.find("/test.py"));
+
+    // Lexemes of the previous contents must go.
+    lexs_.clear("/test.py");
+    tokens_.clear("/test.py");
+    edit = R"raw(
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+def f(a):
+    return a
+
+def g():
+    b = 1
+    c = 
+)raw";
+    result = manager_->complete(edit, "/test.py", LineCol(11, 8));
+    UAISO_EXPECT_INT_EQ(CompletionProposer::Success, std::get<1>(result));
+    expected = { "Point", "b", "c", "f", "g" };
+    UAISO_EXPECT_TRUE(expected == names(result));
+    UAISO_EXPECT_PTR_EQ(prog, snapshot_.find("/test.py"));
+
+    // When the enclosing declaration has moved, the code is processed
+    // as a whole.
+    lexs_.clear("/test.py");
+    tokens_.clear("/test.py");
+    result = manager_->complete("\n" + edit, "/test.py", LineCol(12, 8));
+    UAISO_EXPECT_INT_EQ(CompletionProposer::Success, std::get<1>(result));
+    UAISO_EXPECT_TRUE(expected == names(result));
+    UAISO_EXPECT_TRUE(prog != snapshot_.find("/test.py"));
+}
+
+void uaiso::ManagerTest::testCase8()
+{
+    std::string code = R"raw(
+class Point:
+    x = 1
+)raw";
+
+    manager_->process(code, "/test.py");
+    auto prog = snapshot_.find("/test.py");
+    UAISO_EXPECT_TRUE(prog);
+    const Ident* name = lexs_.findAnyOfIdent("Point");
+    UAISO_EXPECT_TRUE(name);
+    Environment env = prog->env();
+
+    // Elaborate types referenced from the same scope share the resolution.
+    TypeResolver resolver(factory_.get());
+    resolver.setSnapshot(snapshot_);
+    ElaborateType elabTy(name);
+    ElaborateType otherElabTy(name);
+    auto ty = std::get<0>(resolver.resolve(&elabTy, env));
+    UAISO_EXPECT_TRUE(ty);
+    UAISO_EXPECT_INT_EQ(static_cast<int>(Type::Kind::Record),
+                        static_cast<int>(ty->kind()));
+    UAISO_EXPECT_PTR_EQ(ty, std::get<0>(resolver.resolve(&otherElabTy, env)));
+    UAISO_EXPECT_PTR_EQ(ty, snapshot_.resolvedType(env, name).get());
+    UAISO_EXPECT_PTR_EQ(ty, otherElabTy.canonicalType());
+
+    // Once a program is replaced, the resolution is stale.
+    manager_->process(code, "/test.py");
+    UAISO_EXPECT_FALSE(snapshot_.resolvedType(env, name));
+}
+
+void uaiso::ManagerTest::testCase9()
+{
+    if (dir_.empty())
+        UAISO_SKIP_TEST;
+
+    // An image of a dependency, written while the file had other contents.
+    auto mod = writeFile("mod.py", "a = 1\n");
+    auto main = dir_ + "main.py";
+    manager_->process("import mod\n", main);
+    UAISO_EXPECT_TRUE(declares(mod, "a"));
+    auto imageFileName = writeFile("deps.img", "");
+    UAISO_EXPECT_TRUE(ProgramImage::write(imageFileName, dir_,
+                                          { snapshot_.find(mod).get() }));
+
+    std::shared_ptr<ProgramImage> image(new ProgramImage);
+    UAISO_EXPECT_TRUE(image->open(imageFileName, dir_));
+    UAISO_EXPECT_TRUE(image->contains(mod));
+
+    // The dependency is taken from the image, not from the file.
+    writeFile("mod.py", "b = 2\n");
+    snapshot_ = Snapshot();
+    manager_.reset(new Manager);
+    manager_->config(factory_.get(), &tokens_, &lexs_, snapshot_);
+    manager_->setBehaviour(Manager::BehaviourFlag::IgnoreBuiltins);
+    manager_->addProgramImage(image);
+    manager_->process("import mod\n", main);
+    UAISO_EXPECT_TRUE(declares(mod, "a"));
+    UAISO_EXPECT_FALSE(declares(mod, "b"));
+}
+
+void uaiso::test_Manager()
+{
+    ManagerTest test;
+    test.run();
+}
+
+void uaiso::ManagerTest::testCase10()
+{
+    if (dir_.empty())
+        UAISO_SKIP_TEST;
+
+    // A deleted dependency leaves the snapshot, its importers are bound
+    // again without it.
+    auto base = writeFile("base.py", "a = 1\n");
+    auto mod = writeFile("mod.py", "import base\nm = 1\n");
+    auto main = dir_ + "main.py";
+    manager_->process("import mod\n", main);
+    UAISO_EXPECT_TRUE(snapshot_.find(base));
+
+    std::remove(base.c_str());
+    auto stale = manager_->refresh({ base });
+    UAISO_EXPECT_INT_EQ(1, stale.size());
+    UAISO_EXPECT_STR_EQ(main, stale[0]);
+    UAISO_EXPECT_FALSE(snapshot_.find(base));
+    UAISO_EXPECT_TRUE(declares(mod, "m"));
+    const Ident* base_ = lexs_.findAnyOfIdent("base");
+    UAISO_EXPECT_FALSE(snapshot_.find(mod)->env().fetchNamespace(base_));
+
+    auto fileNames = snapshot_.fileNames();
+    UAISO_EXPECT_TRUE(std::find(fileNames.begin(), fileNames.end(), base)
+                      == fileNames.end());
+}
+
+void uaiso::ManagerTest::testCase11()
+{
+    if (dir_.empty())
+        UAISO_SKIP_TEST;
+
+    // A new file a dependency failed to import before is now imported.
+    auto mod = writeFile("mod.py", "import extra\nm = 1\n");
+    auto main = dir_ + "main.py";
+    manager_->process("import mod\n", main);
+    auto extra = dir_ + "extra.py";
+    UAISO_EXPECT_FALSE(snapshot_.find(extra));
+
+    writeFile("extra.py", "e = 1\n");
+    auto stale = manager_->refresh({ extra });
+    UAISO_EXPECT_INT_EQ(1, stale.size());
+    UAISO_EXPECT_STR_EQ(main, stale[0]);
+    UAISO_EXPECT_TRUE(declares(extra, "e"));
+    const Ident* extra_ = lexs_.findAnyOfIdent("extra");
+    UAISO_EXPECT_TRUE(snapshot_.find(mod)->env().fetchNamespace(extra_));
+
+    // A new file nobody imports is left alone.
+    auto other = writeFile("other.py", "o = 1\n");
+    stale = manager_->refresh({ other });
+    UAISO_EXPECT_TRUE(stale.empty());
+    UAISO_EXPECT_FALSE(snapshot_.find(other));
+}
+
+void uaiso::ManagerTest::testCase12()
+{
+    if (dir_.empty() || !Watcher::isSupported())
+        UAISO_SKIP_TEST;
+
+    // Subdirectories of a search path are watched, and a steady stream
+    // of events doesn't hold a batch beyond its maximum period.
+    auto pkg = makeDir("pkg");
+    manager_->addSearchPath(dir_);
+    manager_->process("a = 1\n", dir_ + "main.py");
+
+    Watcher watcher(manager_.get(), snapshot_);
+    watcher.setQuietPeriod(60000);
+    watcher.setMaxBatchPeriod(100);
+    UAISO_EXPECT_TRUE(watcher.start());
+
+    auto sub = makeDir("pkg/sub");
+    writeFile("pkg/x.py", "x = 1\n");
+    auto start = std::chrono::steady_clock::now();
+    watcher.poll(2000);
+    std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+    UAISO_EXPECT_INT_EQ(1, watcher.lastBatchSize());
+    UAISO_EXPECT_TRUE(elapsed.count() < 10000);
+
+    // The new directory is watched as well.
+    writeFile("pkg/sub/y.py", "y = 1\n");
+    watcher.poll(2000);
+    UAISO_EXPECT_INT_EQ(1, watcher.lastBatchSize());
+}
+
+void uaiso::ManagerTest::testCase13()
+{
+    if (dir_.empty())
+        UAISO_SKIP_TEST;
+
+    // Only declarations of the file itself are annotated, since those of a
+    // dependency go away when it's replaced. Imports resolve as namespaces.
+    writeFile("mod.py", "a = 1\n");
+    auto main = dir_ + "main.py";
+    auto unit = manager_->process("import mod\nfrom mod import a\n"
+                                  "b = mod.a\nc = a + b\n", main);
+    UAISO_EXPECT_TRUE(unit->ast());
+
+    IdentUses uses;
+    std::unique_ptr<Lang> lang(factory_->makeLang());
+    traverseProgram(Program_Cast(unit->ast()), &uses, lang.get());
+
+    int spaces = 0;
+    for (auto ident : uses.idents_) {
+        if (ident->resolution() == NameResolution::AsNamespace) {
+            UAISO_EXPECT_FALSE(ident->decl());
+            ++spaces;
+        } else if (ident->decl()) {
+            UAISO_EXPECT_STR_EQ(main, ident->decl()->sourceLoc().fileName_);
+        }
+    }
+    UAISO_EXPECT_INT_EQ(1, spaces);
+
+    writeFile("mod.py", "a = 2\n");
+    manager_->refresh({ dir_ + "mod.py" });
+    for (auto ident : uses.idents_) {
+        if (ident->decl())
+            UAISO_EXPECT_TRUE(ident->decl()->name());
+    }
+}
+
+void uaiso::ManagerTest::testCase14()
+{
+    std::string code = R"raw(
+a = 1
+
+def f(a):
+    b = a
+    return b
+
+def g():
+    return a
+)raw";
+    manager_->process(code, "/test.py");
+
+    // Completions in a file may be requested from several threads (the
+    // proposed symbols are valid until the next one).
+    std::string edit = code;
+    edit.replace(edit.find("    return b"), 12, "    c = ");
+    std::vector<int> statuses(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < statuses.size(); ++i) {
+        threads.emplace_back([&, i] () {
+            auto result = manager_->complete(edit, "/test.py", LineCol(5, 8));
+            statuses[i] = std::get<1>(result);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (auto status : statuses)
+        UAISO_EXPECT_INT_EQ(CompletionProposer::Success, status);
+
+    // Only the stale version of the enclosing declaration isn't proposed,
+    // a global shadowed by a parameter still is.
+    auto result = manager_->complete(edit, "/test.py", LineCol(5, 8));
+    std::vector<std::string> expected { "a", "a", "b", "c", "f" };
+    UAISO_EXPECT_TRUE(expected == names(result));
+}
+
+void uaiso::ManagerTest::testCase15()
+{
+    if (dir_.empty())
+        UAISO_SKIP_TEST;
+
+    // Types are inferred when a file is processed, before its program is
+    // shared. Calls into other files don't contribute, so inferred types
+    // don't go stale when those change.
+    writeFile("mod.py", "def make():\n    return 1\n");
+    auto main = dir_ + "main.py";
+    manager_->process("import mod\n"
+                      "def f():\n    return 2.5\n"
+                      "def g():\n    return mod.make()\n", main);
+    auto prog = snapshot_.find(main);
+    UAISO_EXPECT_TRUE(prog);
+
+    auto f = prog->env().searchValueDecl(lexs_.findAnyOfIdent("f"));
+    UAISO_EXPECT_TRUE(f && f->valueType());
+    UAISO_EXPECT_INT_EQ(static_cast<int>(Type::Kind::Float),
+                        static_cast<int>(f->valueType()->kind()));
+    auto g = prog->env().searchValueDecl(lexs_.findAnyOfIdent("g"));
+    UAISO_EXPECT_TRUE(g);
+    UAISO_EXPECT_TRUE(!g->valueType()
+                      || g->valueType()->kind() == Type::Kind::Inferred);
+}
+
+void uaiso::ManagerTest::GoTestCase1()
+{
+    if (dir_.empty())
+        UAISO_SKIP_TEST;
+
+    // The files of a package are seen through one environment. It isn't
+    // modified when one of them changes, but built again.
+    factory_ = FactoryCreator::create(LangId::Go);
+    manager_->config(factory_.get(), &tokens_, &lexs_, snapshot_);
+    manager_->addSearchPath(dir_);
+    makeDir("pkg");
+    auto a = writeFile("pkg/a.go", "package pkg\nvar X = 1\n");
+    writeFile("pkg/b.go", "package pkg\nvar Y = 2\n");
+
+    auto main = dir_ + "main.go";
+    std::string code = "package main\nimport \"pkg\"\n";
+    manager_->process(code, main);
+    auto prog = snapshot_.find(main);
+    UAISO_EXPECT_TRUE(prog);
+    auto space = prog->env().fetchNamespace(lexs_.findAnyOfIdent("pkg"));
+    UAISO_EXPECT_TRUE(space);
+    auto pkgEnv = space->env();
+    UAISO_EXPECT_TRUE(pkgEnv.searchValueDecl(lexs_.findAnyOfIdent("X")));
+    UAISO_EXPECT_TRUE(pkgEnv.searchValueDecl(lexs_.findAnyOfIdent("Y")));
+    UAISO_EXPECT_INT_EQ(1, prog->env().listNamespaces().size());
+
+    writeFile("pkg/a.go", "package pkg\nvar Z = 3\n");
+    auto stale = manager_->refresh({ a });
+    UAISO_EXPECT_INT_EQ(1, stale.size());
+    UAISO_EXPECT_TRUE(pkgEnv.searchValueDecl(lexs_.findAnyOfIdent("X")));
+    UAISO_EXPECT_FALSE(pkgEnv.searchValueDecl(lexs_.findAnyOfIdent("Z")));
+
+    // The importer, once processed again, sees the package as it is.
+    manager_->process(code, main);
+    space = snapshot_.find(main)->env().fetchNamespace(lexs_.findAnyOfIdent("pkg"));
+    UAISO_EXPECT_TRUE(space);
+    pkgEnv = space->env();
+    UAISO_EXPECT_FALSE(pkgEnv.searchValueDecl(lexs_.findAnyOfIdent("X")));
+    UAISO_EXPECT_TRUE(pkgEnv.searchValueDecl(lexs_.findAnyOfIdent("Y")));
+    UAISO_EXPECT_TRUE(pkgEnv.searchValueDecl(lexs_.findAnyOfIdent("Z")));
+}
@@ -0,0 +1,203 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Semantic/NameResolver.h"
+#include "Semantic/Environment.h"
+#include "Semantic/Program.h"
+#include "Semantic/Symbol.h"
+#include "Semantic/Type.h"
+#include "Ast/AstVisitor.h"
+#include "Common/Assert.h"
+#include "Common/FileInfo.h"
+#include "Parsing/Factory.h"
+#include "Parsing/Lang.h"
+#include "Parsing/Lexeme.h"
+#include "Parsing/LexemeMap.h"
+
+using namespace uaiso;
+
+struct uaiso::NameResolver::NameResolverImpl
+{
+    NameResolverImpl(Factory* factory)
+        : lang_(factory->makeLang())
+    {}
+
+    //! Language-specific lang.
+    std::unique_ptr<const Lang> lang_;
+};
+
+NameResolver::NameResolver(Factory* factory)
+    : P(new NameResolverImpl(factory))
+{}
+
+NameResolver::~NameResolver()
+{}
+
+namespace {
+
+class NameUseVisitor final : public AstVisitor<NameUseVisitor>
+{
+public:
+    NameUseVisitor(Environment env,
+                   const Lang* lang,
+                   const LexemeMap* lexs,
+                   std::string fullFileName)
+        : env_(env)
+        , lang_(lang)
+        , lexs_(lexs)
+        , fullFileName_(std::move(fullFileName))
+    {}
+
+    using Base = AstVisitor<NameUseVisitor>;
+
+    Environment env_;
+    const Lang* lang_;
+    const LexemeMap* lexs_;
+    std::string fullFileName_;
+
+    bool isLocal(const Decl* sym) const
+    {
+        return sym->sourceLoc().fileName_ == fullFileName_;
+    }
+
+    bool isNamespace(const NameAst* name) const
+    {
+        const SimpleNameAst* simple = ConstSimpleName_Cast(name);
+        auto ident = lexs_->findAt<Ident>(simple->nameLoc_.fileName_,
+                                          simple->nameLoc_.lineCol());
+        return ident && env_.fetchNamespace(ident);
+    }
+
+    //--- Declarations ---//
+
+    VisitResult traverseEnumDecl(EnumDeclAst* ast)
+    {
+        if (!ast->sym_ || !ast->sym_->type())
+            return Base::traverseEnumDecl(ast);
+
+        env_ = ast->sym_->type()->env();
+        VIS_CALL(Base::traverseEnumDecl(ast));
+        env_ = env_.outerEnv();
+        return Continue;
+    }
+
+    VisitResult traverseRecordDecl(RecordDeclAst* ast)
+    {
+        if (!ast->sym_ || !ast->sym_->type())
+            return Base::traverseRecordDecl(ast);
+
+        env_ = ast->sym_->type()->env();
+        VIS_CALL(Base::traverseRecordDecl(ast));
+        env_ = env_.outerEnv();
+        return Continue;
+    }
+
+    VisitResult traverseFuncDecl(FuncDeclAst* ast)
+    {
+        if (!ast->sym_ || !lang_->hasFuncLevelScope())
+            return Base::traverseFuncDecl(ast);
+
+        env_ = ast->sym_->env();
+        VIS_CALL(Base::traverseFuncDecl(ast));
+        env_ = env_.outerEnv();
+        return Continue;
+    }
+
+    //--- Expressions ---//
+
+    VisitResult traverseIdentExpr(IdentExprAst* ast)
+    {
+        if (!ast->name() || ast->name()->kind() != Ast::Kind::SimpleName) {
+            ast->setDecl(NameResolution::Pending, nullptr);
+            return Continue;
+        }
+
+        if (auto valSym = searchValueDecl(ast->name(), env_, lexs_)) {
+            if (isLocal(valSym))
+                ast->setDecl(NameResolution::AsValue, valSym);
+            else
+                ast->setDecl(NameResolution::Pending, nullptr);
+        } else if (auto tySym = searchTypeDecl(ast->name(), env_, lexs_)) {
+            if (isLocal(tySym))
+                ast->setDecl(NameResolution::AsType, tySym);
+            else
+                ast->setDecl(NameResolution::Pending, nullptr);
+        } else if (isNamespace(ast->name())) {
+            ast->setDecl(NameResolution::AsNamespace, nullptr);
+        } else {
+            ast->setDecl(NameResolution::Unresolved, nullptr);
+        }
+
+        return Continue;
+    }
+
+    //--- Specifiers ---//
+
+    VisitResult traverseNamedSpec(NamedSpecAst* ast)
+    {
+        if (!ast->name() || ast->name()->kind() != Ast::Kind::SimpleName) {
+            ast->setDecl(NameResolution::Pending, nullptr);
+            return Continue;
+        }
+
+        if (auto tySym = searchTypeDecl(ast->name(), env_, lexs_)) {
+            if (isLocal(tySym))
+                ast->setDecl(NameResolution::AsType, tySym);
+            else
+                ast->setDecl(NameResolution::Pending, nullptr);
+        } else {
+            ast->setDecl(NameResolution::Unresolved, nullptr);
+        }
+
+        return Continue;
+    }
+
+    //--- Statements ---//
+
+    VisitResult traverseBlockStmt(BlockStmtAst* ast)
+    {
+        // The environment of a block stmt might be the shared with its
+        // parent. If that's the case, it's been entered already.
+        if (env_ == ast->env_
+                || !lang_->hasBlockLevelScope()) {
+            VIS_CALL(Base::traverseBlockStmt(ast));
+        } else {
+            env_ = ast->env_;
+            VIS_CALL(Base::traverseBlockStmt(ast));
+            env_ = env_.outerEnv();
+        }
+        return Continue;
+    }
+};
+
+} // anonymous
+
+void NameResolver::resolve(ProgramAst* progAst, const LexemeMap* lexs)
+{
+    UAISO_ASSERT(progAst, return);
+    UAISO_ASSERT(progAst->program_, return);
+
+    NameUseVisitor vis(progAst->program_->env(), P->lang_.get(), lexs,
+                       progAst->program_->fileInfo().fullFileName());
+    traverseProgram(progAst, &vis, P->lang_.get());
+}
@@ -0,0 +1,72 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#ifndef UAISO_NAMERESOLVER_H__
+#define UAISO_NAMERESOLVER_H__
+
+#include "Ast/AstFwd.h"
+#include "Common/Config.h"
+#include "Common/Pimpl.h"
+
+namespace uaiso {
+
+class Factory;
+class LexemeMap;
+
+/*!
+ * \brief The NameResolver class
+ *
+ * Annotate name uses (identifier expressions and named specifiers) with
+ * the declaration they resolve to, or with an unresolved marker, so that
+ * later queries (go-to-definition, usages, type checking) are pointer
+ * reads instead of environment searches.
+ */
+class UAISO_API NameResolver final
+{
+public:
+    NameResolver(Factory* factory);
+    ~NameResolver();
+
+    /*!
+     * \brief resolve
+     * \param ast
+     * \param lexs
+     * \pre The AST must have already been gone through the Binder.
+     *
+     * Resolve every name use in the AST against the program's environment,
+     * overwriting previous annotations. Uses of non-simple names remain
+     * pending.
+     *
+     * Only declarations of the program itself are annotated, since they live
+     * as long as the AST's program does. Uses of names declared elsewhere (in
+     * dependencies, whose programs might be replaced) remain pending.
+     */
+    void resolve(ProgramAst* ast, const LexemeMap* lexs);
+
+private:
+    DECL_PIMPL(NameResolver)
+};
+
+} // namespace uaiso
+
+#endif
@@ -0,0 +1,1035 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Semantic/ProgramImage.h"
+#include "Semantic/Environment.h"
+#include "Semantic/Import.h"
+#include "Semantic/Precision.h"
+#include "Semantic/Program.h"
+#include "Semantic/Signedness.h"
+#include "Semantic/Snapshot.h"
+#include "Semantic/Symbol.h"
+#include "Semantic/Type.h"
+#include "Common/Assert.h"
+#include "Common/FileInfo.h"
+#include "Common/Trace__.h"
+#include "Parsing/Lexeme.h"
+#include "Parsing/LexemeMap.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define TRACE_NAME "ProgramImage"
+
+using namespace uaiso;
+
+namespace {
+
+const char kMagic[] = { 'U', 'A', 'I', 'S', 'O', 'I', 'M', 'G' };
+const uint32_t kVersion = 2;
+
+// Declarations and types nest (e.g., a record within a function), but never
+// this deep, except in a corrupted image.
+const unsigned kMaxNesting = 256;
+const uint32_t kByteOrder = 0x01020304;
+const uint32_t kNone = 0xFFFFFFFF;
+const uint8_t kNoType = 0xFF;
+
+enum SymbolFlag : uint8_t
+{
+    Builtin = 0x1,
+    Fake    = 0x1 << 1,
+    Auto    = 0x1 << 2
+};
+
+// Unlike isTypeDecl and isValueDecl, these follow the class hierarchy, which
+// is what decides the table a symbol goes into.
+
+bool isOfTypeDeclClass(const Symbol* sym)
+{
+    switch (sym->kind()) {
+    case Symbol::Kind::Alias:
+    case Symbol::Kind::Enum:
+    case Symbol::Kind::Placeholder:
+    case Symbol::Kind::Record:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool isOfValueDeclClass(const Symbol* sym)
+{
+    switch (sym->kind()) {
+    case Symbol::Kind::EnumItem:
+    case Symbol::Kind::Func:
+    case Symbol::Kind::Param:
+    case Symbol::Kind::Var:
+        return true;
+    default:
+        return false;
+    }
+}
+
+    //--- Writer ---//
+
+class ImageWriter
+{
+public:
+    ImageWriter(const std::string& rootDir) : rootDir_(rootDir) {}
+
+    void program(const Program* prog)
+    {
+        // Each program is prefixed by the size of its record, so an index of
+        // the image can be built without reading the records.
+        size_t start = body_.size();
+        u32(0);
+
+        fileName_ = prog->fileInfo().fullFileName();
+        path(fileName_);
+
+        Environment env = prog->env();
+        auto imports = env.imports();
+        u32(imports.size());
+        for (auto import : imports) {
+            path(import->fromWhere());
+            u32(str(import->target()));
+            ident(import->localName());
+            u8(import->isQualified());
+            u32(import->selectedItems().size());
+            for (auto item : import->selectedItems()) {
+                ident(item);
+                ident(import->alternateName(item));
+            }
+        }
+
+        this->env(env, false);
+
+        uint32_t size = body_.size() - start - sizeof(uint32_t);
+        memcpy(&body_[start], &size, sizeof(size));
+    }
+
+    std::string finish(uint32_t progCnt) const
+    {
+        std::string image(kMagic, sizeof(kMagic));
+        appendU32(image, kVersion);
+        appendU32(image, kByteOrder);
+        appendU32(image, strs_.size());
+        for (const auto& s : strs_) {
+            appendU32(image, s.size());
+            image.append(s);
+        }
+        appendU32(image, progCnt);
+        image.append(body_);
+        return image;
+    }
+
+private:
+    static void appendU32(std::string& buf, uint32_t v)
+    {
+        buf.append(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+
+    void u8(uint8_t v) { body_.push_back(static_cast<char>(v)); }
+    void u32(uint32_t v) { appendU32(body_, v); }
+
+    uint32_t str(const std::string& s)
+    {
+        auto it = strIdx_.find(s);
+        if (it != strIdx_.end())
+            return it->second;
+        uint32_t idx = strs_.size();
+        strs_.push_back(s);
+        strIdx_.emplace(s, idx);
+        return idx;
+    }
+
+    void ident(const Ident* name)
+    {
+        u32(name ? str(name->str()) : kNone);
+    }
+
+    void path(const std::string& fileName)
+    {
+        bool isRelative = !rootDir_.empty()
+                && fileName.compare(0, rootDir_.size(), rootDir_) == 0;
+        u8(isRelative);
+        u32(str(isRelative ? fileName.substr(rootDir_.size()) : fileName));
+    }
+
+    void loc(const SourceLoc& loc)
+    {
+        // Builtins, for instance, have no location in the program's file.
+        u8(loc.fileName_ == fileName_);
+        u32(loc.line_);
+        u32(loc.col_);
+        u32(loc.lastLine_);
+        u32(loc.lastCol_);
+    }
+
+    void env(Environment env, bool paramsOnly)
+    {
+        // Symbols merged in from other programs (through unqualified
+        // imports) are listed along with the environment's own ones, but
+        // they are not declared in this file.
+        std::unordered_set<const Decl*> merged;
+        for (auto mergedEnv : env.mergedEnvs()) {
+            for (auto decl : mergedEnv.listDecls())
+                merged.insert(decl);
+        }
+        auto isOwn = [&merged] (const Decl* decl) {
+            return !merged.count(decl);
+        };
+
+        std::vector<const TypeDecl*> tyDecls;
+        if (!paramsOnly) {
+            for (auto decl : env.listTypeDecls()) {
+                if (isOwn(decl))
+                    tyDecls.push_back(decl);
+            }
+        }
+        std::vector<const ValueDecl*> valDecls;
+        for (auto decl : env.listValueDecls()) {
+            if (isOwn(decl) && (!paramsOnly || decl->kind() == Symbol::Kind::Param))
+                valDecls.push_back(decl);
+        }
+
+        u32(tyDecls.size());
+        for (auto decl : tyDecls)
+            this->decl(decl);
+        u32(valDecls.size());
+        for (auto decl : valDecls)
+            this->decl(decl);
+    }
+
+    void decl(const Decl* decl)
+    {
+        u8(static_cast<uint8_t>(decl->kind()));
+        ident(decl->name());
+        loc(decl->sourceLoc());
+        u8((decl->isBuiltin() ? Builtin : 0)
+           | (decl->isFake() ? Fake : 0)
+           | (decl->isMarkedAuto() ? Auto : 0));
+        u8(static_cast<uint8_t>(decl->visibility()));
+        u8(static_cast<uint8_t>(decl->storage()));
+        u8(static_cast<uint8_t>(decl->linkage()));
+        u32(static_cast<uint16_t>(decl->declAttrs()));
+
+        switch (decl->kind()) {
+        case Symbol::Kind::Alias:
+        case Symbol::Kind::Placeholder:
+        case Symbol::Kind::Record:
+            type(ConstTypeDecl_Cast(decl)->type());
+            break;
+
+        case Symbol::Kind::Enum: {
+            auto enumm = ConstEnum_Cast(decl);
+            type(enumm->underlyingType());
+            type(enumm->type());
+            break;
+        }
+
+        case Symbol::Kind::Func: {
+            auto func = ConstFunc_Cast(decl);
+            type(func->valueType());
+            auto params = func->paramsType();
+            u32(params.size());
+            for (auto param : params)
+                type(param);
+            type(func->recvType());
+            env(func->env(), true);
+            break;
+        }
+
+        case Symbol::Kind::Param: {
+            auto param = ConstParam_Cast(decl);
+            u8(static_cast<uint8_t>(param->direction()));
+            u8(static_cast<uint8_t>(param->evalStrategy()));
+            type(param->valueType());
+            break;
+        }
+
+        case Symbol::Kind::Var:
+        case Symbol::Kind::EnumItem:
+            type(ConstValueDecl_Cast(decl)->valueType());
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    void type(const Type* ty)
+    {
+        if (!ty) {
+            u8(kNoType);
+            return;
+        }
+
+        u8(static_cast<uint8_t>(ty->kind()));
+        u8(static_cast<uint8_t>(ty->typeQuals()));
+
+        switch (ty->kind()) {
+        case Type::Kind::Float:
+            u8(static_cast<uint8_t>(ConstFloatType_Cast(ty)->precision()));
+            break;
+
+        case Type::Kind::Int: {
+            auto intTy = ConstIntType_Cast(ty);
+            u8(static_cast<uint8_t>(intTy->signedness()));
+            u8(static_cast<uint8_t>(intTy->precision()));
+            break;
+        }
+
+        case Type::Kind::Elaborate:
+            ident(ConstElaborateType_Cast(ty)->name());
+            break;
+
+        case Type::Kind::Array: {
+            auto arrayTy = ConstArrayType_Cast(ty);
+            type(arrayTy->baseType());
+            u8(static_cast<uint8_t>(arrayTy->variety()));
+            type(arrayTy->keyType());
+            break;
+        }
+
+        case Type::Kind::Ptr:
+        case Type::Kind::Subrange:
+            type(ConstOpaqueType_Cast(ty)->baseType());
+            break;
+
+        case Type::Kind::Chan: {
+            auto chanTy = ConstChanType_Cast(ty);
+            type(chanTy->baseType());
+            u8(static_cast<uint8_t>(chanTy->variety()));
+            break;
+        }
+
+        case Type::Kind::Record: {
+            auto recTy = ConstRecordType_Cast(ty);
+            u8(static_cast<uint8_t>(recTy->variety()));
+            auto bases = recTy->bases();
+            u32(bases.size());
+            for (auto base : bases)
+                decl(base);
+            env(recTy->env(), false);
+            break;
+        }
+
+        case Type::Kind::Func: {
+            auto funcTy = ConstFuncType_Cast(ty);
+            auto params = funcTy->paramsType();
+            u32(params.size());
+            for (auto param : params)
+                type(param);
+            type(funcTy->returnType());
+            break;
+        }
+
+        case Type::Kind::Enum:
+            env(ConstEnumType_Cast(ty)->env(), false);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    std::string rootDir_;
+    std::string fileName_;
+    std::string body_;
+    std::vector<std::string> strs_;
+    std::unordered_map<std::string, uint32_t> strIdx_;
+};
+
+    //--- Mapping ---//
+
+/*!
+ * \brief The MappedImage class
+ *
+ * The image's bytes: memory-mapped where available, read otherwise.
+ */
+class MappedImage
+{
+public:
+    MappedImage(const std::string& fileName)
+    {
+#ifndef _WIN32
+        int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd == -1)
+            return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                data_ = static_cast<const char*>(addr);
+                size_ = st.st_size;
+            }
+        }
+        close(fd);
+#else
+        std::ifstream ifs(fileName, std::ios::binary);
+        buf_.assign(std::istreambuf_iterator<char>(ifs),
+                    std::istreambuf_iterator<char>());
+        data_ = buf_.data();
+        size_ = buf_.size();
+#endif
+    }
+
+    ~MappedImage()
+    {
+#ifndef _WIN32
+        if (data_)
+            munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    MappedImage(const MappedImage&) = delete;
+    MappedImage& operator=(const MappedImage&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ { nullptr };
+    size_t size_ { 0 };
+#ifdef _WIN32
+    std::string buf_;
+#endif
+};
+
+    //--- Reader ---//
+
+/*!
+ * \brief The ImageCursor class
+ *
+ * Bounds-checked reading of the image's bytes. Once a read goes past the
+ * end, the cursor is no longer ok and every further read yields zero.
+ */
+class ImageCursor
+{
+public:
+    ImageCursor(const char* data, size_t size)
+        : cur_(data)
+        , end_(data + size)
+    {}
+
+    bool ok() const { return ok_; }
+
+    const char* position() const { return cur_; }
+
+    bool has(size_t n)
+    {
+        if (static_cast<size_t>(end_ - cur_) < n)
+            ok_ = false;
+        return ok_;
+    }
+
+    void skip(size_t n)
+    {
+        if (has(n))
+            cur_ += n;
+    }
+
+    uint8_t u8()
+    {
+        if (!has(1))
+            return 0;
+        return static_cast<uint8_t>(*cur_++);
+    }
+
+    uint32_t u32()
+    {
+        uint32_t v = 0;
+        if (!has(sizeof(v)))
+            return v;
+        memcpy(&v, cur_, sizeof(v));
+        cur_ += sizeof(v);
+        return v;
+    }
+
+protected:
+    const char* cur_;
+    const char* end_;
+    bool ok_ { true };
+};
+
+/*!
+ * \brief The ImageTable struct
+ *
+ * What all program records of an image share. Strings point into the
+ * mapped bytes.
+ */
+struct ImageTable
+{
+    std::string imageFileName_;
+    std::string rootDir_;
+    std::vector<std::pair<const char*, uint32_t>> strs_;
+};
+
+class ImageReader final : public ImageCursor
+{
+public:
+    ImageReader(const char* data, size_t size,
+                const ImageTable& table,
+                LexemeMap* lexs)
+        : ImageCursor(data, size)
+        , table_(table)
+        , lexs_(lexs)
+    {}
+
+    std::string path()
+    {
+        bool isRelative = u8();
+        std::string s = str(u32());
+        return isRelative ? table_.rootDir_ + s : s;
+    }
+
+    std::unique_ptr<Program> program()
+    {
+        fileName_ = path();
+        if (!ok_)
+            return nullptr;
+
+        std::unique_ptr<Program> prog(new Program(fileName_));
+        Environment env;
+
+        uint32_t importCnt = u32();
+        for (uint32_t i = 0; ok_ && i < importCnt; ++i) {
+            std::string fromWhere = path();
+            std::string target = str(u32());
+            const Ident* localName = ident();
+            bool isQualified = u8();
+            std::unique_ptr<Import> import(
+                new Import(fromWhere, target, localName, isQualified));
+            uint32_t itemCnt = u32();
+            for (uint32_t j = 0; ok_ && j < itemCnt; ++j) {
+                const Ident* actualName = ident();
+                const Ident* alternateName = ident();
+                if (alternateName)
+                    import->addSelectedItem(actualName, alternateName);
+                else
+                    import->addSelectedItem(actualName);
+            }
+            env.includeImport(std::move(import));
+        }
+
+        this->env(env);
+        if (!ok_)
+            return nullptr;
+
+        prog->setEnv(env);
+        return prog;
+    }
+
+private:
+    /*!
+     * \brief The Nesting struct
+     *
+     * Track how deep declarations and types are being read, so that a
+     * corrupted image can't exhaust the stack.
+     */
+    struct Nesting
+    {
+        Nesting(ImageReader* reader)
+            : reader_(reader)
+        {
+            if (++reader_->nesting_ > kMaxNesting)
+                reader_->ok_ = false;
+        }
+
+        ~Nesting() { --reader_->nesting_; }
+
+        ImageReader* reader_;
+    };
+
+    std::string str(uint32_t idx)
+    {
+        if (idx >= table_.strs_.size()) {
+            ok_ = false;
+            return std::string();
+        }
+        const auto& s = table_.strs_[idx];
+        return std::string(s.first, s.second);
+    }
+
+    const Ident* ident()
+    {
+        uint32_t idx = u32();
+        if (idx == kNone || !ok_)
+            return nullptr;
+        if (idx >= table_.strs_.size()) {
+            ok_ = false;
+            return nullptr;
+        }
+
+        // Each spelling is interned once, at a made-up location of the image
+        // itself, so that it ends up sharing the Ident of real occurrences.
+        const Ident*& ident = idents_[idx];
+        if (!ident) {
+            ident = lexs_->insertOrFind<Ident>(str(idx), table_.imageFileName_,
+                                               LineCol(idx, 0));
+        }
+        return ident;
+    }
+
+    SourceLoc loc()
+    {
+        bool inFile = u8();
+        int line = u32();
+        int col = u32();
+        int lastLine = u32();
+        int lastCol = u32();
+        if (!inFile)
+            return SourceLoc();
+        return SourceLoc(line, col, lastLine, lastCol, fileName_);
+    }
+
+    void env(Environment env)
+    {
+        uint32_t tyCnt = u32();
+        for (uint32_t i = 0; ok_ && i < tyCnt; ++i) {
+            std::unique_ptr<Decl> sym = decl(env);
+            if (sym && isOfTypeDeclClass(sym.get()))
+                env.insertTypeDecl(std::unique_ptr<TypeDecl>(TypeDecl_Cast(sym.release())));
+            else
+                ok_ = false;
+        }
+        uint32_t valCnt = u32();
+        for (uint32_t i = 0; ok_ && i < valCnt; ++i) {
+            std::unique_ptr<Decl> sym = decl(env);
+            if (sym && isOfValueDeclClass(sym.get()))
+                env.insertValueDecl(std::unique_ptr<ValueDecl>(ValueDecl_Cast(sym.release())));
+            else
+                ok_ = false;
+        }
+    }
+
+    std::unique_ptr<Decl> decl(Environment outer)
+    {
+        Nesting nesting(this);
+        auto kind = static_cast<Symbol::Kind>(u8());
+        const Ident* name = ident();
+        SourceLoc loc = this->loc();
+        uint8_t flags = u8();
+        auto visibility = static_cast<Decl::Visibility>(u8());
+        auto storage = static_cast<Decl::Storage>(u8());
+        auto linkage = static_cast<Decl::Linkage>(u8());
+        auto declAttrs = static_cast<uint16_t>(u32());
+        if (!ok_)
+            return nullptr;
+
+        std::unique_ptr<Decl> sym;
+        switch (kind) {
+        case Symbol::Kind::Alias: {
+            std::unique_ptr<Alias> alias(new Alias(name));
+            if (auto ty = type(outer))
+                alias->setType(std::move(ty));
+            sym = std::move(alias);
+            break;
+        }
+
+        case Symbol::Kind::Placeholder: {
+            std::unique_ptr<Placeholder> holder(new Placeholder(name));
+            if (auto ty = type(outer))
+                holder->setType(std::move(ty));
+            sym = std::move(holder);
+            break;
+        }
+
+        case Symbol::Kind::Record: {
+            std::unique_ptr<Record> record(new Record(name));
+            std::unique_ptr<Type> ty = type(outer);
+            if (!ty || ty->kind() != Type::Kind::Record) {
+                ok_ = false;
+                return nullptr;
+            }
+            record->setType(std::unique_ptr<RecordType>(RecordType_Cast(ty.release())));
+            sym = std::move(record);
+            break;
+        }
+
+        case Symbol::Kind::Enum: {
+            std::unique_ptr<Enum> enumm(new Enum(name));
+            if (auto ty = type(outer))
+                enumm->setUnderlyingType(std::move(ty));
+            std::unique_ptr<Type> ty = type(outer);
+            if (ty && ty->kind() == Type::Kind::Enum)
+                enumm->setType(std::unique_ptr<EnumType>(EnumType_Cast(ty.release())));
+            sym = std::move(enumm);
+            break;
+        }
+
+        case Symbol::Kind::Func: {
+            std::unique_ptr<Func> func(new Func(name));
+            std::unique_ptr<FuncType> funcTy(new FuncType);
+            if (auto ty = type(outer))
+                funcTy->setReturnType(std::move(ty));
+            uint32_t paramCnt = u32();
+            for (uint32_t i = 0; ok_ && i < paramCnt; ++i) {
+                std::unique_ptr<Type> ty = type(outer);
+                if (!ty)
+                    ty.reset(new InferredType);
+                funcTy->addParamType(std::move(ty));
+            }
+            func->setType(std::move(funcTy));
+            if (auto ty = type(outer))
+                func->setRecvType(std::move(ty));
+            Environment funcEnv = outer.createSubEnv();
+            env(funcEnv);
+            func->setEnv(funcEnv);
+            sym = std::move(func);
+            break;
+        }
+
+        case Symbol::Kind::Param: {
+            std::unique_ptr<Param> param(new Param(name));
+            param->setDirection(static_cast<Param::Direction>(u8()));
+            param->setEvalStrategy(static_cast<Param::EvalStrategy>(u8()));
+            if (auto ty = type(outer))
+                param->setValueType(std::move(ty));
+            sym = std::move(param);
+            break;
+        }
+
+        case Symbol::Kind::Var: {
+            std::unique_ptr<Var> var(new Var(name));
+            if (auto ty = type(outer))
+                var->setValueType(std::move(ty));
+            sym = std::move(var);
+            break;
+        }
+
+        case Symbol::Kind::EnumItem: {
+            std::unique_ptr<EnumItem> item(new EnumItem(name));
+            if (auto ty = type(outer))
+                item->setValueType(std::move(ty));
+            sym = std::move(item);
+            break;
+        }
+
+        case Symbol::Kind::BaseRecord:
+            sym.reset(new BaseRecord(name));
+            break;
+
+        default:
+            ok_ = false;
+            return nullptr;
+        }
+
+        sym->setSourceLoc(loc);
+        sym->setIsBuiltin(flags & Builtin);
+        sym->setIsFake(flags & Fake);
+        if (flags & Auto)
+            sym->markAsAuto();
+        sym->setVisibility(visibility);
+        sym->setStorage(storage);
+        sym->setLinkage(linkage);
+        sym->setDeclAttrs(DeclAttrFlags(declAttrs));
+
+        return sym;
+    }
+
+    std::unique_ptr<Type> type(Environment outer)
+    {
+        Nesting nesting(this);
+        uint8_t tag = u8();
+        if (tag == kNoType || !ok_)
+            return nullptr;
+        auto quals = u8();
+
+        std::unique_ptr<Type> ty;
+        switch (static_cast<Type::Kind>(tag)) {
+        case Type::Kind::Bool:
+            ty.reset(new BoolType);
+            break;
+
+        case Type::Kind::Str:
+            ty.reset(new StrType);
+            break;
+
+        case Type::Kind::Inferred:
+            ty.reset(new InferredType);
+            break;
+
+        case Type::Kind::Empty:
+            ty.reset(new EmptyType);
+            break;
+
+        case Type::Kind::Float:
+            ty.reset(new FloatType(static_cast<Precision>(u8())));
+            break;
+
+        case Type::Kind::Int: {
+            auto s = static_cast<Signedness>(u8());
+            auto p = static_cast<Precision>(u8());
+            ty.reset(new IntType(s, p));
+            break;
+        }
+
+        case Type::Kind::Elaborate:
+            ty.reset(new ElaborateType(ident()));
+            break;
+
+        case Type::Kind::Array: {
+            std::unique_ptr<ArrayType> arrayTy(new ArrayType(type(outer)));
+            arrayTy->setVariety(static_cast<ArrayVariety>(u8()));
+            if (auto keyTy = type(outer))
+                arrayTy->setKeyType(std::move(keyTy));
+            ty = std::move(arrayTy);
+            break;
+        }
+
+        case Type::Kind::Ptr:
+            ty.reset(new PtrType(type(outer)));
+            break;
+
+        case Type::Kind::Subrange:
+            ty.reset(new SubrangeType(type(outer)));
+            break;
+
+        case Type::Kind::Chan: {
+            std::unique_ptr<ChanType> chanTy(new ChanType(type(outer)));
+            chanTy->setVariety(static_cast<ChanVariety>(u8()));
+            ty = std::move(chanTy);
+            break;
+        }
+
+        case Type::Kind::Record: {
+            std::unique_ptr<RecordType> recTy(new RecordType);
+            recTy->setVariety(static_cast<RecordVariety>(u8()));
+            uint32_t baseCnt = u32();
+            for (uint32_t i = 0; ok_ && i < baseCnt; ++i) {
+                std::unique_ptr<Decl> base = decl(outer);
+                if (!base || base->kind() != Symbol::Kind::BaseRecord) {
+                    ok_ = false;
+                    return nullptr;
+                }
+                recTy->addBase(std::unique_ptr<BaseRecord>(BaseRecord_Cast(base.release())));
+            }
+            Environment recEnv = outer.createSubEnv();
+            env(recEnv);
+            recTy->setEnv(recEnv);
+            ty = std::move(recTy);
+            break;
+        }
+
+        case Type::Kind::Func: {
+            std::unique_ptr<FuncType> funcTy(new FuncType);
+            uint32_t paramCnt = u32();
+            for (uint32_t i = 0; ok_ && i < paramCnt; ++i) {
+                std::unique_ptr<Type> paramTy = type(outer);
+                if (!paramTy)
+                    paramTy.reset(new InferredType);
+                funcTy->addParamType(std::move(paramTy));
+            }
+            if (auto retTy = type(outer))
+                funcTy->setReturnType(std::move(retTy));
+            ty = std::move(funcTy);
+            break;
+        }
+
+        case Type::Kind::Enum: {
+            std::unique_ptr<EnumType> enumTy(new EnumType);
+            Environment enumEnv = outer.createSubEnv();
+            env(enumEnv);
+            enumTy->setEnv(enumEnv);
+            ty = std::move(enumTy);
+            break;
+        }
+
+        default:
+            ok_ = false;
+            return nullptr;
+        }
+
+        ty->setTypeQuals(TypeQualFlags(quals));
+        return ty;
+    }
+
+    const ImageTable& table_;
+    LexemeMap* lexs_;
+    std::string fileName_;
+    std::unordered_map<uint32_t, const Ident*> idents_;
+    unsigned nesting_ { 0 };
+};
+
+} // namespace anonymous
+
+struct uaiso::ProgramImage::ProgramImageImpl
+{
+    std::unique_ptr<MappedImage> image_;
+    ImageTable table_;
+    std::vector<std::string> fileNames_;
+    std::unordered_map<std::string, std::pair<const char*, uint32_t>> records_;
+};
+
+ProgramImage::ProgramImage()
+    : P(new ProgramImageImpl)
+{}
+
+ProgramImage::~ProgramImage()
+{}
+
+bool ProgramImage::write(const std::string& imageFileName,
+                         const std::string& rootDir,
+                         const std::vector<const Program*>& progs)
+{
+    ImageWriter writer(rootDir);
+    uint32_t progCnt = 0;
+    for (auto prog : progs) {
+        UAISO_ASSERT(prog, continue);
+        writer.program(prog);
+        ++progCnt;
+    }
+
+    std::ofstream ofs(imageFileName, std::ios::binary | std::ios::trunc);
+    if (!ofs)
+        return false;
+    std::string image = writer.finish(progCnt);
+    ofs.write(image.data(), image.size());
+
+    DEBUG_TRACE("wrote %u programs into %s\n", progCnt, imageFileName.c_str());
+
+    return static_cast<bool>(ofs);
+}
+
+bool ProgramImage::open(const std::string& imageFileName,
+                        const std::string& rootDir)
+{
+    P.reset(new ProgramImageImpl);
+    std::unique_ptr<MappedImage> image(new MappedImage(imageFileName));
+    if (!image->data())
+        return false;
+
+    ImageTable table;
+    table.imageFileName_ = imageFileName;
+    table.rootDir_ = rootDir;
+
+    ImageCursor cursor(image->data(), image->size());
+    if (!cursor.has(sizeof(kMagic))
+            || memcmp(cursor.position(), kMagic, sizeof(kMagic))) {
+        return false;
+    }
+    cursor.skip(sizeof(kMagic));
+    if (cursor.u32() != kVersion || cursor.u32() != kByteOrder)
+        return false;
+
+    uint32_t strCnt = cursor.u32();
+    for (uint32_t i = 0; cursor.ok() && i < strCnt; ++i) {
+        uint32_t len = cursor.u32();
+        if (!cursor.has(len))
+            break;
+        table.strs_.emplace_back(cursor.position(), len);
+        cursor.skip(len);
+    }
+
+    // Only the file name of each program record is read.
+    std::vector<std::string> fileNames;
+    std::unordered_map<std::string, std::pair<const char*, uint32_t>> records;
+    uint32_t progCnt = cursor.u32();
+    for (uint32_t i = 0; cursor.ok() && i < progCnt; ++i) {
+        uint32_t size = cursor.u32();
+        if (!cursor.has(size))
+            break;
+        ImageReader reader(cursor.position(), size, table, nullptr);
+        std::string fileName = reader.path();
+        if (!reader.ok())
+            break;
+        records.emplace(fileName, std::make_pair(cursor.position(), size));
+        fileNames.push_back(std::move(fileName));
+        cursor.skip(size);
+    }
+    if (!cursor.ok()) {
+        DEBUG_TRACE("malformed image %s\n", imageFileName.c_str());
+        return false;
+    }
+
+    P->image_ = std::move(image);
+    P->table_ = std::move(table);
+    P->fileNames_ = std::move(fileNames);
+    P->records_ = std::move(records);
+
+    DEBUG_TRACE("opened %zu programs from %s\n",
+                P->fileNames_.size(), imageFileName.c_str());
+
+    return true;
+}
+
+std::vector<std::string> ProgramImage::fileNames() const
+{
+    return P->fileNames_;
+}
+
+bool ProgramImage::contains(const std::string& fullFileName) const
+{
+    return P->records_.count(fullFileName) != 0;
+}
+
+std::unique_ptr<Program> ProgramImage::program(const std::string& fullFileName,
+                                               LexemeMap* lexs) const
+{
+    UAISO_ASSERT(lexs, return nullptr);
+
+    auto it = P->records_.find(fullFileName);
+    if (it == P->records_.end())
+        return nullptr;
+
+    ImageReader reader(it->second.first, it->second.second, P->table_, lexs);
+    std::unique_ptr<Program> prog = reader.program();
+    if (!prog)
+        DEBUG_TRACE("malformed record of %s\n", fullFileName.c_str());
+    return prog;
+}
+
+size_t ProgramImage::load(LexemeMap* lexs, Snapshot snapshot) const
+{
+    UAISO_ASSERT(lexs, return 0);
+
+    // Programs are only inserted once the whole image has been read, so a
+    // malformed one doesn't leave the snapshot partially populated.
+    std::vector<std::unique_ptr<Program>> progs;
+    for (const auto& fileName : P->fileNames_) {
+        std::unique_ptr<Program> prog = program(fileName, lexs);
+        if (!prog)
+            return 0;
+        progs.push_back(std::move(prog));
+    }
+
+    for (auto& prog : progs) {
+        auto fileName = prog->fileInfo().fullFileName();
+        snapshot.insertOrReplace(fileName, std::move(prog));
+    }
+
+    return progs.size();
+}
@@ -0,0 +1,135 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#ifndef UAISO_PROGRAMIMAGE_H__
+#define UAISO_PROGRAMIMAGE_H__
+
+#include "Common/Config.h"
+#include "Common/Pimpl.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace uaiso {
+
+class LexemeMap;
+class Program;
+class Snapshot;
+
+/*!
+ * \brief The ProgramImage class
+ *
+ * A read-only image of bound programs (typically, those of a stdlib tree)
+ * that can be used without parsing or binding. The image is position
+ * independent: symbols, types, and identifiers are addressed by offsets and
+ * indexes into a string table, and file names under the image's root
+ * directory are stored relative to it.
+ *
+ * An opened image stays memory-mapped. Only its string table and an index
+ * of the programs are read upfront; a program's symbols are built from the
+ * mapped bytes once it's requested (e.g., by a Manager processing an import
+ * of it).
+ *
+ * Only what a program declares is recorded. Namespaces injected by import
+ * resolution are not, since the imports themselves are kept and resolved
+ * again by the Manager. Function locals other than parameters are dropped.
+ */
+class UAISO_API ProgramImage final
+{
+public:
+    ProgramImage();
+    ~ProgramImage();
+
+    /*!
+     * \brief write
+     * \param imageFileName
+     * \param rootDir
+     * \param progs
+     * \return
+     *
+     * Write an image of \a progs into \a imageFileName. File names starting
+     * with \a rootDir are stored relative to it.
+     */
+    static bool write(const std::string& imageFileName,
+                      const std::string& rootDir,
+                      const std::vector<const Program*>& progs);
+
+    /*!
+     * \brief open
+     * \param imageFileName
+     * \param rootDir
+     * \return
+     *
+     * Map \a imageFileName into memory, with relative file names placed
+     * under \a rootDir. Return whether the image is well-formed.
+     */
+    bool open(const std::string& imageFileName, const std::string& rootDir);
+
+    /*!
+     * \brief fileNames
+     * \return
+     *
+     * Return the full file names of the programs in the image.
+     */
+    std::vector<std::string> fileNames() const;
+
+    /*!
+     * \brief contains
+     * \param fullFileName
+     * \return
+     */
+    bool contains(const std::string& fullFileName) const;
+
+    /*!
+     * \brief program
+     * \param fullFileName
+     * \param lexs
+     * \return
+     *
+     * Build the program of \a fullFileName from the image, with identifiers
+     * interned in \a lexs. Return null if the image doesn't contain such a
+     * program or if its record is malformed.
+     */
+    std::unique_ptr<Program> program(const std::string& fullFileName,
+                                     LexemeMap* lexs) const;
+
+    /*!
+     * \brief load
+     * \param lexs
+     * \param snapshot
+     * \return
+     *
+     * Build every program of the image and insert them into \a snapshot.
+     * Return how many programs were loaded, which is zero if any of them is
+     * malformed.
+     */
+    size_t load(LexemeMap* lexs, Snapshot snapshot) const;
+
+private:
+    DECL_PIMPL(ProgramImage)
+};
+
+} // namespace uaiso
+
+#endif
@@ -0,0 +1,449 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Semantic/SessionReplayer.h"
+#include "Semantic/CompletionSession.h"
+#include "Semantic/Manager.h"
+#include "Semantic/Snapshot.h"
+#include "Common/Assert.h"
+#include "Common/LatencyStats.h"
+#include "Common/Trace__.h"
+#include "Parsing/Factory.h"
+#include "Parsing/IncrementalLexer.h"
+#include "Parsing/Lang.h"
+#include "Parsing/LangId.h"
+#include "Parsing/LexemeMap.h"
+#include "Parsing/Phrasing.h"
+#include "Parsing/TokenMap.h"
+#include "Parsing/Unit.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#define TRACE_NAME "SessionReplayer"
+
+using namespace uaiso;
+
+namespace {
+
+enum class EventKind : char
+{
+    Open,
+    Insert,
+    Erase,
+    Process,
+    Complete,
+    Highlight,
+    Lex
+};
+
+struct Event
+{
+    uint64_t time_ { 0 };
+    EventKind kind_;
+    std::string text_; // File name or inserted text.
+    int line_ { 0 };
+    int col_ { 0 };
+    int cnt_ { 0 };
+};
+
+/*!
+ * \brief requestKey
+ * \return
+ *
+ * Return the key under which the latency of an event is recorded, or null
+ * if the event is an edit.
+ */
+const LatencyStats::Key* requestKey(EventKind kind)
+{
+    static const LatencyStats::Key processKey("replay.process");
+    static const LatencyStats::Key completeKey("replay.complete");
+    static const LatencyStats::Key highlightKey("replay.highlight");
+    static const LatencyStats::Key lexKey("replay.lex");
+
+    switch (kind) {
+    case EventKind::Process:
+        return &processKey;
+    case EventKind::Complete:
+        return &completeKey;
+    case EventKind::Highlight:
+        return &highlightKey;
+    case EventKind::Lex:
+        return &lexKey;
+    default:
+        return nullptr;
+    }
+}
+
+bool readQuoted(std::istream& is, std::string& text)
+{
+    char c;
+    if (!(is >> c) || c != '"')
+        return false;
+
+    while (is.get(c)) {
+        if (c == '"')
+            return true;
+        if (c != '\\') {
+            text += c;
+            continue;
+        }
+        if (!is.get(c))
+            return false;
+        switch (c) {
+        case 'n': text += '\n'; break;
+        case 't': text += '\t'; break;
+        case '"': text += '"'; break;
+        case '\\': text += '\\'; break;
+        default: return false;
+        }
+    }
+    return false;
+}
+
+/*!
+ * \brief offsetOf
+ * \return
+ *
+ * Return the offset of the given line and column of the buffer, or npos if
+ * there's no such position.
+ */
+size_t offsetOf(const std::string& buffer, int line, int col)
+{
+    size_t offset = 0;
+    for (; line > 0; --line) {
+        offset = buffer.find('\n', offset);
+        if (offset == std::string::npos)
+            return offset;
+        ++offset;
+    }
+    size_t end = buffer.find('\n', offset);
+    if (end == std::string::npos)
+        end = buffer.size();
+    if (col > int(end - offset))
+        return std::string::npos;
+    return offset + col;
+}
+
+std::unique_ptr<Factory> factoryFor(const std::string& fileName)
+{
+    for (auto langId : availableLangs()) {
+        auto factory = FactoryCreator::create(langId);
+        auto suffix = factory->makeLang()->sourceFileSuffix();
+        if (fileName.size() > suffix.size()
+                && !fileName.compare(fileName.size() - suffix.size(),
+                                     suffix.size(), suffix)) {
+            return factory;
+        }
+    }
+    return std::unique_ptr<Factory>();
+}
+
+} // anonymous
+
+struct uaiso::SessionReplayer::SessionReplayerImpl
+{
+    // The engine of a language, created by the first file opened in it.
+    struct Engine
+    {
+        std::unique_ptr<Factory> factory_;
+        TokenMap tokens_;
+        LexemeMap lexs_;
+        Snapshot snapshot_;
+        Manager manager_;
+        CompletionSession session_ { &manager_ };
+    };
+
+    std::string dataDir_;
+    std::vector<std::string> searchPaths_;
+    std::vector<Event> events_;
+    size_t errorLine_ { 0 };
+
+    std::map<LangId, std::unique_ptr<Engine>> engines_;
+    Engine* engine_ { nullptr };
+    std::string fileName_;
+    std::string buffer_;
+    bool edited_ { false };
+
+    // The lexer of the opened file, fed with its lines as an editor's
+    // highlighter does, and the state at the start of the lines known so
+    // far (edits drop the ones of the lines after them).
+    std::unique_ptr<IncrementalLexer> lexer_;
+    std::vector<IncrementalLexer::State> lineStates_;
+
+    bool open(const std::string& fileName)
+    {
+        fileName_ = dataDir_.empty() ? fileName : dataDir_ + "/" + fileName;
+        std::ifstream ifs(fileName_);
+        if (!ifs.is_open())
+            return false;
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        buffer_ = oss.str();
+        edited_ = false;
+
+        auto factory = factoryFor(fileName_);
+        if (!factory)
+            return false;
+        auto& engine = engines_[factory->langName()];
+        if (!engine) {
+            engine.reset(new Engine);
+            engine->factory_ = std::move(factory);
+            engine->manager_.config(engine->factory_.get(), &engine->tokens_,
+                                    &engine->lexs_, engine->snapshot_);
+            for (const auto& path : searchPaths_)
+                engine->manager_.addSearchPath(path);
+        }
+        engine_ = engine.get();
+        lexer_ = engine_->factory_->makeIncrementalLexer();
+        lineStates_.assign(1, IncrementalLexer::InCode);
+        return true;
+    }
+
+    void lex()
+    {
+        if (!lexer_)
+            return;
+        lexer_->lex(buffer_, IncrementalLexer::InCode);
+        std::unique_ptr<Phrasing> phrasing(lexer_->releasePhrasing());
+    }
+
+    // Lex the given lines, and the ones before them whose states aren't
+    // known, each from the state in which the previous one ended.
+    bool highlight(int line, int cnt)
+    {
+        if (offsetOf(buffer_, line, 0) == std::string::npos)
+            return false;
+        if (!lexer_)
+            return true;
+
+        static const LatencyStats::Key linesKey("replay.highlight.lines");
+        size_t cur = std::min(size_t(line), lineStates_.size() - 1);
+        size_t offset = offsetOf(buffer_, int(cur), 0);
+        size_t last = size_t(line) + cnt;
+        for (; cur < last && offset < buffer_.size(); ++cur) {
+            size_t next = buffer_.find('\n', offset);
+            next = next == std::string::npos ? buffer_.size() : next + 1;
+            lexer_->lex(buffer_.substr(offset, next - offset), lineStates_[cur]);
+            std::unique_ptr<Phrasing> phrasing(lexer_->releasePhrasing());
+            LatencyStats::count(linesKey);
+            if (lineStates_.size() == cur + 1)
+                lineStates_.push_back(lexer_->state());
+            else
+                lineStates_[cur + 1] = lexer_->state();
+            offset = next;
+        }
+        return true;
+    }
+
+    void edit(int line)
+    {
+        lineStates_.resize(std::min(lineStates_.size(), size_t(line) + 1));
+        edited_ = true;
+    }
+
+    // Lexemes and tokens are indexed by position, the ones of the buffer
+    // before it was edited must go.
+    void forgetEdits()
+    {
+        if (!edited_)
+            return;
+        engine_->lexs_.clear(fileName_);
+        engine_->tokens_.clear(fileName_);
+        edited_ = false;
+    }
+
+    bool run(const Event& event)
+    {
+        switch (event.kind_) {
+        case EventKind::Open:
+            return open(event.text_);
+
+        case EventKind::Insert: {
+            size_t offset = offsetOf(buffer_, event.line_, event.col_);
+            if (offset == std::string::npos)
+                return false;
+            buffer_.insert(offset, event.text_);
+            edit(event.line_);
+            return true;
+        }
+
+        case EventKind::Erase: {
+            size_t offset = offsetOf(buffer_, event.line_, event.col_);
+            if (offset == std::string::npos
+                    || offset + event.cnt_ > buffer_.size()) {
+                return false;
+            }
+            buffer_.erase(offset, event.cnt_);
+            edit(event.line_);
+            return true;
+        }
+
+        case EventKind::Process:
+            forgetEdits();
+            engine_->session_.invalidate();
+            engine_->manager_.process(buffer_, fileName_);
+            return true;
+
+        case EventKind::Complete:
+            forgetEdits();
+            engine_->session_.complete(buffer_, fileName_,
+                                       LineCol(event.line_, event.col_));
+            return true;
+
+        case EventKind::Highlight:
+            return highlight(event.line_, event.cnt_);
+
+        case EventKind::Lex:
+            lex();
+            return true;
+        }
+
+        UAISO_ASSERT(false, {});
+        return false;
+    }
+};
+
+SessionReplayer::SessionReplayer()
+    : P(new SessionReplayerImpl)
+{}
+
+SessionReplayer::~SessionReplayer()
+{}
+
+void SessionReplayer::setDataDir(const std::string& dir)
+{
+    P->dataDir_ = dir;
+}
+
+void SessionReplayer::addSearchPath(const std::string& searchPath)
+{
+    P->searchPaths_.push_back(searchPath);
+}
+
+bool SessionReplayer::load(std::istream& is)
+{
+    static const std::map<std::string, EventKind> kinds {
+        { "open", EventKind::Open },
+        { "insert", EventKind::Insert },
+        { "erase", EventKind::Erase },
+        { "process", EventKind::Process },
+        { "complete", EventKind::Complete },
+        { "highlight", EventKind::Highlight },
+        { "lex", EventKind::Lex }
+    };
+
+    P->events_.clear();
+    P->errorLine_ = 0;
+
+    std::string line;
+    size_t lineNum = 0;
+    bool opened = false;
+    while (std::getline(is, line)) {
+        ++lineNum;
+        std::istringstream iss(line);
+        std::string word;
+        if (!(iss >> word) || word[0] == '#')
+            continue;
+
+        Event event;
+        auto kind = kinds.end();
+        bool ok = (std::istringstream(word) >> event.time_)
+                && (iss >> word)
+                && (kind = kinds.find(word)) != kinds.end()
+                && (P->events_.empty() || P->events_.back().time_ <= event.time_);
+        if (ok) {
+            event.kind_ = kind->second;
+            switch (event.kind_) {
+            case EventKind::Open:
+                ok = bool(iss >> event.text_);
+                opened = true;
+                break;
+            case EventKind::Insert:
+                ok = (iss >> event.line_ >> event.col_)
+                        && readQuoted(iss, event.text_);
+                break;
+            case EventKind::Erase:
+                ok = bool(iss >> event.line_ >> event.col_ >> event.cnt_);
+                break;
+            case EventKind::Highlight:
+                ok = bool(iss >> event.line_ >> event.cnt_);
+                break;
+            case EventKind::Complete:
+                ok = bool(iss >> event.line_ >> event.col_);
+                break;
+            default:
+                break;
+            }
+            // Requests need a buffer, and nothing may follow the arguments.
+            ok = ok && opened && !(iss >> word);
+        }
+        if (!ok) {
+            DEBUG_TRACE("malformed event at line %zu\n", lineNum);
+            P->events_.clear();
+            P->errorLine_ = lineNum;
+            return false;
+        }
+        P->events_.push_back(std::move(event));
+    }
+
+    return true;
+}
+
+size_t SessionReplayer::errorLine() const
+{
+    return P->errorLine_;
+}
+
+bool SessionReplayer::replay(LatencyStats* stats)
+{
+    P->engines_.clear();
+    P->engine_ = nullptr;
+    P->fileName_.clear();
+    P->buffer_.clear();
+    P->edited_ = false;
+    P->lexer_.reset();
+    P->lineStates_.clear();
+
+    for (const auto& event : P->events_) {
+        auto start = std::chrono::steady_clock::now();
+        if (!P->run(event))
+            return false;
+        const LatencyStats::Key* key = requestKey(event.kind_);
+        if (stats && key) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            stats->record(*key, std::chrono::duration_cast<
+                          std::chrono::nanoseconds>(elapsed).count());
+        }
+    }
+
+    return true;
+}
+
+const std::string& SessionReplayer::buffer() const
+{
+    return P->buffer_;
+}
@@ -0,0 +1,124 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#ifndef UAISO_SESSIONREPLAYER_H__
+#define UAISO_SESSIONREPLAYER_H__
+
+#include "Common/Config.h"
+#include "Common/Pimpl.h"
+#include "Common/Test.h"
+#include <istream>
+#include <string>
+
+namespace uaiso {
+
+class LatencyStats;
+
+/*!
+ * \brief The SessionReplayer class
+ *
+ * Replay a recorded editor session: edits to a buffer interleaved with
+ * requests to the engine. A session has one event per line, in the form
+ * "<time> <event> <arguments>", with time in milliseconds since the start
+ * of the session. Lines and columns start at 0; '#' starts a comment.
+ *
+ *     open <file>                     Load the buffer, the file is relative
+ *                                     to the data directory.
+ *     insert <line> <col> "<text>"    Insert text, escapes are \n, \t, \"
+ *                                     and \\.
+ *     erase <line> <col> <count>      Erase characters.
+ *     process                         Process the buffer (Manager).
+ *     complete <line> <col>           Complete at a position, as a popup
+ *                                     does while typing (CompletionSession).
+ *     highlight <line> <count>        Lex lines, one at a time, as a
+ *                                     highlighter does (IncrementalLexer).
+ *     lex                             Lex the buffer (IncrementalLexer).
+ *
+ * A file's lexer persists until another file is opened. Lines are lexed
+ * from the state the previous line ended in, so highlighting a line first
+ * lexes the lines before it whose states an edit invalidated.
+ *
+ * Time only orders the events: a replay doesn't wait between them, and
+ * starts from a fresh engine, so replays are deterministic.
+ */
+class UAISO_API SessionReplayer final
+{
+public:
+    SessionReplayer();
+    ~SessionReplayer();
+
+    /*!
+     * \brief setDataDir
+     * \param dir
+     *
+     * Set the directory to which opened files are relative.
+     */
+    void setDataDir(const std::string& dir);
+
+    void addSearchPath(const std::string& searchPath);
+
+    /*!
+     * \brief load
+     * \param is
+     * \return
+     *
+     * Load a session, return whether it's well-formed.
+     */
+    bool load(std::istream& is);
+
+    /*!
+     * \brief errorLine
+     * \return
+     *
+     * Return the line (starting at 1) of the last session that couldn't be
+     * loaded, or 0.
+     */
+    size_t errorLine() const;
+
+    /*!
+     * \brief replay
+     * \param stats
+     * \return
+     *
+     * Replay the loaded session, recording the latency of every request
+     * into the stats (if any) under "replay.<request>". Return whether the
+     * session could be replayed to its end.
+     */
+    bool replay(LatencyStats* stats);
+
+    /*!
+     * \brief buffer
+     * \return
+     *
+     * Return the buffer as the last replay left it.
+     */
+    const std::string& buffer() const;
+
+private:
+    DECL_PIMPL(SessionReplayer)
+    DECL_CLASS_TEST(SessionReplayer)
+};
+
+} // namespace uaiso
+
+#endif
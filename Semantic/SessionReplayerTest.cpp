@@ -0,0 +1,180 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Semantic/SessionReplayer.h"
+#include "Common/LatencyStats.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+using namespace uaiso;
+
+class SessionReplayer::SessionReplayerTest final : public Test
+{
+public:
+    TEST_RUN(SessionReplayerTest
+             , &SessionReplayerTest::testCase1
+             , &SessionReplayerTest::testCase2
+             , &SessionReplayerTest::testCase3
+             , &SessionReplayerTest::testCase4
+             )
+
+    ~SessionReplayerTest()
+    {
+        removeFiles();
+    }
+
+    void reset() override
+    {
+        removeFiles();
+#ifndef _WIN32
+        char dirTemplate[] = "/tmp/uaisoXXXXXX";
+        if (mkdtemp(dirTemplate))
+            dir_ = dirTemplate;
+#endif
+    }
+
+    void removeFiles()
+    {
+        if (dir_.empty())
+            return;
+        std::remove((dir_ + "/a.py").c_str());
+        std::remove(dir_.c_str());
+        dir_.clear();
+    }
+
+    bool load(SessionReplayer& replayer, const std::string& session)
+    {
+        std::istringstream iss(session);
+        return replayer.load(iss);
+    }
+
+    void testCase1()
+    {
+        // Malformed sessions are rejected at their first bad line.
+        SessionReplayer replayer;
+        UAISO_EXPECT_TRUE(load(replayer, "# comment\n\n0 open a.py\n10 lex\n"));
+        UAISO_EXPECT_FALSE(load(replayer, "0 open a.py\n10 frobnicate\n"));
+        UAISO_EXPECT_INT_EQ(2, replayer.errorLine());
+        UAISO_EXPECT_FALSE(load(replayer, "0 open a.py\n10 lex\n5 lex\n"));
+        UAISO_EXPECT_INT_EQ(3, replayer.errorLine());
+        UAISO_EXPECT_FALSE(load(replayer, "0 open a.py\n10 insert 0 0 \"x\\q\"\n"));
+        UAISO_EXPECT_INT_EQ(2, replayer.errorLine());
+        UAISO_EXPECT_FALSE(load(replayer, "0 open a.py\n10 complete 1\n"));
+        UAISO_EXPECT_INT_EQ(2, replayer.errorLine());
+        UAISO_EXPECT_FALSE(load(replayer, "0 open a.py\n10 lex 1\n"));
+        UAISO_EXPECT_INT_EQ(2, replayer.errorLine());
+        UAISO_EXPECT_FALSE(load(replayer, "0 process\n"));
+        UAISO_EXPECT_INT_EQ(1, replayer.errorLine());
+    }
+
+    void testCase2()
+    {
+        if (dir_.empty())
+            UAISO_SKIP_TEST;
+
+        // Edits are applied, and every request is timed, on every replay.
+        std::ofstream(dir_ + "/a.py") << "def f(a):\n    return a\n";
+        SessionReplayer replayer;
+        replayer.setDataDir(dir_);
+        UAISO_EXPECT_TRUE(load(replayer,
+                               "0 open a.py\n"
+                               "0 process\n"
+                               "100 insert 1 0 \"    b = \\\"\\\\\\\"\\n    \\n\"\n"
+                               "110 highlight 1 2\n"
+                               "120 complete 2 4\n"
+                               "130 erase 1 8 3\n"
+                               "140 process\n"
+                               "150 lex\n"));
+        LatencyStats stats;
+        UAISO_EXPECT_TRUE(replayer.replay(&stats));
+        UAISO_EXPECT_STR_EQ("def f(a):\n    b = \n    \n    return a\n",
+                            replayer.buffer());
+        UAISO_EXPECT_TRUE(replayer.replay(&stats));
+
+        auto entries = stats.entries();
+        UAISO_EXPECT_INT_EQ(4, entries.size());
+        UAISO_EXPECT_STR_EQ("replay.complete", entries[0].name_);
+        UAISO_EXPECT_INT_EQ(2, entries[0].histogram_.count_);
+        UAISO_EXPECT_STR_EQ("replay.highlight", entries[1].name_);
+        UAISO_EXPECT_INT_EQ(2, entries[1].histogram_.count_);
+        UAISO_EXPECT_STR_EQ("replay.lex", entries[2].name_);
+        UAISO_EXPECT_INT_EQ(2, entries[2].histogram_.count_);
+        UAISO_EXPECT_STR_EQ("replay.process", entries[3].name_);
+        UAISO_EXPECT_INT_EQ(4, entries[3].histogram_.count_);
+    }
+
+    void testCase3()
+    {
+        if (dir_.empty())
+            UAISO_SKIP_TEST;
+
+        // Edits out of the buffer, or files that can't be opened, stop
+        // the replay.
+        std::ofstream(dir_ + "/a.py") << "x = 1\n";
+        SessionReplayer replayer;
+        replayer.setDataDir(dir_);
+        UAISO_EXPECT_TRUE(load(replayer, "0 open a.py\n1 insert 0 9 \"y\"\n"));
+        UAISO_EXPECT_FALSE(replayer.replay(nullptr));
+        UAISO_EXPECT_TRUE(load(replayer, "0 open a.py\n1 erase 0 4 5\n"));
+        UAISO_EXPECT_FALSE(replayer.replay(nullptr));
+        UAISO_EXPECT_TRUE(load(replayer, "0 open b.py\n"));
+        UAISO_EXPECT_FALSE(replayer.replay(nullptr));
+        UAISO_EXPECT_TRUE(load(replayer, "0 open a.py\n1 erase 0 4 1\n"));
+        UAISO_EXPECT_TRUE(replayer.replay(nullptr));
+        UAISO_EXPECT_STR_EQ("x = \n", replayer.buffer());
+    }
+
+    void testCase4()
+    {
+        if (dir_.empty())
+            UAISO_SKIP_TEST;
+
+        // Lines before a highlighted one are lexed only while their states
+        // aren't known: at first, and after an edit above them.
+        std::ofstream(dir_ + "/a.py") << "a = 1\nb = 2\nc = 3\nd = 4\ne = 5\n";
+        SessionReplayer replayer;
+        replayer.setDataDir(dir_);
+        UAISO_EXPECT_TRUE(load(replayer,
+                               "0 open a.py\n"
+                               "10 highlight 3 1\n"
+                               "20 highlight 3 1\n"
+                               "30 insert 1 0 \"x\"\n"
+                               "40 highlight 3 1\n"
+                               "50 highlight 4 9\n"));
+        LatencyStats stats;
+        stats.attach();
+        UAISO_EXPECT_TRUE(replayer.replay(nullptr));
+        stats.detach();
+
+        auto counters = stats.counters();
+        UAISO_EXPECT_INT_EQ(1, counters.size());
+        UAISO_EXPECT_STR_EQ("replay.highlight.lines", counters[0].name_);
+        UAISO_EXPECT_INT_EQ(4 + 1 + 3 + 1, counters[0].value_);
+    }
+
+    std::string dir_;
+};
+
+MAKE_CLASS_TEST(SessionReplayer)
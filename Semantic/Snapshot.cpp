@@ -22,20 +22,139 @@
 /*--------------------------*/
 
 #include "Semantic/Snapshot.h"
+#include "Semantic/Environment.h"
 #include "Semantic/Program.h"
 #include "Semantic/Symbol.h"
+#include "Semantic/Type.h"
 #include "Ast/Ast.h"
 #include "Common/Assert.h"
 #include "Parsing/LexemeMap.h"
 #include "Parsing/TokenMap.h"
+#include <atomic>
+#include <mutex>
+#include <set>
 #include <unordered_map>
 #include <vector>
 
 using namespace uaiso;
 
+namespace {
+
+// Revisions are drawn from a single counter, so that they're unique.
+std::atomic<size_t> lastRevision_ { 0 };
+
+size_t nextRevision()
+{
+    return ++lastRevision_;
+}
+
+struct MemoKey
+{
+    const TypeDecl* tyDecl_;
+    bool indirect_;
+    const TypeDecl* ifaceDecl_;
+
+    bool operator==(const MemoKey& other) const
+    {
+        return tyDecl_ == other.tyDecl_
+                && indirect_ == other.indirect_
+                && ifaceDecl_ == other.ifaceDecl_;
+    }
+};
+
+struct MemoKeyHash
+{
+    size_t operator()(const MemoKey& key) const
+    {
+        std::hash<const void*> hasher;
+        size_t h = hasher(key.tyDecl_);
+        h ^= hasher(key.ifaceDecl_) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h ^ static_cast<size_t>(key.indirect_);
+    }
+};
+
+/*!
+ * The key of an elaborate type resolution. It holds the scope, so its
+ * identity can't be taken by another environment while memoized.
+ */
+struct ResolutionKey
+{
+    Environment scope_;
+    const Ident* name_;
+
+    bool operator==(const ResolutionKey& other) const
+    {
+        return scope_ == other.scope_ && name_ == other.name_;
+    }
+};
+
+struct ResolutionKeyHash
+{
+    size_t operator()(const ResolutionKey& key) const
+    {
+        size_t h = key.scope_.hash();
+        return h ^ (std::hash<const void*>()(key.name_) + 0x9e3779b9 + (h << 6) + (h >> 2));
+    }
+};
+
+// Scopes of programs that aren't in the snapshot (of completion snippets,
+// for instance) don't bump the revision, so the resolutions are bounded.
+const size_t maxResolutions = 1 << 16;
+
+} // anonymous
+
 struct uaiso::Snapshot::SnapshotImpl
 {
-    std::unordered_map<std::string, std::unique_ptr<Program> > programs_;
+    std::unordered_map<std::string, std::shared_ptr<Program>> programs_;
+
+    // Package environments are built on demand and dropped once a member
+    // changes, never modified: whoever holds one keeps seeing the package
+    // as it was. The members of every package are tracked so that one can
+    // be built without going through all programs.
+    Environment buildPackageEnv(const std::string& packageName) const
+    {
+        Environment packageEnv;
+        auto it = members_.find(packageName);
+        if (it == members_.end())
+            return packageEnv;
+
+        for (const auto& fileName : it->second) {
+            auto progIt = programs_.find(fileName);
+            if (progIt == programs_.end() || !progIt->second)
+                continue;
+            std::unique_ptr<Namespace> space(new Namespace);
+            space->setEnv(progIt->second->env());
+            packageEnv.injectNamespace(std::move(space), true);
+        }
+        return packageEnv;
+    }
+
+    std::unordered_map<std::string, std::set<std::string>> members_;
+    std::unordered_map<std::string, Environment> packages_;
+
+    // Method sets and interface conformance are memoized until a program
+    // is inserted or replaced, since the symbols may be gone by then.
+    void ensureFresh()
+    {
+        if (memoRevision_ == revision_)
+            return;
+        methodSets_.clear();
+        conformance_.clear();
+        resolutions_.clear();
+        memoRevision_ = revision_;
+    }
+
+    std::atomic<size_t> revision_ { nextRevision() };
+    size_t memoRevision_ { 0 };
+    std::unordered_map<MemoKey,
+                       std::shared_ptr<const std::vector<size_t>>,
+                       MemoKeyHash> methodSets_;
+    std::unordered_map<MemoKey, bool, MemoKeyHash> conformance_;
+    std::unordered_map<ResolutionKey,
+                       std::shared_ptr<const Type>,
+                       ResolutionKeyHash> resolutions_;
+
+    mutable std::mutex mutex_;
 };
 
 Snapshot::Snapshot()
@@ -43,15 +162,155 @@ Snapshot::Snapshot()
 {}
 
 void Snapshot::insertOrReplace(const std::string& fullFileName,
-                               std::unique_ptr<Program> program)
+                               std::shared_ptr<Program> program)
+{
+    // The replaced program is released outside the lock.
+    std::shared_ptr<Program> replaced;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        auto& entry = impl_->programs_[fullFileName];
+        replaced = std::move(entry);
+        entry = std::move(program);
+        impl_->revision_ = nextRevision();
+
+        if (entry) {
+            auto packageName = entry->packageName();
+            impl_->members_[packageName].insert(fullFileName);
+            impl_->packages_.erase(packageName);
+        }
+    }
+}
+
+void Snapshot::remove(const std::string& fullFileName)
+{
+    std::shared_ptr<Program> removed;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        auto it = impl_->programs_.find(fullFileName);
+        if (it == impl_->programs_.end())
+            return;
+        removed = std::move(it->second);
+        impl_->programs_.erase(it);
+        impl_->revision_ = nextRevision();
+
+        if (removed) {
+            auto packageName = removed->packageName();
+            impl_->members_[packageName].erase(fullFileName);
+            impl_->packages_.erase(packageName);
+        }
+    }
+}
+
+Environment Snapshot::packageEnv(const std::string& packageName) const
 {
-    impl_->programs_[fullFileName] = std::move(program);
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    auto it = impl_->packages_.find(packageName);
+    if (it != impl_->packages_.end())
+        return it->second;
+
+    Environment packageEnv = impl_->buildPackageEnv(packageName);
+    impl_->packages_.emplace(packageName, packageEnv);
+    return packageEnv;
 }
 
-Program* Snapshot::find(const std::string& fullFileName) const
+std::shared_ptr<Program> Snapshot::find(const std::string& fullFileName) const
 {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
     auto it = impl_->programs_.find(fullFileName);
     if (it != impl_->programs_.end())
-        return (it->second).get();
+        return it->second;
+    return nullptr;
+}
+
+std::vector<std::string> Snapshot::fileNames() const
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    std::vector<std::string> fileNames;
+    fileNames.reserve(impl_->programs_.size());
+    for (const auto& p : impl_->programs_)
+        fileNames.push_back(p.first);
+    return fileNames;
+}
+
+size_t Snapshot::revision() const
+{
+    return impl_->revision_;
+}
+
+std::shared_ptr<const std::vector<size_t>>
+Snapshot::methodSet(const TypeDecl* tyDecl, bool indirect) const
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->memoRevision_ != impl_->revision_)
+        return nullptr;
+
+    auto it = impl_->methodSets_.find(MemoKey { tyDecl, indirect, nullptr });
+    if (it != impl_->methodSets_.end())
+        return it->second;
+    return nullptr;
+}
+
+std::shared_ptr<const std::vector<size_t>>
+Snapshot::memoizeMethodSet(const TypeDecl* tyDecl, bool indirect,
+                           std::vector<size_t> fingerprints)
+{
+    auto methodSet = std::make_shared<const std::vector<size_t>>(std::move(fingerprints));
+    UAISO_ASSERT(tyDecl, return methodSet);
+
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->ensureFresh();
+    impl_->methodSets_[MemoKey { tyDecl, indirect, nullptr }] = methodSet;
+    return methodSet;
+}
+
+std::pair<bool, bool> Snapshot::conformance(const TypeDecl* tyDecl,
+                                            bool indirect,
+                                            const TypeDecl* ifaceDecl) const
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->memoRevision_ != impl_->revision_)
+        return std::make_pair(false, false);
+
+    auto it = impl_->conformance_.find(MemoKey { tyDecl, indirect, ifaceDecl });
+    if (it != impl_->conformance_.end())
+        return std::make_pair(true, it->second);
+    return std::make_pair(false, false);
+}
+
+void Snapshot::memoizeConformance(const TypeDecl* tyDecl, bool indirect,
+                                  const TypeDecl* ifaceDecl, bool conforms)
+{
+    UAISO_ASSERT(tyDecl && ifaceDecl, return);
+
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->ensureFresh();
+    impl_->conformance_[MemoKey { tyDecl, indirect, ifaceDecl }] = conforms;
+}
+
+std::shared_ptr<const Type> Snapshot::resolvedType(Environment scope,
+                                                   const Ident* name) const
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (impl_->memoRevision_ != impl_->revision_)
+        return nullptr;
+
+    auto it = impl_->resolutions_.find(ResolutionKey { scope, name });
+    if (it != impl_->resolutions_.end())
+        return it->second;
     return nullptr;
 }
+
+std::shared_ptr<const Type> Snapshot::memoizeResolvedType(Environment scope,
+                                                          const Ident* name,
+                                                          const Type* ty)
+{
+    UAISO_ASSERT(ty, return nullptr);
+    std::shared_ptr<const Type> canonical(ty->clone());
+
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->ensureFresh();
+    if (impl_->resolutions_.size() >= maxResolutions)
+        impl_->resolutions_.clear();
+    impl_->resolutions_[ResolutionKey { scope, name }] = canonical;
+    return canonical;
+}
@@ -26,16 +26,26 @@
 
 #include "Common/Config.h"
 #include "Common/Pimpl.h"
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace uaiso {
 
+class Environment;
+class Ident;
 class Program;
+class Type;
+class TypeDecl;
 
 /*!
  * \brief The Snapshot class
  *
  * \note This is an implictly shared type.
+ *
+ * \note Safe to use from multiple threads. A Program found in the snapshot
+ * is kept alive by whoever holds it, even after it's replaced or removed.
  */
 class UAISO_API Snapshot final
 {
@@ -43,9 +53,126 @@ public:
     Snapshot();
 
     void insertOrReplace(const std::string& fullFileName,
-                         std::unique_ptr<Program> program);
+                         std::shared_ptr<Program> program);
+
+    /*!
+     * \brief remove
+     * \param fullFileName
+     *
+     * Stop tracking the program of the given file, if any.
+     */
+    void remove(const std::string& fullFileName);
+
+    std::shared_ptr<Program> find(const std::string& fullFileName) const;
+
+    /*!
+     * \brief packageEnv
+     * \param packageName
+     * \return
+     *
+     * Return the environment of the package with the given name (see
+     * Program::packageName), into which the environments of every program
+     * of the package in the snapshot are merged. It's built when requested
+     * for the first time after such a program is inserted, replaced, or
+     * removed, and isn't modified afterwards.
+     */
+    Environment packageEnv(const std::string& packageName) const;
+
+    /*!
+     * \brief fileNames
+     * \return
+     *
+     * Return the names of the files whose programs are in the snapshot.
+     */
+    std::vector<std::string> fileNames() const;
+
+    /*!
+     * \brief revision
+     * \return
+     *
+     * Return a stamp that changes whenever a Program is inserted into (or
+     * replaced in) this snapshot. Stamps are never shared among snapshots,
+     * so a cache holding symbols from several programs keeps the stamp it
+     * was computed with to detect that it became stale.
+     */
+    size_t revision() const;
+
+    /*!
+     * \brief methodSet
+     * \param tyDecl
+     * \param indirect
+     * \return
+     *
+     * Return the memoized method set fingerprints of the type declared by
+     * \a tyDecl (or of a pointer to it, if \a indirect), or null if it's
+     * not known or stale.
+     */
+    std::shared_ptr<const std::vector<size_t>> methodSet(const TypeDecl* tyDecl,
+                                                         bool indirect) const;
+
+    /*!
+     * \brief memoizeMethodSet
+     * \param tyDecl
+     * \param indirect
+     * \param fingerprints - Sorted
+     * \return
+     *
+     * Memoize the method set and return it, as methodSet would.
+     */
+    std::shared_ptr<const std::vector<size_t>>
+    memoizeMethodSet(const TypeDecl* tyDecl, bool indirect,
+                     std::vector<size_t> fingerprints);
+
+    /*!
+     * \brief conformance
+     * \param tyDecl
+     * \param indirect
+     * \param ifaceDecl
+     * \return
+     *
+     * Return whether the conformance of the type declared by \a tyDecl
+     * (or of a pointer to it, if \a indirect) to the interface declared
+     * by \a ifaceDecl is memoized and, if so, whether it conforms.
+     */
+    std::pair<bool, bool> conformance(const TypeDecl* tyDecl, bool indirect,
+                                      const TypeDecl* ifaceDecl) const;
+
+    /*!
+     * \brief memoizeConformance
+     * \param tyDecl
+     * \param indirect
+     * \param ifaceDecl
+     * \param conforms
+     */
+    void memoizeConformance(const TypeDecl* tyDecl, bool indirect,
+                            const TypeDecl* ifaceDecl, bool conforms);
+
+    /*!
+     * \brief resolvedType
+     * \param scope
+     * \param name
+     * \return
+     *
+     * Return the memoized canonical type of an elaborate type named \a name
+     * and referenced from environment \a scope, or null if it's not known
+     * or stale. Every elaborate type with the same name and scope shares it.
+     */
+    std::shared_ptr<const Type> resolvedType(Environment scope,
+                                             const Ident* name) const;
 
-    Program* find(const std::string& fullFileName) const;
+    /*!
+     * \brief memoizeResolvedType
+     * \param scope
+     * \param name
+     * \param ty - The type of the declaration \a name resolves to.
+     * \return
+     *
+     * Memoize (a copy of) the canonical type and return it, as resolvedType
+     * would.
+     */
+    std::shared_ptr<const Type> memoizeResolvedType(Environment scope,
+                                                    const Ident* name,
+                                                    const Type* ty);
 
 private:
     DECL_SHARED_DATA(Snapshot)
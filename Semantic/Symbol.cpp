@@ -290,6 +290,8 @@ struct uaiso::Func::FuncImpl : ValueDecl::ValueDeclImpl
 
     Environment env_;
     std::vector<std::unique_ptr<Type>> paramsTy_;
+    std::unique_ptr<Type> recvTy_;
+    bool inferred_ { false };
     // The return type is stored in the base's value type.
 };
 
@@ -311,6 +313,25 @@ void Func::setType(std::unique_ptr<FuncType> ty)
         P_CAST->paramsTy_.push_back(std::unique_ptr<Type>(param->clone()));
 }
 
+std::vector<const Type*> Func::paramsType() const
+{
+    std::vector<const Type*> params;
+    params.reserve(P_CAST->paramsTy_.size());
+    for (const auto& param : P_CAST->paramsTy_)
+        params.push_back(param.get());
+    return params;
+}
+
+void Func::setRecvType(std::unique_ptr<Type> ty)
+{
+    P_CAST->recvTy_ = std::move(ty);
+}
+
+const Type* Func::recvType() const
+{
+    return P_CAST->recvTy_.get();
+}
+
 void Func::setEnv(Environment env)
 {
     P_CAST->env_ = env;
@@ -321,6 +342,16 @@ Environment Func::env() const
     return P_CAST->env_;
 }
 
+void Func::setIsInferred(bool isInferred)
+{
+    P_CAST->inferred_ = isInferred;
+}
+
+bool Func::isInferred() const
+{
+    return P_CAST->inferred_;
+}
+
 Func* Func::clone() const
 {
     return clone(P_CAST->name_);
@@ -333,6 +364,8 @@ Func* Func::clone(const Ident* altName) const
         func->P_CAST->valueTy_ = std::unique_ptr<Type>(P_CAST->valueTy_->clone());
     for (auto const& param : P_CAST->paramsTy_)
         func->P_CAST->paramsTy_.push_back(std::unique_ptr<Type>(param->clone()));
+    if (P_CAST->recvTy_)
+        func->P_CAST->recvTy_ = std::unique_ptr<Type>(P_CAST->recvTy_->clone());
     return func;
 }
 
@@ -369,9 +369,49 @@ public:
 
     void setType(std::unique_ptr<FuncType> ty);
 
+    /*!
+     * \brief paramsType
+     * \return
+     *
+     * Return the types of the function's parameters, in order. A parameter
+     * whose type isn't known is represented by an InferredType.
+     */
+    std::vector<const Type*> paramsType() const;
+
+    /*!
+     * \brief setRecvType
+     * \param ty
+     *
+     * Set the type of the function's receiver, making it a method in
+     * languages like Go.
+     */
+    void setRecvType(std::unique_ptr<Type> ty);
+
+    /*!
+     * \brief recvType
+     * \return
+     */
+    const Type* recvType() const;
+
     void setEnv(Environment env);
     Environment env() const;
 
+    /*!
+     * \brief setIsInferred
+     * \param isInferred
+     *
+     * Mark whether the types of the function's locals and its return type
+     * have been inferred (in languages that require so), which happens
+     * while its program is bound (see TypeChecker::infer).
+     */
+    void setIsInferred(bool isInferred);
+
+    /*!
+     * \brief isInferred
+     * \return
+     */
+    bool isInferred() const;
+
     Func* clone() const override;
     Func* clone(const Ident* altName) const override;
 
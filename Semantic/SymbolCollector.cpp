@@ -146,6 +146,26 @@ public:
         return Continue;
     }
 
+    //--- Expressions ---//
+
+    VisitResult traverseIdentExpr(IdentExprAst* ast)
+    {
+        if (ast->resolution() == NameResolution::Pending)
+            return Base::traverseIdentExpr(ast);
+        addUse(ast->decl(), ast->name());
+        return Continue;
+    }
+
+    //--- Specifiers ---//
+
+    VisitResult traverseNamedSpec(NamedSpecAst* ast)
+    {
+        if (ast->resolution() == NameResolution::Pending)
+            return Base::traverseNamedSpec(ast);
+        addUse(ast->decl(), ast->name());
+        return Continue;
+    }
+
     //--- Statements ---//
 
     VisitResult traverseBlockStmt(BlockStmtAst* ast)
@@ -168,19 +188,23 @@ public:
     VisitResult visitSimpleName(SimpleNameAst* ast)
     {
         const Decl* sym = searchValueDecl(ast, env_, lexs_);
-        if (!sym) {
+        if (!sym)
             sym = searchTypeDecl(ast, env_, lexs_);
-            if (!sym)
-                return Continue;
-        }
+        addUse(sym, ast);
+
+        return Continue;
+    }
+
+    void addUse(const Decl* sym, NameAst* ast)
+    {
+        if (!sym)
+            return;
 
         const SourceLoc& loc = fullLoc(ast, locator_);
         if (known_.count(loc.lineCol()) == 0) {
             refs_.push_back(std::make_tuple(SymbolCollector::Mention::Use,
                                             sym, loc));
         }
-
-        return Continue;
     }
 };
 
@@ -25,11 +25,18 @@
 #include "Semantic/Environment.h"
 #include "Semantic/Precision.h"
 #include "Semantic/Signedness.h"
+#include "Semantic/Snapshot.h"
 #include "Semantic/Symbol.h"
+#include "Semantic/SymbolCast.h"
 #include "Semantic/TypeCast.h"
 #include "Semantic/TypeQuals.h"
 #include "Common/Assert.h"
+#include "Parsing/Lang.h"
 #include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -211,7 +218,7 @@ struct uaiso::ElaborateType::ElaborateTypeImpl : Type::TypeImpl
     {}
 
     const Ident* name_;
-    std::unique_ptr<Type> canonical_;
+    std::shared_ptr<const Type> canonical_; // Possibly shared by a Snapshot
 };
 
 DEF_PIMPL_CAST(ElaborateType)
@@ -243,7 +250,7 @@ bool ElaborateType::isResolved() const
     return P_CAST->canonical_.get();
 }
 
-void ElaborateType::resolveType(std::unique_ptr<Type> ty)
+void ElaborateType::resolveType(std::shared_ptr<const Type> ty)
 {
     P_CAST->canonical_ = std::move(ty);
 }
@@ -285,12 +292,264 @@ Environment EnumType::env() const
 
     //--- RecordType ---//
 
+namespace {
+
+/*!
+ * \brief The MemberTable struct
+ *
+ * The linearized members of a record. A table is immutable once built,
+ * except for the resolutions of member types, which are made on demand.
+ */
+struct MemberTable
+{
+    //! A named member and the environment of the record declaring it.
+    struct Entry
+    {
+        const Decl* decl_;
+        Environment env_;
+    };
+
+    //! An elaborate member type resolved in the declaring environment.
+    struct Resolution
+    {
+        const Ident* elabName_ { nullptr };
+        const Type* ty_ { nullptr };
+    };
+
+    size_t revision_ { 0 };
+    Lang::MemberOrder order_ { Lang::DepthFirst };
+    std::vector<const Decl*> decls_;
+    std::unordered_map<const Ident*, Entry> index_;
+    std::unordered_set<const Ident*> ambiguous_;
+
+    mutable std::unordered_map<const Ident*, Resolution> resolutions_;
+    mutable std::mutex mutex_;
+};
+
+/*!
+ * \brief The MemberSlot struct
+ *
+ * Where the current table is published, shared among the record's clones.
+ */
+struct MemberSlot
+{
+    std::shared_ptr<const MemberTable> table_;
+};
+
+const RecordType* baseRecordType(const BaseRecord* base, Environment env)
+{
+    auto tySym = env.searchTypeDecl(base->name());
+    if (!tySym || !tySym->type() || tySym->type()->kind() != Type::Kind::Record)
+        return nullptr;
+    return ConstRecordType_Cast(tySym->type());
+}
+
+void linearizeDepthFirst(const RecordType* recTy,
+                         std::vector<const RecordType*>& recs)
+{
+    if (std::find(recs.begin(), recs.end(), recTy) != recs.end())
+        return;
+
+    recs.push_back(recTy);
+    for (auto base : recTy->bases()) {
+        if (auto baseTy = baseRecordType(base, recTy->env()))
+            linearizeDepthFirst(baseTy, recs);
+    }
+}
+
+/*!
+ * Breadth-first linearization, in which the records at the same depth are
+ * kept in a single level.
+ */
+void linearizeByDepth(const RecordType* recTy,
+                      std::vector<std::vector<const RecordType*>>& levels)
+{
+    std::unordered_set<const RecordType*> seen;
+    std::vector<const RecordType*> depth { recTy };
+    while (!depth.empty()) {
+        std::vector<const RecordType*> level;
+        std::vector<const RecordType*> nextDepth;
+        for (auto curTy : depth) {
+            if (!seen.insert(curTy).second)
+                continue;
+            level.push_back(curTy);
+            for (auto base : curTy->bases()) {
+                if (auto baseTy = baseRecordType(base, curTy->env()))
+                    nextDepth.push_back(baseTy);
+            }
+        }
+        if (!level.empty())
+            levels.push_back(std::move(level));
+        depth.swap(nextDepth);
+    }
+}
+
+/*!
+ * C3 linearization. Return false for cyclic or inconsistent hierarchies,
+ * in which case \a recs is left in an unspecified state.
+ */
+bool linearizeC3(const RecordType* recTy,
+                 std::vector<const RecordType*>& recs,
+                 std::vector<const RecordType*>& pending)
+{
+    if (std::find(pending.begin(), pending.end(), recTy) != pending.end())
+        return false;
+
+    pending.push_back(recTy);
+    std::vector<std::vector<const RecordType*>> seqs;
+    std::vector<const RecordType*> directBases;
+    for (auto base : recTy->bases()) {
+        auto baseTy = baseRecordType(base, recTy->env());
+        if (!baseTy)
+            continue;
+        std::vector<const RecordType*> baseRecs;
+        if (!linearizeC3(baseTy, baseRecs, pending))
+            return false;
+        seqs.push_back(std::move(baseRecs));
+        directBases.push_back(baseTy);
+    }
+    seqs.push_back(std::move(directBases));
+    pending.pop_back();
+
+    recs.push_back(recTy);
+    while (true) {
+        bool done = true;
+        const RecordType* head = nullptr;
+        for (const auto& seq : seqs) {
+            if (seq.empty())
+                continue;
+            done = false;
+            auto inTail = std::any_of(seqs.begin(), seqs.end(),
+                                      [&seq](const auto& other) {
+                return other.size() > 1
+                        && std::find(other.begin() + 1, other.end(),
+                                     seq.front()) != other.end();
+            });
+            if (!inTail) {
+                head = seq.front();
+                break;
+            }
+        }
+        if (done)
+            return true;
+        if (!head)
+            return false;
+
+        recs.push_back(head);
+        for (auto& seq : seqs) {
+            if (!seq.empty() && seq.front() == head)
+                seq.erase(seq.begin());
+        }
+    }
+}
+
+/*!
+ * Build the member table of \a recTy. Within a level, a name declared by
+ * more than one record is ambiguous: it's not a member, and it hides the
+ * same name of deeper levels.
+ */
+std::shared_ptr<const MemberTable> buildMembers(const RecordType* recTy,
+                                                const Lang* lang,
+                                                size_t revision)
+{
+    std::vector<std::vector<const RecordType*>> levels;
+    switch (lang->memberOrder()) {
+    case Lang::ResolutionOrder: {
+        std::vector<const RecordType*> recs;
+        std::vector<const RecordType*> pending;
+        if (!linearizeC3(recTy, recs, pending)) {
+            // Cyclic or inconsistent hierarchy, fall back to depth-first.
+            recs.clear();
+            linearizeDepthFirst(recTy, recs);
+        }
+        for (auto curTy : recs)
+            levels.push_back({ curTy });
+        break;
+    }
+    case Lang::Promotion:
+        linearizeByDepth(recTy, levels);
+        break;
+    default: {
+        std::vector<const RecordType*> recs;
+        linearizeDepthFirst(recTy, recs);
+        for (auto curTy : recs)
+            levels.push_back({ curTy });
+        break;
+    }
+    }
+
+    auto table = std::make_shared<MemberTable>();
+    table->revision_ = revision;
+    table->order_ = lang->memberOrder();
+    std::unordered_set<const Ident*> shadowed;
+    for (const auto& level : levels) {
+        std::unordered_map<const Ident*, const RecordType*> providers;
+        if (level.size() > 1) {
+            for (auto curTy : level) {
+                for (auto decl : curTy->env().listDecls()) {
+                    if (decl->isAnonymous() || shadowed.count(decl->name()))
+                        continue;
+                    auto provider = providers.emplace(decl->name(), curTy).first;
+                    if (provider->second != curTy)
+                        table->ambiguous_.insert(decl->name());
+                }
+            }
+        }
+
+        std::vector<const Ident*> names;
+        for (auto curTy : level) {
+            for (auto decl : curTy->env().listDecls()) {
+                if (!decl->isAnonymous()) {
+                    if (shadowed.count(decl->name())
+                            || table->ambiguous_.count(decl->name())) {
+                        continue;
+                    }
+                    names.push_back(decl->name());
+                    table->index_.emplace(decl->name(),
+                                          MemberTable::Entry { decl, curTy->env() });
+                }
+                table->decls_.push_back(decl);
+            }
+        }
+        shadowed.insert(names.begin(), names.end());
+        shadowed.insert(table->ambiguous_.begin(), table->ambiguous_.end());
+    }
+
+    return table;
+}
+
+/*!
+ * Return the member table of \a recTy, building it unless the published
+ * one is up-to-date with the snapshot and the language's member order.
+ */
+std::shared_ptr<const MemberTable> memberTable(const RecordType* recTy,
+                                               MemberSlot* slot,
+                                               const Lang* lang,
+                                               const Snapshot& snapshot)
+{
+    size_t revision = snapshot.revision();
+    auto table = std::atomic_load(&slot->table_);
+    if (table
+            && table->revision_ == revision
+            && table->order_ == lang->memberOrder()) {
+        return table;
+    }
+
+    // Concurrent builds are harmless, the last one to finish is kept.
+    table = buildMembers(recTy, lang, revision);
+    std::atomic_store(&slot->table_, table);
+    return table;
+}
+
+} // anonymous
+
 struct uaiso::RecordType::RecordTypeImpl : Type::TypeImpl
 {
     using TypeImpl::TypeImpl;
 
     Environment env_;
     std::vector<std::unique_ptr<BaseRecord>> bases_;
+    std::shared_ptr<MemberSlot> members_ { std::make_shared<MemberSlot>() };
 };
 
 DEF_PIMPL_CAST(RecordType)
@@ -301,6 +560,7 @@ RecordType* RecordType::clone() const
     ty->P_CAST->env_ = P_CAST->env_;
     for (auto& base : P_CAST->bases_)
         ty->P_CAST->bases_.emplace_back(new BaseRecord(base->name()));
+    ty->P_CAST->members_ = P_CAST->members_;
     return ty;
 }
 
@@ -346,6 +606,94 @@ Environment RecordType::env() const
     return P_CAST->env_;
 }
 
+std::shared_ptr<const std::vector<const Decl*>>
+RecordType::members(const Lang* lang, const Snapshot& snapshot) const
+{
+    auto table = memberTable(this, P_CAST->members_.get(), lang, snapshot);
+    return std::shared_ptr<const std::vector<const Decl*>>(table, &table->decls_);
+}
+
+const Decl* RecordType::searchMember(const Ident* name,
+                                     const Lang* lang,
+                                     const Snapshot& snapshot) const
+{
+    UAISO_ASSERT(name, return nullptr);
+
+    auto table = memberTable(this, P_CAST->members_.get(), lang, snapshot);
+    auto it = table->index_.find(name);
+    if (it == table->index_.end())
+        return nullptr;
+    return it->second.decl_;
+}
+
+bool RecordType::isAmbiguousMember(const Ident* name,
+                                   const Lang* lang,
+                                   const Snapshot& snapshot) const
+{
+    UAISO_ASSERT(name, return false);
+
+    auto table = memberTable(this, P_CAST->members_.get(), lang, snapshot);
+    return table->ambiguous_.count(name) != 0;
+}
+
+const Type* RecordType::memberType(const Ident* name,
+                                   const Lang* lang,
+                                   const Snapshot& snapshot) const
+{
+    UAISO_ASSERT(name, return nullptr);
+
+    auto table = memberTable(this, P_CAST->members_.get(), lang, snapshot);
+    auto it = table->index_.find(name);
+    if (it == table->index_.end())
+        return nullptr;
+
+    const Decl* decl = it->second.decl_;
+    const Type* ty = nullptr;
+    if (isValueDecl(decl))
+        ty = ConstValueDecl_Cast(decl)->valueType();
+    else if (isTypeDecl(decl))
+        ty = ConstTypeDecl_Cast(decl)->type();
+    if (!ty || ty->kind() != Type::Kind::Elaborate)
+        return ty;
+
+    auto elab = ConstElaborateType_Cast(ty);
+    if (elab->isResolved())
+        return elab->canonicalType();
+
+    // The declared type of a member may be replaced (by type inference, for
+    // instance), so a resolution is only valid for the same elaborate name.
+    const Ident* elabName = elab->name();
+    {
+        std::lock_guard<std::mutex> lock(table->mutex_);
+        auto resIt = table->resolutions_.find(name);
+        if (resIt != table->resolutions_.end()
+                && resIt->second.elabName_ == elabName) {
+            return resIt->second.ty_;
+        }
+    }
+
+    const Ident* prevName = nullptr;
+    while (ty && ty->kind() == Type::Kind::Elaborate) {
+        elab = ConstElaborateType_Cast(ty);
+        if (elab->isResolved()) {
+            ty = elab->canonicalType();
+            break;
+        }
+        if (elab->name() == prevName) {
+            ty = nullptr; // Cyclic
+            break;
+        }
+        prevName = elab->name();
+        auto tySym = it->second.env_.searchTypeDecl(elab->name());
+        ty = tySym ? tySym->type() : nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(table->mutex_);
+    table->resolutions_[name] = MemberTable::Resolution { elabName, ty };
+
+    return ty;
+}
+
     //--- OpaqueType ---//
 
 struct OpaqueType::OpaqueTypeImpl : Type::TypeImpl
@@ -469,7 +817,7 @@ struct uaiso::FuncType::FuncTypeImpl : Type::TypeImpl
     using TypeImpl::TypeImpl;
 
     std::unique_ptr<Type> returnType_;
-    std::unique_ptr<Type> paramType_; // TODO: Make paramsType_ vector.
+    std::vector<std::unique_ptr<Type>> paramsType_;
 };
 
 DEF_PIMPL_CAST(FuncType)
@@ -479,8 +827,8 @@ FuncType* FuncType::clone() const
     auto ty = trivialClone<FuncType>();
     if (P_CAST->returnType_)
         ty->P_CAST->returnType_.reset(P_CAST->returnType_->clone());
-    if (P_CAST->paramType_)
-        ty->P_CAST->paramType_.reset(P_CAST->paramType_->clone());
+    for (const auto& param : P_CAST->paramsType_)
+        ty->P_CAST->paramsType_.push_back(std::unique_ptr<Type>(param->clone()));
     return ty;
 }
 
@@ -492,11 +840,17 @@ FuncType::~FuncType()
 {}
 
 void FuncType::addParamType(std::unique_ptr<Type> type)
-{}
+{
+    P_CAST->paramsType_.push_back(std::move(type));
+}
 
 std::vector<const Type *> FuncType::paramsType() const
 {
-    return std::vector<const Type*>(); // TODO: Implement.
+    std::vector<const Type*> params;
+    params.reserve(P_CAST->paramsType_.size());
+    for (const auto& param : P_CAST->paramsType_)
+        params.push_back(param.get());
+    return params;
 }
 
 void FuncType::setReturnType(std::unique_ptr<Type> type)
@@ -29,13 +29,17 @@
 #include "Ast/AstVariety.h"
 #include "Semantic/TypeCast.h"
 #include "Semantic/TypeQuals.h"
+#include <memory>
 #include <vector>
 
 namespace uaiso {
 
 class BaseRecord;
+class Decl;
 class Environment;
 class Ident;
+class Lang;
+class Snapshot;
 enum class Precision : char;
 enum class Signedness : char;
 
@@ -197,7 +201,7 @@ private:
     friend class TypeChecker;
     friend class TypeResolver;
 
-    void resolveType(std::unique_ptr<Type> type);
+    void resolveType(std::shared_ptr<const Type> type);
 };
 
 /*!
@@ -316,6 +320,67 @@ public:
 
     std::vector<const BaseRecord*> bases() const;
 
+    /*!
+     * \brief members
+     * \param lang
+     * \param snapshot
+     * \return
+     *
+     * Return the record's member table: its own declarations followed by
+     * the ones inherited from (or promoted through) base records, in the
+     * language's \ref Lang::MemberOrder. A member shadowed by one that
+     * comes earlier is not listed, neither is an ambiguous one.
+     *
+     * \note The table is computed lazily and kept, along with its clones,
+     * until the revision of \a snapshot changes.
+     */
+    std::shared_ptr<const std::vector<const Decl*>>
+    members(const Lang* lang, const Snapshot& snapshot) const;
+
+    /*!
+     * \brief searchMember
+     * \param name
+     * \param lang
+     * \param snapshot
+     * \return
+     *
+     * Search the member table for a declaration with the given \a name.
+     */
+    const Decl* searchMember(const Ident* name, const Lang* lang,
+                             const Snapshot& snapshot) const;
+
+    /*!
+     * \brief isAmbiguousMember
+     * \param name
+     * \param lang
+     * \param snapshot
+     * \return
+     *
+     * Return whether \a name is declared by more than one record at the
+     * same depth (e.g., by two fields embedded in a Go struct), in which
+     * case it's not in the member table.
+     */
+    bool isAmbiguousMember(const Ident* name, const Lang* lang,
+                           const Snapshot& snapshot) const;
+
+    /*!
+     * \brief memberType
+     * \param name
+     * \param lang
+     * \param snapshot
+     * \return
+     *
+     * Return the type of the member with the given \a name: the value type
+     * of a value declaration or the type of a type declaration. Elaborate
+     * types are resolved in the environment of the record that declares
+     * the member. Return null if there's no such member or if its type is
+     * unknown.
+     *
+     * \note Resolutions are kept along with the member table.
+     */
+    const Type* memberType(const Ident* name, const Lang* lang,
+                           const Snapshot& snapshot) const;
+
     RecordType* clone() const override;
 
 private:
@@ -19,20 +19,32 @@
 
 #include "Semantic/TypeChecker.h"
 #include "Semantic/Program.h"
+#include "Semantic/Snapshot.h"
 #include "Semantic/Symbol.h"
+#include "Semantic/SymbolCast.h"
 #include "Semantic/Type.h"
+#include "Semantic/TypeCast.h"
+#include "Semantic/TypeResolver.h"
 #include "Semantic/TypeSystem.h"
 #include "Ast/Ast.h"
 #include "Ast/AstLocator.h"
+#include "Common/AllocStats.h"
 #include "Common/Assert.h"
+#include "Common/FileInfo.h"
+#include "Common/LatencyStats.h"
 #include "Parsing/Diagnostic.h"
 #include "Parsing/Factory.h"
 #include "Parsing/Lexeme.h"
+#include "Parsing/LexemeMap.h"
 #include "Parsing/Token.h"
 #include "Parsing/TokenMap.h"
 #include "Parsing/Lang.h"
 #include <iostream>
 #include <stack>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #define ENSURE_NONEMPTY_STACK \
     UAISO_ASSERT(!P->exprTy_.empty(), return Abort)
@@ -53,6 +65,163 @@
 
 using namespace uaiso;
 
+namespace {
+
+/*!
+ * \brief The FuncCollector class
+ *
+ * Collect the function declarations of a program, so the types of a
+ * function may be inferred on demand, when it's called before declared.
+ */
+class FuncCollector final : public AstVisitor<FuncCollector>
+{
+public:
+    using Base = AstVisitor<FuncCollector>;
+
+    VisitResult visitFuncDecl(FuncDeclAst* ast)
+    {
+        if (ast->sym_ && funcs_.emplace(ast->sym_, ast).second)
+            order_.push_back(ast);
+        return Continue;
+    }
+
+    VisitResult traverseExprStmt(ExprStmtAst*)
+    {
+        return Continue;
+    }
+
+    std::unordered_map<const Func*, FuncDeclAst*> funcs_;
+    std::vector<FuncDeclAst*> order_; // In source order.
+};
+
+/*!
+ * \brief The IdentExprs class
+ *
+ * Collect the identifier expressions of an expression.
+ */
+class IdentExprs final : public AstVisitor<IdentExprs>
+{
+public:
+    using Base = AstVisitor<IdentExprs>;
+
+    VisitResult visitIdentExpr(IdentExprAst* ast)
+    {
+        idents_.push_back(ast);
+        return Continue;
+    }
+
+    std::vector<IdentExprAst*> idents_;
+};
+
+/*!
+ * \brief The LocalAssignments class
+ *
+ * Collect the assignments and return stmts of a function's body, leaving
+ * out the ones of nested functions and records.
+ */
+class LocalAssignments final : public AstVisitor<LocalAssignments>
+{
+public:
+    using Base = AstVisitor<LocalAssignments>;
+
+    VisitResult traverseExprStmt(ExprStmtAst* ast)
+    {
+        if (ast->exprs()) {
+            for (auto expr : *ast->exprs()) {
+                if (expr->kind() == Ast::Kind::AssignExpr)
+                    assigns_.push_back(AssignExpr_Cast(expr));
+            }
+        }
+        return Continue;
+    }
+
+    VisitResult traverseReturnStmt(ReturnStmtAst* ast)
+    {
+        if (ast->exprs())
+            returns_.push_back(ast->exprs()->front());
+        return Continue;
+    }
+
+    VisitResult traverseFuncDecl(FuncDeclAst*)
+    {
+        return Continue;
+    }
+
+    VisitResult traverseRecordDecl(RecordDeclAst*)
+    {
+        return Continue;
+    }
+
+    std::vector<AssignExprAst*> assigns_;
+    std::vector<ExprAst*> returns_;
+};
+
+bool isSameType(const Type* ty1, const Type* ty2)
+{
+    if (ty1->kind() != ty2->kind())
+        return false;
+
+    switch (ty1->kind()) {
+    case Type::Kind::Record:
+        return ConstRecordType_Cast(ty1)->env() == ConstRecordType_Cast(ty2)->env();
+    case Type::Kind::Elaborate:
+        return ConstElaborateType_Cast(ty1)->name() == ConstElaborateType_Cast(ty2)->name();
+    default:
+        return true;
+    }
+}
+
+/*!
+ * Join \a ty into \a joined, the type of the values seen so far. Unknown
+ * types and nulls don't contribute, incompatible types join into an
+ * InferredType.
+ */
+void joinType(std::unique_ptr<Type>& joined, const Type* ty)
+{
+    if (ty->kind() == Type::Kind::Inferred
+            || ty->kind() == Type::Kind::Empty
+            || (ty->kind() == Type::Kind::Ptr
+                && ConstPtrType_Cast(ty)->baseType()->kind() == Type::Kind::Inferred)) {
+        return;
+    }
+
+    if (!joined) {
+        joined.reset(ty->clone());
+        return;
+    }
+
+    if (joined->kind() == Type::Kind::Inferred || isSameType(joined.get(), ty))
+        return;
+
+    if (joined->kind() == Type::Kind::Int && ty->kind() == Type::Kind::Float)
+        joined.reset(ty->clone());
+    else if (joined->kind() != Type::Kind::Float || ty->kind() != Type::Kind::Int)
+        joined.reset(new InferredType);
+}
+
+#define BIN_EXPR_KINDS(MACRO) \
+    MACRO(Add) MACRO(BitAnd) MACRO(BitOr) MACRO(BitXor) MACRO(Comma) \
+    MACRO(Concat) MACRO(Div) MACRO(Eq) MACRO(In) MACRO(Is) MACRO(LogicAnd) \
+    MACRO(LogicOr) MACRO(Mod) MACRO(Mul) MACRO(Power) MACRO(Rel) \
+    MACRO(Shift) MACRO(Sub)
+
+bool isBinExpr(const ExprAst* ast)
+{
+    if (!ast)
+        return false;
+
+    switch (ast->kind()) {
+#define MAKE_CASE(AST_NODE) case Ast::Kind::AST_NODE##Expr:
+    BIN_EXPR_KINDS(MAKE_CASE)
+#undef MAKE_CASE
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // anonymous
+
 struct uaiso::TypeChecker::TypeCheckerImpl
 {
     TypeCheckerImpl(Factory* factory)
@@ -63,6 +232,7 @@ struct uaiso::TypeChecker::TypeCheckerImpl
         , locator_(factory->makeAstLocator())
         , typeSystem_(factory->makeTypeSystem())
         , lang_(factory->makeLang())
+        , resolver_(factory)
         , reports_(nullptr)
     {}
 
@@ -100,10 +270,38 @@ struct uaiso::TypeChecker::TypeCheckerImpl
             reports_->add(std::forward<Args>(args)...);
     }
 
+    const Ident* identOf(const NameAst* name) const
+    {
+        if (!name || name->kind() != Ast::Kind::SimpleName)
+            return nullptr;
+        const SimpleNameAst* simple = ConstSimpleName_Cast(name);
+        return lexs_->findAt<Ident>(simple->nameLoc_.fileName_,
+                                    simple->nameLoc_.lineCol());
+    }
+
+    void keepInferredLocals(const Func* func)
+    {
+        for (auto valSym : func->env().listValueDecls()) {
+            if (valSym->kind() != Symbol::Kind::Func
+                    && valSym->valueType()
+                    && valSym->valueType()->kind() != Type::Kind::Inferred) {
+                inferredLocals_.insert(valSym);
+            }
+        }
+    }
+
+    Token tokenAt(Token tk, const SourceLoc& loc) const
+    {
+        // Parsers record the token in the AST, the map is only a fallback.
+        if (tk != TK_INVALID || !tokens_)
+            return tk;
+        return tokens_->findAt(loc.fileName_, loc.lineCol());
+    }
+
      //!< Lexeme map of all AST locations.
     const LexemeMap* lexs_;
 
-    //!< Token map of all AST locations.
+    //!< Token map of all AST locations (optional).
     const TokenMap* tokens_;
 
     //! Environment we're currently in.
@@ -136,8 +334,22 @@ struct uaiso::TypeChecker::TypeCheckerImpl
     //! Language-specific lang.
     std::unique_ptr<const Lang> lang_;
 
+    //! Resolver of the (elaborate) types of member access bases.
+    TypeResolver resolver_;
+
+    //! Snapshot in which type resolutions are memoized.
+    Snapshot snapshot_;
+
     //! Diagnostic reports collected.
-    DiagnosticReports* reports_;
+    DiagnosticSink* reports_;
+
+    //! Functions of the program, whose types are inferred on demand
+    //! (only while inferring).
+    std::unordered_map<const Func*, FuncDeclAst*> funcs_;
+
+    //! Locals typed by (flow-insensitive) inference, which assignments
+    //! must not override.
+    std::unordered_set<const ValueDecl*> inferredLocals_;
 };
 
 TypeChecker::TypeChecker(Factory* factory)
@@ -157,16 +369,28 @@ void TypeChecker::setTokens(const TokenMap* tokens)
     P->tokens_ = tokens;
 }
 
-void TypeChecker::collectDiagnostics(DiagnosticReports* reports)
+void TypeChecker::collectDiagnostics(DiagnosticSink* reports)
 {
     P->reports_ = reports;
 }
 
+void TypeChecker::setSnapshot(Snapshot snapshot)
+{
+    P->snapshot_ = snapshot;
+    P->resolver_.setSnapshot(snapshot);
+}
+
 void TypeChecker::check(ProgramAst *progAst)
 {
     UAISO_ASSERT(progAst, return);
     UAISO_ASSERT(progAst->program_, return);
 
+    AllocStats::Phase phase("check", AllocStats::isAttached()
+                                ? progAst->program_->fileInfo().fullFileName()
+                                : std::string());
+    static const LatencyStats::Key checkKey("check");
+    LatencyStats::Timer timer(checkKey);
+
     P->env_ = progAst->program_->env();
 
     traverseProgram(progAst, this, P->lang_);
@@ -177,11 +401,163 @@ void TypeChecker::check(FuncDeclAst* ast)
     UAISO_ASSERT(ast, return);
     UAISO_ASSERT(ast->sym_, return);
 
+    if (P->lang_->requiresReturnTypeInference())
+        P->keepInferredLocals(ast->sym_);
+
     P->env_ = ast->sym_->env();
 
     traverseStmt(ast->stmt());
 }
 
+void TypeChecker::infer(ProgramAst* progAst)
+{
+    UAISO_ASSERT(progAst, return);
+    UAISO_ASSERT(progAst->program_, return);
+
+    if (!P->lang_->requiresReturnTypeInference())
+        return;
+
+    static const LatencyStats::Key inferKey("infer");
+    LatencyStats::Timer timer(inferKey);
+
+    P->env_ = progAst->program_->env();
+
+    FuncCollector collector;
+    traverseProgram(progAst, &collector, P->lang_);
+    P->funcs_ = std::move(collector.funcs_);
+    for (auto func : collector.order_)
+        inferFuncTypes(func);
+    P->funcs_.clear();
+}
+
+void TypeChecker::inferFuncTypes(FuncDeclAst* ast)
+{
+    Func* func = ast->sym_;
+    UAISO_ASSERT(func, return);
+
+    // Marking the function upfront stops recursion.
+    if (func->isInferred() || !ast->stmt())
+        return;
+    func->setIsInferred(true);
+
+    LocalAssignments collector;
+    collector.traverseStmt(ast->stmt());
+
+    // Every assignment to a name binds a new symbol in a dynamic type
+    // system, all of them get the joined type of the assigned values.
+    std::unordered_map<const Ident*, std::vector<const ValueDecl*>> locals;
+    for (auto valSym : func->env().listValueDecls()) {
+        if (valSym->kind() == Symbol::Kind::Var
+                || valSym->kind() == Symbol::Kind::Param) {
+            locals[valSym->name()].push_back(valSym);
+        }
+    }
+
+    // The values assigned to locals, along with the locals they use.
+    struct Value
+    {
+        const Ident* local_;
+        ExprAst* expr_;
+        std::vector<const Ident*> uses_;
+        std::unique_ptr<Type> ty_;
+    };
+    std::vector<Value> values;
+    for (auto assign : collector.assigns_) {
+        if (!assign->exprs1() || !assign->exprs2())
+            continue;
+
+        auto exprs2 = assign->exprs2();
+        for (auto expr1 : *assign->exprs1()) {
+            if (!exprs2)
+                break;
+            ExprAst* expr2 = exprs2->front();
+            exprs2 = exprs2->subList();
+            if (expr1->kind() != Ast::Kind::IdentExpr)
+                continue;
+            auto name = P->identOf(IdentExpr_Cast(expr1)->name());
+            if (!name || !locals.count(name))
+                continue;
+
+            Value value { name, expr2, {}, nullptr };
+            IdentExprs idents;
+            idents.traverseExpr(expr2);
+            for (auto ident : idents.idents_) {
+                auto use = P->identOf(ident->name());
+                if (use && locals.count(use))
+                    value.uses_.push_back(use);
+            }
+            values.push_back(std::move(value));
+        }
+    }
+
+    Environment env = P->env_;
+    P->env_ = func->env();
+
+    // Every value is typed once, and again only when a local it uses gets
+    // another type. Joined types only widen, so this settles.
+    std::unordered_set<const Ident*> changed;
+    for (size_t round = 0; round <= 2 * locals.size(); ++round) {
+        for (auto& value : values) {
+            if (round && std::none_of(value.uses_.begin(), value.uses_.end(),
+                                      [&changed](const Ident* use) {
+                                          return changed.count(use) != 0;
+                                      })) {
+                continue;
+            }
+            value.ty_.reset();
+            if (traverseExpr(value.expr_) == Abort || P->exprTy_.empty())
+                continue;
+            value.ty_ = P->popExprType();
+        }
+
+        std::unordered_map<const Ident*, std::unique_ptr<Type>> joined;
+        for (const auto& value : values) {
+            if (value.ty_)
+                joinType(joined[value.local_], value.ty_.get());
+        }
+
+        changed.clear();
+        for (const auto& join : joined) {
+            if (!join.second)
+                continue;
+            for (auto valSym : locals[join.first]) {
+                if (valSym->valueType() && isSameType(valSym->valueType(), join.second.get()))
+                    continue;
+                ValueDecl_ConstCast(valSym)->setValueType(
+                    std::unique_ptr<Type>(join.second->clone()));
+                changed.insert(join.first);
+            }
+        }
+        if (changed.empty())
+            break;
+    }
+
+    if (!func->valueType() || func->valueType()->kind() == Type::Kind::Inferred) {
+        std::unique_ptr<Type> retTy;
+        for (auto expr : collector.returns_) {
+            if (traverseExpr(expr) == Abort || P->exprTy_.empty())
+                continue;
+            std::unique_ptr<Type> ty = P->popExprType();
+            joinType(retTy, ty.get());
+        }
+        if (retTy)
+            func->setValueType(std::move(retTy));
+    }
+
+    P->env_ = env;
+}
+
+void TypeChecker::ensureInferred(const ValueDecl* valSym)
+{
+    if (!valSym || valSym->kind() != Symbol::Kind::Func)
+        return;
+
+    // Only while inferring, the functions of the program are known.
+    auto it = P->funcs_.find(ConstFunc_Cast(valSym));
+    if (it != P->funcs_.end())
+        inferFuncTypes(it->second);
+}
+
 bool TypeChecker::escapeCheck(const Type* ty) const
 {
     // Inferred types currently act as a joker.
@@ -196,6 +572,16 @@ const Type* TypeChecker::maybeResolve(const Type* ty, const SourceLoc& loc)
     if (ty->kind() != Type::Kind::Elaborate)
         return ty;
 
+    // Elaborate types of the same name, referenced from the same scope,
+    // share a single resolution.
+    ElaborateType* elabTy = ElaborateType_ConstCast(ConstElaborateType_Cast(ty));
+    if (!elabTy->isResolved()) {
+        if (auto canonical = P->snapshot_.resolvedType(P->env_, elabTy->name())) {
+            elabTy->resolveType(canonical);
+            return canonical.get();
+        }
+    }
+
     ElaborateType* prevTy = nullptr;
     const Ident* prevName = nullptr;
     while (ty->kind() == Type::Kind::Elaborate) {
@@ -223,9 +609,12 @@ const Type* TypeChecker::maybeResolve(const Type* ty, const SourceLoc& loc)
     }
 
     // Annotate the actual type for further reference.
-    prevTy->resolveType(std::unique_ptr<Type>(ty->clone()));
+    auto canonical = P->snapshot_.memoizeResolvedType(P->env_, elabTy->name(), ty);
+    elabTy->resolveType(canonical);
+    if (prevTy != elabTy)
+        prevTy->resolveType(canonical);
 
-    return ty;
+    return canonical.get();
 }
 
 bool TypeChecker::analyseInit(const Type *lhsTy,
@@ -375,6 +764,9 @@ TypeChecker::VisitResult TypeChecker::traverseFuncDecl(FuncDeclAst* ast)
 {
     ENSURE_ANNOTATED_SYMBOL;
 
+    if (P->lang_->requiresReturnTypeInference())
+        P->keepInferredLocals(ast->sym_);
+
     if (P->lang_->hasFuncLevelScope()) {
         P->env_ = ast->sym_->env();
         VIS_CALL(Base::traverseFuncDecl(ast));
@@ -383,10 +775,6 @@ TypeChecker::VisitResult TypeChecker::traverseFuncDecl(FuncDeclAst* ast)
         VIS_CALL(Base::traverseFuncDecl(ast));
     }
 
-    if (P->lang_->requiresReturnTypeInference()) {
-        // TODO
-    }
-
     return Continue;
 }
 
@@ -502,7 +890,7 @@ TypeChecker::VisitResult TypeChecker::traverseUnitTestDecl(UnitTestDeclAst* ast)
 
 TypeChecker::VisitResult TypeChecker::visitNumLitExpr(NumLitExprAst* ast)
 {
-    Token tk = P->tokens_->findAt(ast->litLoc_.fileName_, ast->litLoc_.lineCol());
+    Token tk = P->tokenAt(ast->litTk(), ast->litLoc());
 
     switch (tk) {
     case TK_INT_LIT:
@@ -521,7 +909,7 @@ TypeChecker::VisitResult TypeChecker::visitNumLitExpr(NumLitExprAst* ast)
 
 TypeChecker::VisitResult TypeChecker::visitBoolLitExpr(BoolLitExprAst* ast)
 {
-    Token tk = P->tokens_->findAt(ast->litLoc_.fileName_, ast->litLoc_.lineCol());
+    Token tk = P->tokenAt(ast->litTk(), ast->litLoc());
 
     switch (tk) {
     case TK_TRUE_VALUE:
@@ -537,7 +925,7 @@ TypeChecker::VisitResult TypeChecker::visitBoolLitExpr(BoolLitExprAst* ast)
 
 TypeChecker::VisitResult TypeChecker::visitCharLitExpr(CharLitExprAst* ast)
 {
-    Token tk = P->tokens_->findAt(ast->litLoc_.fileName_, ast->litLoc_.lineCol());
+    Token tk = P->tokenAt(ast->litTk(), ast->litLoc());
 
     switch (tk) {
     case TK_CHAR_LIT:
@@ -552,7 +940,7 @@ TypeChecker::VisitResult TypeChecker::visitCharLitExpr(CharLitExprAst* ast)
 
 TypeChecker::VisitResult TypeChecker::visitStrLitExpr(StrLitExprAst* ast)
 {
-    Token tk = P->tokens_->findAt(ast->litLoc_.fileName_, ast->litLoc_.lineCol());
+    Token tk = P->tokenAt(ast->litTk(), ast->litLoc());
 
     switch (tk) {
     case TK_STR_LIT:
@@ -567,7 +955,7 @@ TypeChecker::VisitResult TypeChecker::visitStrLitExpr(StrLitExprAst* ast)
 
 TypeChecker::VisitResult TypeChecker::visitNullLitExpr(NullLitExprAst* ast)
 {
-    Token tk = P->tokens_->findAt(ast->litLoc_.fileName_, ast->litLoc_.lineCol());
+    Token tk = P->tokenAt(ast->litTk(), ast->litLoc());
 
     switch (tk) {
     case TK_NULL_VALUE:
@@ -611,63 +999,132 @@ TypeChecker::VisitResult TypeChecker::processArithmetic(ExprAst* expr1,
     return Continue;
 }
 
+TypeChecker::VisitResult TypeChecker::processBinExpr(BinExprAst* ast)
+{
+    switch (ast->kind()) {
+    case Ast::Kind::AddExpr:
+    case Ast::Kind::SubExpr:
+    case Ast::Kind::MulExpr:
+    case Ast::Kind::DivExpr:
+    case Ast::Kind::ModExpr:
+    case Ast::Kind::PowerExpr:
+        return processArithmetic(ast->expr1(), ast->expr2());
+    case Ast::Kind::BitAndExpr:
+    case Ast::Kind::BitOrExpr:
+    case Ast::Kind::BitXorExpr:
+    case Ast::Kind::ShiftExpr:
+        return processBitwise(ast->expr1(), ast->expr2());
+    case Ast::Kind::LogicAndExpr:
+    case Ast::Kind::LogicOrExpr:
+        return processLogical(ast->expr1(), ast->expr2());
+    case Ast::Kind::ConcatExpr:
+        return processConcat(ast->expr1(), ast->expr2());
+    case Ast::Kind::RelExpr:
+        return processRelational(ast->expr1(), ast->expr2());
+    case Ast::Kind::EqExpr:
+        return processEq(EqExpr_Cast(ast));
+    case Ast::Kind::InExpr:
+    case Ast::Kind::IsExpr:
+        return processPredicate();
+    case Ast::Kind::CommaExpr:
+        return processComma();
+    default:
+        UAISO_ASSERT(false, return Abort);
+        return Abort;
+    }
+}
+
+TypeChecker::VisitResult TypeChecker::traverseBinChain(BinExprAst* ast)
+{
+    // Binary expressions nest on their left operand, and a long chain of
+    // them would exhaust the call stack if checked recursively. Descend
+    // through the chain first, keeping each expression along with the
+    // result of its left operand (or its own visit, when that didn't
+    // continue), which decides whether the right operand is traversed.
+    std::vector<std::pair<BinExprAst*, VisitResult>> pending;
+    ExprAst* expr = ast;
+    while (true) {
+        BinExprAst* binExpr = static_cast<BinExprAst*>(expr);
+        VisitResult result = visitExprOnly(binExpr);
+        if (result == Abort)
+            return Abort;
+        pending.emplace_back(binExpr, result);
+        if (result != Continue)
+            break;
+
+        expr = binExpr->expr1();
+        if (!isBinExpr(expr)) {
+            pending.back().second = traverseExpr(expr);
+            if (pending.back().second == Abort)
+                return Abort;
+            break;
+        }
+    }
+
+    // The types of both operands are on the stack once the right one is
+    // traversed, and are then combined into the type of the expression.
+    while (!pending.empty()) {
+        BinExprAst* binExpr = pending.back().first;
+        if (pending.back().second == Continue
+                && traverseExpr(binExpr->expr2()) == Abort) {
+            return Abort;
+        }
+        pending.pop_back();
+        if (processBinExpr(binExpr) == Abort)
+            return Abort;
+    }
+
+    return Continue;
+}
+
 TypeChecker::VisitResult TypeChecker::traverseAddExpr(AddExprAst* ast)
 {
-    VIS_CALL(Base::traverseAddExpr(ast));
-
-    return processArithmetic(ast->expr1(), ast->expr2());
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traverseSubExpr(SubExprAst* ast)
 {
-    VIS_CALL(Base::traverseSubExpr(ast));
-
-    return processArithmetic(ast->expr1(), ast->expr2());
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traverseDivExpr(DivExprAst* ast)
 {
-    VIS_CALL(Base::traverseDivExpr(ast));
-
-    return processArithmetic(ast->expr1(), ast->expr2());
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traverseModExpr(ModExprAst* ast)
 {
-    VIS_CALL(Base::traverseModExpr(ast));
-
-    return processArithmetic(ast->expr1(), ast->expr2());
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traverseMulExpr(MulExprAst* ast)
 {
-    VIS_CALL(Base::traverseMulExpr(ast));
-
-    return processArithmetic(ast->expr1(), ast->expr2());
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traversePowerExpr(PowerExprAst* ast)
 {
-    VIS_CALL(Base::traversePowerExpr(ast));
-
-    return processArithmetic(ast->expr1(), ast->expr2());
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traverseConcatExpr(ConcatExprAst* ast)
 {
-    VIS_CALL(Base::traverseConcatExpr(ast));
+    return traverseBinChain(ast);
+}
 
+TypeChecker::VisitResult TypeChecker::processConcat(ExprAst* expr1, ExprAst* expr2)
+{
     ENSURE_NONEMPTY_STACK;
     std::unique_ptr<Type> ty = P->popExprType();
     if (ty->kind() != Type::Kind::Str) {
-        P->report(Diagnostic::StringValueExpected, ast->expr1(), P->locator_);
+        P->report(Diagnostic::StringValueExpected, expr1, P->locator_);
         ty.reset(nullptr);
     }
 
     ENSURE_NONEMPTY_STACK;
     std::unique_ptr<Type> ty2 = P->popExprType();
     if (ty2->kind() != Type::Kind::Str) {
-        P->report(Diagnostic::StringValueExpected, ast->expr2(), P->locator_);
+        P->report(Diagnostic::StringValueExpected, expr2, P->locator_);
     } else if (!ty) {
         ty = std::move(ty2);
     }
@@ -845,7 +1302,7 @@ TypeChecker::VisitResult TypeChecker::traverseAssignExpr(AssignExprAst* ast)
         // In dynamic type systems, a new type is deliberately set to the
         // symbol. In static type systems, there's an assignment check.
         if (P->typeSystem_->isDynamic()) {
-            if (P->prevSym_)
+            if (P->prevSym_ && !P->inferredLocals_.count(P->prevSym_))
                 ValueDecl_ConstCast(P->prevSym_)->setValueType(std::move(exprTy[idx]));
         } else {
             analyseAssign(ty.get(), exprTy[idx].get(), fullLoc(ast, P->locator_));
@@ -860,8 +1317,11 @@ TypeChecker::VisitResult TypeChecker::traverseAssignExpr(AssignExprAst* ast)
 
 TypeChecker::VisitResult TypeChecker::traverseEqExpr(EqExprAst* ast)
 {
-    VIS_CALL(Base::traverseEqExpr(ast));
+    return traverseBinChain(ast);
+}
 
+TypeChecker::VisitResult TypeChecker::processEq(EqExprAst* ast)
+{
     ENSURE_NONEMPTY_STACK;
     std::unique_ptr<Type> ty1 = P->popExprType();
     ENSURE_NONEMPTY_STACK;
@@ -876,24 +1336,16 @@ TypeChecker::VisitResult TypeChecker::traverseEqExpr(EqExprAst* ast)
 
 TypeChecker::VisitResult TypeChecker::traverseInExpr(InExprAst* ast)
 {
-    VIS_CALL(Base::traverseInExpr(ast));
-
-    ENSURE_NONEMPTY_STACK;
-    std::unique_ptr<Type> ty1 = P->popExprType();
-    ENSURE_NONEMPTY_STACK;
-    std::unique_ptr<Type> ty2 = P->popExprType();
-
-    // TODO: Check types
-
-    P->exprTy_.emplace(new BoolType);
-
-    return Continue;
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traverseIsExpr(IsExprAst* ast)
 {
-    VIS_CALL(Base::traverseIsExpr(ast));
+    return traverseBinChain(ast);
+}
 
+TypeChecker::VisitResult TypeChecker::processPredicate()
+{
     ENSURE_NONEMPTY_STACK;
     std::unique_ptr<Type> ty1 = P->popExprType();
     ENSURE_NONEMPTY_STACK;
@@ -908,8 +1360,11 @@ TypeChecker::VisitResult TypeChecker::traverseIsExpr(IsExprAst* ast)
 
 TypeChecker::VisitResult TypeChecker::traverseCommaExpr(CommaExprAst* ast)
 {
-    VIS_CALL(Base::traverseCommaExpr(ast));
+    return traverseBinChain(ast);
+}
 
+TypeChecker::VisitResult TypeChecker::processComma()
+{
     ENSURE_NONEMPTY_STACK;
     std::unique_ptr<Type> ty1 = P->popExprType();
     ENSURE_NONEMPTY_STACK;
@@ -957,16 +1412,12 @@ TypeChecker::VisitResult TypeChecker::processLogical(ExprAst* expr1, ExprAst* ex
 
 TypeChecker::VisitResult TypeChecker::traverseLogicAndExpr(LogicAndExprAst* ast)
 {
-    VIS_CALL(Base::traverseLogicAndExpr(ast));
-
-    return processLogical(ast->expr1(), ast->expr2());
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traverseLogicOrExpr(LogicOrExprAst* ast)
 {
-    VIS_CALL(Base::traverseLogicOrExpr(ast));
-
-    return processLogical(ast->expr1(), ast->expr2());
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traverseLogicNotExpr(LogicNotExprAst* ast)
@@ -987,17 +1438,20 @@ TypeChecker::VisitResult TypeChecker::traverseLogicNotExpr(LogicNotExprAst* ast)
 
 TypeChecker::VisitResult TypeChecker::traverseRelExpr(RelExprAst* ast)
 {
-    VIS_CALL(Base::traverseRelExpr(ast));
+    return traverseBinChain(ast);
+}
 
+TypeChecker::VisitResult TypeChecker::processRelational(ExprAst* expr1, ExprAst* expr2)
+{
     ENSURE_NONEMPTY_STACK;
     std::unique_ptr<Type> ty1 = P->popExprType();
     if (!isNumType(ty1->kind()))
-        P->report(Diagnostic::NumericValueExpected, ast->expr1(), P->locator_);
+        P->report(Diagnostic::NumericValueExpected, expr1, P->locator_);
 
     ENSURE_NONEMPTY_STACK;
     std::unique_ptr<Type> ty2 = P->popExprType();
     if (!isNumType(ty2->kind()))
-        P->report(Diagnostic::NumericValueExpected, ast->expr2(), P->locator_);
+        P->report(Diagnostic::NumericValueExpected, expr2, P->locator_);
 
     P->exprTy_.emplace(new BoolType);
 
@@ -1047,30 +1501,22 @@ TypeChecker::VisitResult TypeChecker::processBitwise(ExprAst* expr1, ExprAst* ex
 
 TypeChecker::VisitResult TypeChecker::traverseBitAndExpr(BitAndExprAst* ast)
 {
-    VIS_CALL(Base::traverseBitAndExpr(ast));
-
-    return processBitwise(ast->expr1(), ast->expr2());
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traverseBitOrExpr(BitOrExprAst* ast)
 {
-    VIS_CALL(Base::traverseBitOrExpr(ast));
-
-    return processBitwise(ast->expr1(), ast->expr2());
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traverseBitXorExpr(BitXorExprAst* ast)
 {
-    VIS_CALL(Base::traverseBitXorExpr(ast));
-
-    return processBitwise(ast->expr1(), ast->expr2());
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traverseShiftExpr(ShiftExprAst* ast)
 {
-    VIS_CALL(Base::traverseShiftExpr(ast));
-
-    return processBitwise(ast->expr1(), ast->expr2());
+    return traverseBinChain(ast);
 }
 
 TypeChecker::VisitResult TypeChecker::traverseBitCompExpr(BitCompExprAst* ast)
@@ -1176,8 +1622,12 @@ TypeChecker::VisitResult TypeChecker::traverseCallExpr(CallExprAst* ast)
 TypeChecker::VisitResult TypeChecker::traverseRecordInitExpr(RecordInitExprAst* ast)
 {
     if (ast->spec_ && ast->spec_->kind() == Ast::Kind::NamedSpec) {
-        auto tySym = searchTypeDecl(NamedSpec_Cast(ast->spec())->name(),
-                                    P->env_, P->lexs_);
+        NamedSpecAst* spec = NamedSpec_Cast(ast->spec());
+        const TypeDecl* tySym = nullptr;
+        if (spec->resolution() == NameResolution::Pending)
+            tySym = searchTypeDecl(spec->name(), P->env_, P->lexs_);
+        else if (spec->resolution() == NameResolution::AsType)
+            tySym = ConstTypeDecl_Cast(spec->decl());
         if (tySym) {
             P->exprTy_.emplace(tySym->type()->clone());
             return Continue;
@@ -1225,9 +1675,107 @@ TypeChecker::VisitResult TypeChecker::traverseMixinExpr(MixinExprAst* ast)
 
 TypeChecker::VisitResult TypeChecker::traverseMemberAccessExpr(MemberAccessExprAst* ast)
 {
-    // TODO
+    // A symbol request refers to the member, not to the base expr.
+    bool keepSym = P->keepSym_;
+    P->keepSym_ = false;
 
-    P->exprTy_.emplace(new InferredType);
+    const Ident* name = P->identOf(ast->name());
+
+    Ast* base = ast->exprOrSpec();
+    if (!base || !name) {
+        P->exprTy_.emplace(new InferredType);
+        return Continue;
+    }
+
+    // The base might be a namespace, as in an import. An identifier that
+    // cannot be found isn't diagnosed, its import may be unresolved.
+    if (base->kind() == Ast::Kind::IdentExpr) {
+        IdentExprAst* ident = IdentExpr_Cast(base);
+        const Ident* spaceName = P->identOf(ident->name());
+        const Namespace* spaceSym = nullptr;
+        bool isSpace = false;
+        switch (ident->resolution()) {
+        case NameResolution::AsNamespace:
+        case NameResolution::Unresolved:
+            if (spaceName)
+                spaceSym = P->env_.fetchNamespace(spaceName);
+            isSpace = true;
+            break;
+        case NameResolution::Pending:
+            // Not annotated, only the name of a namespace is searched for a
+            // declaration that would hide it.
+            if (spaceName)
+                spaceSym = P->env_.fetchNamespace(spaceName);
+            isSpace = spaceSym
+                    && !searchValueDecl(ident->name(), P->env_, P->lexs_)
+                    && !searchTypeDecl(ident->name(), P->env_, P->lexs_);
+            break;
+        default:
+            break;
+        }
+
+        if (isSpace) {
+            const Type* ty = nullptr;
+            if (spaceSym) {
+                if (auto valSym = spaceSym->env().searchValueDecl(name)) {
+                    ensureInferred(valSym);
+                    ty = valSym->valueType();
+                    if (keepSym)
+                        P->prevSym_ = valSym;
+                } else if (auto tySym = spaceSym->env().searchTypeDecl(name)) {
+                    ty = tySym->type();
+                }
+            }
+            P->pushExprType<InferredType>(
+                std::unique_ptr<Type>(ty ? ty->clone() : nullptr));
+            return Continue;
+        }
+    }
+
+    std::unique_ptr<Type> baseTy;
+    if (base->isSpec()) {
+        if (base->kind() == Ast::Kind::NamedSpec) {
+            auto tySym = searchTypeDecl(NamedSpec_Cast(base)->name(), P->env_, P->lexs_);
+            if (tySym && tySym->type())
+                baseTy.reset(tySym->type()->clone());
+        }
+    } else {
+        VIS_CALL(traverseExpr(Expr_Cast(base)));
+        ENSURE_NONEMPTY_STACK;
+        baseTy = P->popExprType();
+    }
+
+    // Look through elaborate types and pointers, which are implicitly
+    // dereferenced on member access.
+    const Type* ty = baseTy.get();
+    while (ty) {
+        if (ty->kind() == Type::Kind::Elaborate)
+            ty = std::get<0>(P->resolver_.resolve(ElaborateType_ConstCast(ty), P->env_));
+        else if (ty->kind() == Type::Kind::Ptr)
+            ty = ConstPtrType_Cast(ty)->baseType();
+        else
+            break;
+    }
+
+    const Type* memberTy = nullptr;
+    if (ty && ty->kind() == Type::Kind::Record) {
+        auto recTy = ConstRecordType_Cast(ty);
+        auto decl = recTy->searchMember(name, P->lang_.get(), P->snapshot_);
+        if (decl && isValueDecl(decl)) {
+            ensureInferred(ConstValueDecl_Cast(decl));
+            if (keepSym)
+                P->prevSym_ = ConstValueDecl_Cast(decl);
+        } else if (!decl
+                   && recTy->isAmbiguousMember(name, P->lang_.get(), P->snapshot_)) {
+            P->report(Diagnostic::AmbiguousSelector, ast->name(), P->locator_);
+        }
+        memberTy = recTy->memberType(name, P->lang_.get(), P->snapshot_);
+    } else if (ty && ty->kind() == Type::Kind::Enum) {
+        memberTy = ty;
+    }
+
+    P->pushExprType<InferredType>(
+        std::unique_ptr<Type>(memberTy ? memberTy->clone() : nullptr));
 
     return Continue;
 }
@@ -1275,9 +1823,29 @@ TypeChecker::VisitResult TypeChecker::visitThisExpr(ThisExprAst* ast)
 
 TypeChecker::VisitResult TypeChecker::visitIdentExpr(IdentExprAst* ast)
 {
-    auto valSym = searchValueDecl(ast->name(), P->env_, P->lexs_);
+    // Names annotated by the NameResolver needn't be searched again.
+    const ValueDecl* valSym = nullptr;
+    const TypeDecl* tySym = nullptr;
+    switch (ast->resolution()) {
+    case NameResolution::Pending:
+        valSym = searchValueDecl(ast->name(), P->env_, P->lexs_);
+        if (!valSym)
+            tySym = searchTypeDecl(ast->name(), P->env_, P->lexs_);
+        break;
+    case NameResolution::AsValue:
+        valSym = ConstValueDecl_Cast(ast->decl());
+        break;
+    case NameResolution::AsType:
+        tySym = ConstTypeDecl_Cast(ast->decl());
+        break;
+    default:
+        break;
+    }
+
+    // The types of a function may have yet to be inferred.
+    ensureInferred(valSym);
+
     if (!valSym) {
-        auto tySym = searchTypeDecl(ast->name(), P->env_, P->lexs_);
         if (!tySym) {
             P->report(Diagnostic::UndeclaredIdentifier, ast->name(), P->locator_);
             P->exprTy_.emplace(new InferredType);
@@ -26,12 +26,14 @@
 #include "Common/Pimpl.h"
 #include "Common/Test.h"
 #include "Parsing/Diagnostic.h"
+#include "Semantic/SymbolFwd.h"
 #include "Semantic/TypeFwd.h"
 
 namespace uaiso {
 
 class Factory;
 class LexemeMap;
+class Snapshot;
 class TokenMap;
 
 /*!
@@ -47,7 +49,16 @@ public:
 
     void setTokens(const TokenMap* tokens);
 
-    void collectDiagnostics(DiagnosticReports* reports);
+    void collectDiagnostics(DiagnosticSink* reports);
+
+    /*!
+     * \brief setSnapshot
+     * \param snapshot
+     *
+     * Set the snapshot in which resolutions of elaborate types are memoized.
+     * By default, they are memoized only for as long as the checker lives.
+     */
+    void setSnapshot(Snapshot snapshot);
 
     /*!
      * \brief analyse
@@ -65,6 +76,17 @@ public:
      */
     void check(FuncDeclAst* ast);
 
+    /*!
+     * \brief infer
+     * \param ast
+     *
+     * Infer the types of the locals and the return type of every function
+     * of a module, in languages that require so. The inferred types are set
+     * to the module's symbols, so this is meant for a module that isn't
+     * shared yet, right after it's bound (see Manager).
+     */
+    void infer(ProgramAst* ast);
+
 private:
     DECL_PIMPL(TypeChecker)
     DECL_CLASS_TEST(TypeChecker)
@@ -74,6 +96,9 @@ private:
 
     const Type* maybeResolve(const Type* ty, const SourceLoc& loc);
 
+    void inferFuncTypes(FuncDeclAst* ast);
+    void ensureInferred(const ValueDecl* valSym);
+
     bool escapeCheck(const Type* ty) const;
 
     bool analyseInit(const Type* lhsTy, const Type* rhsTy, const SourceLoc& loc);
@@ -83,6 +108,14 @@ private:
     VisitResult processLogical(ExprAst* expr1, ExprAst* expr2);
     VisitResult processBitwise(ExprAst* expr1, ExprAst* expr2);
     VisitResult processArithmetic(ExprAst* expr1, ExprAst* expr2);
+    VisitResult processConcat(ExprAst* expr1, ExprAst* expr2);
+    VisitResult processRelational(ExprAst* expr1, ExprAst* expr2);
+    VisitResult processEq(EqExprAst* ast);
+    VisitResult processPredicate();
+    VisitResult processComma();
+    VisitResult processBinExpr(BinExprAst* ast);
+
+    VisitResult traverseBinChain(BinExprAst* ast);
 
     template <class AstT>
     VisitResult takeAnnotatedType(AstT* ast);
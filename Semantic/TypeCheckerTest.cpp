@@ -59,12 +59,13 @@ TypeChecker::TypeCheckerTest::runCore(std::unique_ptr<Factory> factory,
 
     std::unique_ptr<Unit> unit = manager.process(code, fullFileName);
     UAISO_EXPECT_TRUE(unit->ast());
-    Program* prog = snapshot.find(fullFileName);
+    auto prog = snapshot.find(fullFileName);
     UAISO_EXPECT_TRUE(prog);
 
     TypeChecker typeChecker(factory.get());
     typeChecker.setLexemes(&lexs);
     typeChecker.setTokens(&tokens);
+    typeChecker.setSnapshot(snapshot);
     typeChecker.collectDiagnostics(&reports);
     typeChecker.check(Program_Cast(unit->ast()));
 
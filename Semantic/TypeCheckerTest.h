@@ -45,6 +45,19 @@ public:
              , &TypeCheckerTest::GoTestCase6
              , &TypeCheckerTest::GoTestCase7
              , &TypeCheckerTest::GoTestCase8
+             , &TypeCheckerTest::GoTestCase9
+             , &TypeCheckerTest::GoTestCase10
+             , &TypeCheckerTest::GoTestCase11
+             // Python
+             , &TypeCheckerTest::PyTestCase1
+             , &TypeCheckerTest::PyTestCase2
+             , &TypeCheckerTest::PyTestCase3
+             , &TypeCheckerTest::PyTestCase4
+             , &TypeCheckerTest::PyTestCase5
+             , &TypeCheckerTest::PyTestCase6
+             , &TypeCheckerTest::PyTestCase7
+             , &TypeCheckerTest::PyTestCase8
+             , &TypeCheckerTest::PyTestCase9
              )
 
     //--- Go ---//
@@ -57,6 +70,21 @@ public:
     void GoTestCase6();
     void GoTestCase7();
     void GoTestCase8();
+    void GoTestCase9();
+    void GoTestCase10();
+    void GoTestCase11();
+
+    //--- Python ---//
+
+    void PyTestCase1();
+    void PyTestCase2();
+    void PyTestCase3();
+    void PyTestCase4();
+    void PyTestCase5();
+    void PyTestCase6();
+    void PyTestCase7();
+    void PyTestCase8();
+    void PyTestCase9();
 
 
     std::unique_ptr<Unit> runCore(std::unique_ptr<Factory> factory,
@@ -22,6 +22,7 @@
 /*--------------------------*/
 
 #include "Semantic/TypeResolver.h"
+#include "Semantic/Snapshot.h"
 #include "Semantic/Symbol.h"
 #include "Semantic/Type.h"
 #include "Semantic/TypeCast.h"
@@ -35,6 +36,8 @@ struct uaiso::TypeResolver::TypeResolverImpl
 {
     TypeResolverImpl(Factory*)
     {}
+
+    Snapshot snapshot_;
 };
 
 TypeResolver::TypeResolver(Factory* factory)
@@ -44,6 +47,11 @@ TypeResolver::TypeResolver(Factory* factory)
 TypeResolver::~TypeResolver()
 {}
 
+void TypeResolver::setSnapshot(Snapshot snapshot)
+{
+    P->snapshot_ = snapshot;
+}
+
 TypeResolver::Result TypeResolver::resolve(ElaborateType* elabTy,
                                            Environment env) const
 {
@@ -52,15 +60,21 @@ TypeResolver::Result TypeResolver::resolve(ElaborateType* elabTy,
     if (elabTy->isResolved())
         return Result(elabTy->canonicalType(), Success);
 
-    auto tySym = env.searchTypeDecl(elabTy->name());
-    if (!tySym) {
-        DEBUG_TRACE("type decl symbol lookup failed");
-        return Result(nullptr, TypeDeclLookupFailed);
-    }
+    // Elaborate types of the same name, referenced from the same scope,
+    // share a single resolution.
+    auto canonical = P->snapshot_.resolvedType(env, elabTy->name());
+    if (!canonical) {
+        auto tySym = env.searchTypeDecl(elabTy->name());
+        if (!tySym) {
+            DEBUG_TRACE("type decl symbol lookup failed");
+            return Result(nullptr, TypeDeclLookupFailed);
+        }
 
-    UAISO_ASSERT(tySym->type(), return Result(nullptr, InternalError));
-    auto ty = tySym->type();
-    elabTy->resolveType(std::unique_ptr<Type>(ty->clone()));
+        UAISO_ASSERT(tySym->type(), return Result(nullptr, InternalError));
+        canonical = P->snapshot_.memoizeResolvedType(env, elabTy->name(),
+                                                     tySym->type());
+    }
+    elabTy->resolveType(canonical);
 
-    return Result(ty, Success);
+    return Result(canonical.get(), Success);
 }
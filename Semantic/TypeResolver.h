@@ -33,6 +33,7 @@
 namespace uaiso {
 
 class Factory;
+class Snapshot;
 
 class UAISO_API TypeResolver final
 {
@@ -49,6 +50,15 @@ public:
 
     using Result = std::tuple<const Type*, ResultCode>;
 
+    /*!
+     * \brief setSnapshot
+     * \param snapshot
+     *
+     * Set the snapshot in which resolutions are memoized. By default, they
+     * are memoized only for as long as the resolver lives.
+     */
+    void setSnapshot(Snapshot snapshot);
+
     Result resolve(ElaborateType* elabTy, Environment env) const;
 
 private:
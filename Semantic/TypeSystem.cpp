@@ -22,6 +22,8 @@
 /*--------------------------*/
 
 #include "Semantic/TypeSystem.h"
+#include "Semantic/Environment.h"
+#include "Semantic/Snapshot.h"
 #include "Semantic/Type.h"
 
 using namespace uaiso;
@@ -40,3 +42,8 @@ bool TypeSystem::isStringFirstClass() const { return false; }
 bool TypeSystem::isBoolConvertible(const Type *ty) const { return false; }
 
 bool TypeSystem::isIntConvertible(const Type* ty) const { return false; }
+
+bool TypeSystem::implements(const Type*, const Type*, Environment, Snapshot) const
+{
+    return false;
+}
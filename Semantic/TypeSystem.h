@@ -29,6 +29,9 @@
 
 namespace uaiso {
 
+class Environment;
+class Snapshot;
+
 class UAISO_API TypeSystem
 {
 public:
@@ -83,6 +86,21 @@ public:
      * Not required to check int itself.
      */
     virtual bool isIntConvertible(const Type* ty) const;
+
+    /*!
+     * \brief implements
+     * \param ty
+     * \param iface
+     * \param env - Environment in which the types are resolved
+     * \param snapshot - Where results are memoized
+     * \return
+     *
+     * Return whether type \a ty satisfies interface \a iface without an
+     * explicit declaration of it. Only meaningful in structural type
+     * systems, the default implementation returns false.
+     */
+    virtual bool implements(const Type* ty, const Type* iface,
+                            Environment env, Snapshot snapshot) const;
 };
 
 } // namespace uaiso
@@ -0,0 +1,322 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#include "Semantic/Watcher.h"
+#include "Semantic/Manager.h"
+#include "Semantic/Snapshot.h"
+#include "Common/Assert.h"
+#include "Common/FileInfo.h"
+#include "Common/Trace__.h"
+#include "Tinydir/Tinydir.h"
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#define TRACE_NAME "Watcher"
+
+using namespace uaiso;
+
+struct uaiso::Watcher::WatcherImpl
+{
+    WatcherImpl(Manager* manager, Snapshot snapshot)
+        : manager_(manager)
+        , snapshot_(snapshot)
+    {}
+
+    Manager* manager_;
+    Snapshot snapshot_;
+    int quietPeriod_ { 50 };
+    int maxBatchPeriod_ { 1000 };
+    size_t lastBatchSize_ { 0 };
+    double lastRefreshMsecs_ { 0 };
+
+#ifdef __linux__
+    // How deep below a search path directories are watched, which also
+    // stops a symbolic link loop.
+    static const int kMaxDepth = 16;
+
+    struct Dir
+    {
+        std::string path_;
+        int depth_; // Below a search path, or -1 if not watched as a tree.
+    };
+
+    int fd_ { -1 };
+    std::unordered_map<int, Dir> dirs_; // By watch descriptor.
+    std::unordered_set<std::string> watched_;
+
+    void watch(std::string dir, int depth)
+    {
+        if (dir.empty())
+            return;
+        if (dir.back() != FileInfo::dirSeparator())
+            dir.push_back(FileInfo::dirSeparator());
+        if (!watched_.insert(dir).second)
+            return;
+
+        const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE
+                | IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF;
+        int wd = inotify_add_watch(fd_, dir.c_str(), mask);
+        if (wd == -1) {
+            DEBUG_TRACE("cannot watch %s\n", dir.c_str());
+            watched_.erase(dir);
+            return;
+        }
+        dirs_[wd] = Dir { dir, depth };
+
+        if (depth == -1 || depth == kMaxDepth)
+            return;
+
+        // Packages are subdirectories of a search path, they're watched too.
+        tinydir_dir tdir;
+        if (tinydir_open(&tdir, dir.c_str()) == -1)
+            return;
+        std::vector<std::string> subDirs;
+        while (tdir.has_next) {
+            tinydir_file file;
+            tinydir_readfile(&tdir, &file);
+            if (file.is_dir && file.name[0] != '.')
+                subDirs.push_back(dir + file.name);
+            tinydir_next(&tdir);
+        }
+        tinydir_close(&tdir);
+        for (const auto& subDir : subDirs)
+            watch(subDir, depth + 1);
+    }
+
+    void syncWatches()
+    {
+        for (const auto& path : manager_->searchPaths())
+            watch(path, 0);
+        for (const auto& fileName : snapshot_.fileNames())
+            watch(FileInfo(fileName).fullDir(), -1);
+    }
+
+    /*!
+     * \brief drain
+     *
+     * Read the pending events into \a changed. Return false if events
+     * were lost, in which case every tracked file must be considered.
+     */
+    bool drain(std::unordered_set<std::string>& changed)
+    {
+        alignas(struct inotify_event) char buf[16 * 1024];
+        bool complete = true;
+        while (true) {
+            ssize_t len = read(fd_, buf, sizeof(buf));
+            if (len <= 0)
+                break;
+
+            for (char* ptr = buf; ptr < buf + len; ) {
+                auto event = reinterpret_cast<const struct inotify_event*>(ptr);
+                ptr += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    complete = false;
+                    continue;
+                }
+                auto it = dirs_.find(event->wd);
+                if (it == dirs_.end())
+                    continue;
+
+                if (event->mask & (IN_IGNORED | IN_DELETE_SELF)) {
+                    watched_.erase(it->second.path_);
+                    dirs_.erase(it);
+                    continue;
+                }
+                if (!event->len)
+                    continue;
+
+                if (event->mask & IN_ISDIR) {
+                    // A new package below a search path.
+                    if ((event->mask & (IN_CREATE | IN_MOVED_TO))
+                            && it->second.depth_ != -1
+                            && it->second.depth_ < kMaxDepth) {
+                        watch(it->second.path_ + event->name,
+                              it->second.depth_ + 1);
+                    }
+                    continue;
+                }
+                if (event->mask & IN_CREATE)
+                    continue; // Reported once written.
+
+                changed.insert(it->second.path_ + event->name);
+            }
+        }
+        return complete;
+    }
+
+    bool wait(int timeoutMsecs)
+    {
+        struct pollfd pfd;
+        pfd.fd = fd_;
+        pfd.events = POLLIN;
+        return ::poll(&pfd, 1, timeoutMsecs) > 0 && (pfd.revents & POLLIN);
+    }
+#endif
+};
+
+Watcher::Watcher(Manager* manager, Snapshot snapshot)
+    : P(new WatcherImpl(manager, snapshot))
+{
+    UAISO_ASSERT(manager, return);
+}
+
+Watcher::~Watcher()
+{
+    stop();
+}
+
+bool Watcher::isSupported()
+{
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Watcher::start()
+{
+#ifdef __linux__
+    if (P->fd_ != -1)
+        return true;
+
+    P->fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (P->fd_ == -1)
+        return false;
+
+    P->syncWatches();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Watcher::stop()
+{
+#ifdef __linux__
+    if (P->fd_ == -1)
+        return;
+
+    close(P->fd_);
+    P->fd_ = -1;
+    P->dirs_.clear();
+    P->watched_.clear();
+#endif
+}
+
+bool Watcher::isActive() const
+{
+#ifdef __linux__
+    return P->fd_ != -1;
+#else
+    return false;
+#endif
+}
+
+void Watcher::setQuietPeriod(int msecs)
+{
+    P->quietPeriod_ = msecs;
+}
+
+int Watcher::quietPeriod() const
+{
+    return P->quietPeriod_;
+}
+
+void Watcher::setMaxBatchPeriod(int msecs)
+{
+    P->maxBatchPeriod_ = msecs;
+}
+
+int Watcher::maxBatchPeriod() const
+{
+    return P->maxBatchPeriod_;
+}
+
+std::vector<std::string> Watcher::poll(int timeoutMsecs)
+{
+#ifdef __linux__
+    if (P->fd_ == -1 || !P->wait(timeoutMsecs))
+        return std::vector<std::string>();
+
+    // Keep the batch open while events arrive within the quiet period, but
+    // not for longer than the maximum batch period.
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::milliseconds(P->maxBatchPeriod_);
+    std::unordered_set<std::string> changed;
+    bool complete = P->drain(changed);
+    while (true) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - Clock::now()).count();
+        if (left <= 0
+                || !P->wait(std::min<int>(P->quietPeriod_, static_cast<int>(left)))) {
+            break;
+        }
+        complete &= P->drain(changed);
+    }
+
+    std::vector<std::string> fileNames;
+    if (complete) {
+        fileNames.assign(changed.begin(), changed.end());
+    } else {
+        DEBUG_TRACE("events lost, refresh every tracked file\n");
+        fileNames = P->snapshot_.fileNames();
+    }
+
+    auto start = Clock::now();
+    std::vector<std::string> stale = P->manager_->refresh(fileNames);
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+    P->lastBatchSize_ = fileNames.size();
+    P->lastRefreshMsecs_ = elapsed.count();
+    DEBUG_TRACE("batch of %zu files refreshed in %.1f ms\n",
+                P->lastBatchSize_, P->lastRefreshMsecs_);
+
+    // Refreshing may have brought in new dependencies.
+    P->syncWatches();
+
+    return stale;
+#else
+    (void)timeoutMsecs;
+    return std::vector<std::string>();
+#endif
+}
+
+size_t Watcher::lastBatchSize() const
+{
+    return P->lastBatchSize_;
+}
+
+double Watcher::lastRefreshMsecs() const
+{
+    return P->lastRefreshMsecs_;
+}
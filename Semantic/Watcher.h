@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright (c) 2014-2016 Leandro T. C. Melo (ltcmelo@gmail.com)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ *****************************************************************************/
+
+/*--------------------------*/
+/*--- The UaiSo! Project ---*/
+/*--------------------------*/
+
+#ifndef UAISO_WATCHER_H__
+#define UAISO_WATCHER_H__
+
+#include "Common/Config.h"
+#include "Common/Pimpl.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace uaiso {
+
+class Manager;
+class Snapshot;
+
+/*!
+ * \brief The Watcher class
+ *
+ * Watch, through inotify, the search paths of a Manager (along with their
+ * subdirectories) and the directories of the programs tracked in a Snapshot,
+ * and have the Manager refresh the files that are changed, created, or
+ * deleted on disk (after a checkout or a code generation step, for instance).
+ *
+ * Events are coalesced into batches: a batch is closed once no event arrives
+ * for a quiet period, so that a storm of changes is refreshed at once, or
+ * once the maximum batch period is over, so that a steady stream of events
+ * doesn't hold it forever. The watcher doesn't spawn threads, it's polled by
+ * the integration.
+ *
+ * \note Only available on Linux. Elsewhere, start() fails and poll() never
+ * reports anything.
+ */
+class UAISO_API Watcher final
+{
+public:
+    Watcher(Manager* manager, Snapshot snapshot);
+    ~Watcher();
+
+    static bool isSupported();
+
+    /*!
+     * \brief start
+     * \return
+     *
+     * Start watching the relevant directories.
+     */
+    bool start();
+
+    /*!
+     * \brief stop
+     */
+    void stop();
+
+    bool isActive() const;
+
+    /*!
+     * \brief setQuietPeriod
+     * \param msecs
+     *
+     * Set for how long, without further events, a batch is held open.
+     */
+    void setQuietPeriod(int msecs);
+
+    int quietPeriod() const;
+
+    /*!
+     * \brief setMaxBatchPeriod
+     * \param msecs
+     *
+     * Set for how long, at most, a batch is held open.
+     */
+    void setMaxBatchPeriod(int msecs);
+
+    int maxBatchPeriod() const;
+
+    /*!
+     * \brief poll
+     * \param timeoutMsecs - How long to wait for the first event.
+     * \return
+     *
+     * Wait for a batch of changes and refresh the affected files in the
+     * Manager. Return the names of programs that must be processed again
+     * by the caller.
+     *
+     * \sa Manager::refresh
+     */
+    std::vector<std::string> poll(int timeoutMsecs);
+
+    /*!
+     * \brief lastBatchSize
+     * \return
+     *
+     * Return how many distinct files the last batch consisted of.
+     */
+    size_t lastBatchSize() const;
+
+    /*!
+     * \brief lastRefreshMsecs
+     * \return
+     *
+     * Return how long it took to refresh the last batch.
+     */
+    double lastRefreshMsecs() const;
+
+private:
+    DECL_PIMPL(Watcher)
+};
+
+} // namespace uaiso
+
+#endif